@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "maze_graph.h"
+
+struct MazeWalls {
+    int rows = 0;
+    int cols = 0;
+    std::vector<std::uint64_t> east;
+    std::vector<std::uint64_t> south;
+
+    [[nodiscard]] bool eastClosed(const int row, const int col) const {
+        return testBit(east, row * cols + col);
+    }
+    [[nodiscard]] bool southClosed(const int row, const int col) const {
+        return testBit(south, row * cols + col);
+    }
+
+private:
+    static bool testBit(const std::vector<std::uint64_t>& bits, const int index) {
+        return (bits[static_cast<std::size_t>(index) >> 6] >> (index & 63)) & 1u;
+    }
+};
+
+
+MazeWalls make_maze_walls(const MazeGraph& g);
@@ -0,0 +1,30 @@
+#include "Crc32.h"
+
+#include <array>
+
+namespace {
+const std::array<std::uint32_t, 256>& crcTable() {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t n = 0; n < 256; ++n) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1u) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+}
+
+std::uint32_t crc32Update(std::uint32_t crc, const void* data, const std::size_t size) {
+    const auto& table = crcTable();
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ bytes[i]) & 0xffu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
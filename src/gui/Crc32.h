@@ -0,0 +1,6 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+[[nodiscard]] std::uint32_t crc32Update(std::uint32_t crc, const void* data, std::size_t size);
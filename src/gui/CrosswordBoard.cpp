@@ -0,0 +1,109 @@
+#include "CrosswordBoard.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+// Bits first .. first + length - 1.
+std::uint64_t spanMask(const int first, const int length) {
+    const std::uint64_t bits = length >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << length) - 1;
+    return bits << first;
+}
+
+std::uint64_t bitAt(const int index, const int size) {
+    return index >= 0 && index < size ? std::uint64_t{1} << index : 0;
+}
+
+bool isLetter(const char ch) {
+    return ch >= 'A' && ch <= 'Z';
+}
+}
+
+CrosswordBoard::CrosswordBoard(const int rows, const int cols)
+    : rows_(std::clamp(rows, 0, kMaxSide)),
+      cols_(std::clamp(cols, 0, kMaxSide)),
+      letters_(static_cast<std::size_t>(rows_ * cols_), '\0'),
+      rowBits_(static_cast<std::size_t>(rows_), 0),
+      colBits_(static_cast<std::size_t>(cols_), 0) {}
+
+char CrosswordBoard::at(const int row, const int col) const {
+    if (row < 0 || col < 0 || row >= rows_ || col >= cols_) {
+        return '\0';
+    }
+    return letters_[static_cast<std::size_t>(row * cols_ + col)];
+}
+
+int CrosswordBoard::crossings(const std::string_view word, const bool across, const int row, const int col) const {
+    const int length = static_cast<int>(word.size());
+    // Across words are checked against the row bitboards and down words against the column
+    // ones: lane is the row (column) the word lies in and start its first column (row).
+    const int lane = across ? row : col;
+    const int start = across ? col : row;
+    const int lanes = across ? rows_ : cols_;
+    const int extent = across ? cols_ : rows_;
+    if (length == 0 || lane < 0 || lane >= lanes || start < 0 || start + length > extent) {
+        return -1;
+    }
+    const auto& lines = across ? rowBits_ : colBits_;
+    const std::uint64_t line = lines[lane];
+    const std::uint64_t span = spanMask(start, length);
+    if (line & (bitAt(start - 1, extent) | bitAt(start + length, extent))) {
+        return -1;
+    }
+    // Two neighbouring shared cells are part of a word running the same way, which this one
+    // would swallow or extend rather than cross.
+    const std::uint64_t shared = line & span;
+    if (shared == span || (shared & (shared << 1)) != 0) {
+        return -1;
+    }
+    const std::uint64_t sides = (lane > 0 ? lines[lane - 1] : 0) | (lane + 1 < lanes ? lines[lane + 1] : 0);
+    if (sides & span & ~shared) {
+        return -1;
+    }
+    for (std::uint64_t rest = shared; rest != 0; rest &= rest - 1) {
+        const int index = std::countr_zero(rest);
+        const char existing = across ? letters_[static_cast<std::size_t>(lane * cols_ + index)]
+                                     : letters_[static_cast<std::size_t>(index * cols_ + lane)];
+        if (existing != word[index - start]) {
+            return -1;
+        }
+    }
+    return std::all_of(word.begin(), word.end(), isLetter) ? std::popcount(shared) : -1;
+}
+
+int CrosswordBoard::place(const std::string_view word, const bool across, const int row, const int col) {
+    const int crossed = crossings(word, across, row, col);
+    if (crossed < 0) {
+        return -1;
+    }
+    for (int i = 0; i < static_cast<int>(word.size()); ++i) {
+        const int r = row + (across ? 0 : i);
+        const int c = col + (across ? i : 0);
+        char& cell = letters_[static_cast<std::size_t>(r * cols_ + c)];
+        if (cell != '\0') {
+            continue;
+        }
+        cell = word[i];
+        rowBits_[r] |= std::uint64_t{1} << c;
+        colBits_[c] |= std::uint64_t{1} << r;
+        positions_[cell - 'A'].push_back(Position{static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(c)});
+    }
+    ++placedWords_;
+    return crossed;
+}
+
+const std::vector<CrosswordBoard::Position>& CrosswordBoard::positions(const char letter) const {
+    static const std::vector<Position> none;
+    return isLetter(letter) ? positions_[letter - 'A'] : none;
+}
+
+std::vector<std::string> CrosswordBoard::grid() const {
+    std::vector<std::string> lines(static_cast<std::size_t>(rows_), std::string(static_cast<std::size_t>(cols_), '.'));
+    for (int r = 0; r < rows_; ++r) {
+        for (std::uint64_t rest = rowBits_[r]; rest != 0; rest &= rest - 1) {
+            const int c = std::countr_zero(rest);
+            lines[r][c] = letters_[static_cast<std::size_t>(r * cols_ + c)];
+        }
+    }
+    return lines;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The letters placed so far while laying out a crossword of at most kMaxSide x kMaxSide cells.
+// Each row and each column keeps a bitboard of its occupied cells, so checking a placement is a
+// few mask operations plus one letter comparison per crossing. Each letter keeps the cells that
+// hold it, so crossing candidates for a word come from those lists, not from a scan of the grid.
+class CrosswordBoard {
+public:
+    static constexpr int kMaxSide = 64;
+
+    struct Position {
+        std::uint8_t row = 0;
+        std::uint8_t col = 0;
+    };
+
+    CrosswordBoard(int rows, int cols);
+
+    [[nodiscard]] int rows() const { return rows_; }
+    [[nodiscard]] int cols() const { return cols_; }
+    // The letter at (row, col), or '\0' when the cell is empty or outside the board.
+    [[nodiscard]] char at(int row, int col) const;
+    [[nodiscard]] int wordCount() const { return placedWords_; }
+
+    // Whether word (A-Z) fits at (row, col): inside the board, no letter directly before or after
+    // it, every occupied cell it covers holds the same letter, and no new letter touches a
+    // parallel word from the side. It may not run along an existing word, and covering only
+    // occupied cells adds nothing, so both are refused.
+    [[nodiscard]] bool canPlace(std::string_view word, bool across, int row, int col) const {
+        return crossings(word, across, row, col) >= 0;
+    }
+    // The number of existing letters word would cross at (row, col), or -1 when it does not fit.
+    [[nodiscard]] int crossings(std::string_view word, bool across, int row, int col) const;
+    // Places word if canPlace allows it; returns crossings() for the placement.
+    int place(std::string_view word, bool across, int row, int col);
+
+    // The cells holding letter, in the order they were filled.
+    [[nodiscard]] const std::vector<Position>& positions(char letter) const;
+    // One string per row, '.' for empty cells.
+    [[nodiscard]] std::vector<std::string> grid() const;
+
+private:
+    int rows_ = 0;
+    int cols_ = 0;
+    int placedWords_ = 0;
+    std::string letters_;
+    // Bit c of rowBits_[r] and bit r of colBits_[c] are set when (r, c) holds a letter.
+    std::vector<std::uint64_t> rowBits_;
+    std::vector<std::uint64_t> colBits_;
+    std::array<std::vector<Position>, 26> positions_;
+};
@@ -0,0 +1,621 @@
+#include "CrosswordFiller.h"
+
+#include <algorithm>
+#include <bit>
+#include <bitset>
+#include <cctype>
+#include <cmath>
+#include <limits>
+
+namespace {
+// Decisions are numbered by search depth and each one fixes a slot, so no search goes deeper
+// than the number of slots.
+constexpr int kMaxSlots = 512;
+constexpr std::uint32_t kAllLetters = (1u << 26) - 1;
+// Below this many candidates a slot's letters are read off its words rather than the index.
+constexpr int kScanLimit = 64;
+// Candidates compared by the lookahead before each decision.
+constexpr int kValueSample = 32;
+constexpr long kClockInterval = 64;
+// A search that makes this many decisions without a fill starts over with fresh choices and
+// twice the allowance; lucky early choices matter more than exhaustive search of unlucky ones.
+constexpr long kRestartNodes = 1000;
+
+// The decisions a slot's candidates depend on. When a slot runs out of candidates these are the
+// decisions to revisit; any deeper ones are jumped over.
+using Reasons = std::bitset<kMaxSlots>;
+
+struct Crossing {
+    int slot = -1;
+    int position = 0;
+};
+
+struct Slot {
+    int length = 0;
+    std::size_t offset = 0;
+    std::vector<int> cells;
+    // The slot crossing each position, if any.
+    std::vector<Crossing> crossings;
+    // The other slots of the same length, which may not take the same word.
+    std::vector<int> rivals;
+};
+
+// The index's words of one slot length, by rank.
+struct Bucket {
+    const WordPatternIndex* index = nullptr;
+    int length = 0;
+    std::size_t count = 0;
+    std::size_t blocks = 0;
+
+    [[nodiscard]] const std::uint64_t* withLetter(const int position, const int letter) const {
+        return index->withLetter(length, position, letter);
+    }
+    [[nodiscard]] int letterAt(const std::size_t word, const int position) const {
+        return index->letterAt(length, word, position);
+    }
+};
+
+struct State {
+    // Each slot's candidates as a bitset over the words of its length, at Slot::offset.
+    std::vector<std::uint64_t> domains;
+    std::vector<int> counts;
+    // The letters each cell may still take, bit 0 for 'A'.
+    std::vector<std::uint32_t> letters;
+    std::vector<Reasons> reasons;
+};
+
+int firstWord(const std::uint64_t* domain, const std::size_t blocks) {
+    for (std::size_t i = 0; i < blocks; ++i) {
+        if (domain[i] != 0) {
+            return static_cast<int>(i * 64) + std::countr_zero(domain[i]);
+        }
+    }
+    return -1;
+}
+
+// Whether every run of open cells in rows and columns is at least three long and the open cells
+// are connected.
+bool isValidTemplate(const std::vector<std::string>& grid) {
+    const int side = static_cast<int>(grid.size());
+    int open = 0;
+    int first = -1;
+    for (int line = 0; line < side; ++line) {
+        int rowRun = 0;
+        int colRun = 0;
+        for (int i = 0; i <= side; ++i) {
+            const bool rowOpen = i < side && grid[line][i] != '#';
+            const bool colOpen = i < side && grid[i][line] != '#';
+            if (!rowOpen && rowRun > 0 && rowRun < 3) return false;
+            if (!colOpen && colRun > 0 && colRun < 3) return false;
+            rowRun = rowOpen ? rowRun + 1 : 0;
+            colRun = colOpen ? colRun + 1 : 0;
+            if (rowOpen) {
+                ++open;
+                first = first < 0 ? line * side + i : first;
+            }
+        }
+    }
+    if (first < 0) {
+        return false;
+    }
+
+    std::vector<bool> seen(static_cast<std::size_t>(side * side), false);
+    std::vector<int> stack{first};
+    seen[first] = true;
+    int reached = 0;
+    while (!stack.empty()) {
+        const int cell = stack.back();
+        stack.pop_back();
+        ++reached;
+        const int r = cell / side;
+        const int c = cell % side;
+        const int next[4][2] = {{r - 1, c}, {r + 1, c}, {r, c - 1}, {r, c + 1}};
+        for (const auto& [nr, nc] : next) {
+            if (nr >= 0 && nc >= 0 && nr < side && nc < side && grid[nr][nc] != '#' && !seen[nr * side + nc]) {
+                seen[nr * side + nc] = true;
+                stack.push_back(nr * side + nc);
+            }
+        }
+    }
+    return reached == open;
+}
+
+int longestRun(const std::vector<std::string>& grid) {
+    const int side = static_cast<int>(grid.size());
+    int longest = 0;
+    for (int line = 0; line < side; ++line) {
+        int rowRun = 0;
+        int colRun = 0;
+        for (int i = 0; i < side; ++i) {
+            rowRun = grid[line][i] != '#' ? rowRun + 1 : 0;
+            colRun = grid[i][line] != '#' ? colRun + 1 : 0;
+            longest = std::max({longest, rowRun, colRun});
+        }
+    }
+    return longest;
+}
+
+// The longer of the row and column runs through (r, c).
+int runThrough(const std::vector<std::string>& grid, const int r, const int c) {
+    const int side = static_cast<int>(grid.size());
+    int across = 1;
+    for (int i = c - 1; i >= 0 && grid[r][i] != '#'; --i) ++across;
+    for (int i = c + 1; i < side && grid[r][i] != '#'; ++i) ++across;
+    int down = 1;
+    for (int i = r - 1; i >= 0 && grid[i][c] != '#'; --i) ++down;
+    for (int i = r + 1; i < side && grid[i][c] != '#'; ++i) ++down;
+    return std::max(across, down);
+}
+}
+
+CrosswordFiller::CrosswordFiller(std::shared_ptr<const WordPatternIndex> index)
+    : index_(index ? std::move(index) : std::make_shared<const WordPatternIndex>()) {}
+
+struct CrosswordFiller::Search {
+    struct Outcome {
+        bool solved = false;
+        Reasons conflict;
+    };
+
+    Search(const CrosswordFiller& owner, const std::chrono::steady_clock::time_point until,
+           const std::atomic<bool>* stopFlag)
+        : filler(owner), deadline(until), stop(stopFlag) {}
+
+    const CrosswordFiller& filler;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* stop;
+    std::array<Bucket, kMaxSide + 1> buckets;
+    std::vector<Slot> slots;
+    std::mt19937 gen{std::random_device{}()};
+    State solution;
+    long nodes = 0;
+    long nodeLimit = 0;
+    bool timedOut = false;
+    bool aborted = false;
+
+    [[nodiscard]] const Bucket& bucket(const int slot) const { return buckets[slots[slot].length]; }
+    std::uint64_t* domain(State& state, const int slot) const { return state.domains.data() + slots[slot].offset; }
+    const std::uint64_t* domain(const State& state, const int slot) const { return state.domains.data() + slots[slot].offset; }
+
+    bool setUp(const std::vector<std::string>& blockTemplate, State& state);
+    // Drops the candidates of slot with any of letters at position; true when any were dropped.
+    bool exclude(State& state, int slot, int position, std::uint32_t letters, const Reasons& because) const;
+    [[nodiscard]] std::uint32_t supportedLetters(const State& state, int slot, int position) const;
+    bool propagate(State& state, std::vector<int>& queue, Reasons& conflict) const;
+    [[nodiscard]] int pickSlot(const State& state) const;
+    int pickWord(const State& state, int slot);
+    Outcome solve(State& state, int depth);
+    [[nodiscard]] std::vector<std::string> grid(const std::vector<std::string>& blockTemplate) const;
+};
+
+bool CrosswordFiller::Search::setUp(const std::vector<std::string>& blockTemplate, State& state) {
+    const int rows = static_cast<int>(blockTemplate.size());
+    const int cols = rows == 0 ? 0 : static_cast<int>(blockTemplate.front().size());
+    if (rows < 2 || cols < 2 || rows > kMaxSide || cols > kMaxSide) {
+        return false;
+    }
+    state.letters.assign(static_cast<std::size_t>(rows * cols), 0);
+    for (int r = 0; r < rows; ++r) {
+        if (static_cast<int>(blockTemplate[r].size()) != cols) {
+            return false;
+        }
+        for (int c = 0; c < cols; ++c) {
+            const auto ch = static_cast<unsigned char>(blockTemplate[r][c]);
+            if (std::isalpha(ch)) {
+                state.letters[r * cols + c] = 1u << (std::toupper(ch) - 'A');
+            } else if (ch == '.' || ch == ' ') {
+                state.letters[r * cols + c] = kAllLetters;
+            } else if (ch != '#') {
+                return false;
+            }
+        }
+    }
+
+    // Slots are runs of two or more open cells; cellSlots records the across and down slot of
+    // each cell and its position there.
+    std::vector<std::array<Crossing, 2>> cellSlots(state.letters.size());
+    for (const bool across : {true, false}) {
+        const int lines = across ? rows : cols;
+        const int extent = across ? cols : rows;
+        for (int line = 0; line < lines; ++line) {
+            for (int start = 0; start < extent;) {
+                int end = start;
+                while (end < extent && state.letters[across ? line * cols + end : end * cols + line] != 0) {
+                    ++end;
+                }
+                if (end - start >= 2) {
+                    Slot slot;
+                    slot.length = end - start;
+                    for (int i = start; i < end; ++i) {
+                        const int cell = across ? line * cols + i : i * cols + line;
+                        cellSlots[cell][across ? 0 : 1] = Crossing{static_cast<int>(slots.size()), i - start};
+                        slot.cells.push_back(cell);
+                    }
+                    slots.push_back(std::move(slot));
+                }
+                start = end + 1;
+            }
+        }
+    }
+    if (slots.empty() || static_cast<int>(slots.size()) > kMaxSlots) {
+        return false;
+    }
+    for (std::size_t cell = 0; cell < cellSlots.size(); ++cell) {
+        if (state.letters[cell] != 0 && cellSlots[cell][0].slot < 0 && cellSlots[cell][1].slot < 0) {
+            return false;
+        }
+    }
+
+    for (int length = 0; length <= kMaxSide; ++length) {
+        const WordPatternIndex& index = *filler.index_;
+        buckets[length] = Bucket{&index, length, index.count(length), index.blocks(length)};
+    }
+    std::size_t size = 0;
+    for (int s = 0; s < static_cast<int>(slots.size()); ++s) {
+        Slot& slot = slots[s];
+        slot.offset = size;
+        size += bucket(s).blocks;
+        for (const int cell : slot.cells) {
+            const auto& pair = cellSlots[cell];
+            slot.crossings.push_back(pair[0].slot == s ? pair[1] : pair[0]);
+        }
+        for (int other = 0; other < static_cast<int>(slots.size()); ++other) {
+            if (other != s && slots[other].length == slot.length) {
+                slot.rivals.push_back(other);
+            }
+        }
+    }
+    state.domains.assign(size, ~std::uint64_t{0});
+    state.counts.assign(slots.size(), 0);
+    state.reasons.assign(slots.size(), Reasons{});
+    for (int s = 0; s < static_cast<int>(slots.size()); ++s) {
+        const Bucket& words = bucket(s);
+        if (words.count == 0) {
+            return false;
+        }
+        const std::size_t tail = words.count % 64;
+        if (tail != 0) {
+            domain(state, s)[words.blocks - 1] = (std::uint64_t{1} << tail) - 1;
+        }
+        state.counts[s] = static_cast<int>(words.count);
+        for (int p = 0; p < slots[s].length; ++p) {
+            exclude(state, s, p, kAllLetters & ~state.letters[slots[s].cells[p]], Reasons{});
+        }
+        if (state.counts[s] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CrosswordFiller::Search::exclude(State& state, const int slot, const int position, const std::uint32_t letters,
+                                      const Reasons& because) const {
+    if (letters == 0) {
+        return false;
+    }
+    const Bucket& words = bucket(slot);
+    std::uint64_t* bits = domain(state, slot);
+    for (std::uint32_t rest = letters; rest != 0; rest &= rest - 1) {
+        const std::uint64_t* letter = words.withLetter(position, std::countr_zero(rest));
+        for (std::size_t i = 0; i < words.blocks; ++i) {
+            bits[i] &= ~letter[i];
+        }
+    }
+    int count = 0;
+    for (std::size_t i = 0; i < words.blocks; ++i) {
+        count += std::popcount(bits[i]);
+    }
+    if (count == state.counts[slot]) {
+        return false;
+    }
+    state.counts[slot] = count;
+    state.reasons[slot] |= because;
+    return true;
+}
+
+std::uint32_t CrosswordFiller::Search::supportedLetters(const State& state, const int slot, const int position) const {
+    const Bucket& words = bucket(slot);
+    const std::uint64_t* bits = domain(state, slot);
+    std::uint32_t supported = 0;
+    if (state.counts[slot] <= kScanLimit) {
+        for (std::size_t i = 0; i < words.blocks; ++i) {
+            for (std::uint64_t rest = bits[i]; rest != 0; rest &= rest - 1) {
+                const std::size_t word = i * 64 + static_cast<std::size_t>(std::countr_zero(rest));
+                supported |= 1u << words.letterAt(word, position);
+            }
+        }
+        return supported;
+    }
+    for (std::uint32_t rest = state.letters[slots[slot].cells[position]]; rest != 0; rest &= rest - 1) {
+        const int letter = std::countr_zero(rest);
+        const std::uint64_t* with = words.withLetter(position, letter);
+        for (std::size_t i = 0; i < words.blocks; ++i) {
+            if (bits[i] & with[i]) {
+                supported |= 1u << letter;
+                break;
+            }
+        }
+    }
+    return supported;
+}
+
+// Brings every slot in queue, and every slot a change reaches, to arc consistency with the
+// slots crossing it, and takes the word of each slot down to one candidate away from its rivals.
+// On a wipe-out conflict holds the emptied slot's reasons.
+bool CrosswordFiller::Search::propagate(State& state, std::vector<int>& queue, Reasons& conflict) const {
+    std::vector<bool> queued(slots.size(), false);
+    for (const int slot : queue) {
+        queued[slot] = true;
+    }
+    const auto wipedOut = [&](const int slot) {
+        if (state.counts[slot] == 0) {
+            conflict = state.reasons[slot];
+            return true;
+        }
+        if (!queued[slot]) {
+            queued[slot] = true;
+            queue.push_back(slot);
+        }
+        return false;
+    };
+
+    while (!queue.empty()) {
+        const int slot = queue.back();
+        queue.pop_back();
+        queued[slot] = false;
+        const Slot& current = slots[slot];
+        for (int p = 0; p < current.length; ++p) {
+            const int cell = current.cells[p];
+            const std::uint32_t letters = state.letters[cell] & supportedLetters(state, slot, p);
+            if (letters == state.letters[cell]) {
+                continue;
+            }
+            const std::uint32_t removed = state.letters[cell] & ~letters;
+            state.letters[cell] = letters;
+            const Crossing& crossing = current.crossings[p];
+            if (crossing.slot >= 0 && exclude(state, crossing.slot, crossing.position, removed, state.reasons[slot])
+                && wipedOut(crossing.slot)) {
+                return false;
+            }
+        }
+        if (state.counts[slot] != 1) {
+            continue;
+        }
+        const int word = firstWord(domain(state, slot), bucket(slot).blocks);
+        const auto block = static_cast<std::size_t>(word / 64);
+        const std::uint64_t bit = std::uint64_t{1} << (word % 64);
+        for (const int rival : current.rivals) {
+            std::uint64_t& bits = domain(state, rival)[block];
+            if (bits & bit) {
+                bits &= ~bit;
+                --state.counts[rival];
+                state.reasons[rival] |= state.reasons[slot];
+                if (wipedOut(rival)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int CrosswordFiller::Search::pickSlot(const State& state) const {
+    int best = -1;
+    for (int s = 0; s < static_cast<int>(slots.size()); ++s) {
+        if (state.counts[s] > 1
+            && (best < 0 || state.counts[s] < state.counts[best]
+                || (state.counts[s] == state.counts[best] && slots[s].length > slots[best].length))) {
+            best = s;
+        }
+    }
+    return best;
+}
+
+// Among a sample of slot's candidates, the one leaving the crossing slots the most candidates:
+// the largest sum of the logs of their counts with its letters.
+int CrosswordFiller::Search::pickWord(const State& state, const int slot) {
+    const Slot& current = slots[slot];
+    const Bucket& words = bucket(slot);
+    const std::uint64_t* bits = domain(state, slot);
+
+    std::array<std::array<float, 26>, kMaxSide> weights{};
+    for (int p = 0; p < current.length; ++p) {
+        const Crossing& crossing = current.crossings[p];
+        if (crossing.slot < 0 || state.counts[crossing.slot] <= 1) {
+            continue;
+        }
+        const Bucket& crossed = bucket(crossing.slot);
+        const std::uint64_t* crossedBits = domain(state, crossing.slot);
+        weights[p].fill(-std::numeric_limits<float>::infinity());
+        for (std::uint32_t rest = state.letters[current.cells[p]]; rest != 0; rest &= rest - 1) {
+            const int letter = std::countr_zero(rest);
+            const std::uint64_t* with = crossed.withLetter(crossing.position, letter);
+            int count = 0;
+            for (std::size_t i = 0; i < crossed.blocks; ++i) {
+                count += std::popcount(crossedBits[i] & with[i]);
+            }
+            if (count > 0) {
+                weights[p][letter] = std::log(static_cast<float>(count));
+            }
+        }
+    }
+
+    std::vector<int> sample;
+    if (state.counts[slot] <= kValueSample) {
+        for (std::size_t i = 0; i < words.blocks; ++i) {
+            for (std::uint64_t rest = bits[i]; rest != 0; rest &= rest - 1) {
+                sample.push_back(static_cast<int>(i * 64) + std::countr_zero(rest));
+            }
+        }
+    } else {
+        // The first candidate at or after a random word, wrapping around.
+        std::uniform_int_distribution<std::size_t> pick(0, words.count - 1);
+        for (int n = 0; n < kValueSample; ++n) {
+            const std::size_t from = pick(gen);
+            std::size_t block = from / 64;
+            std::uint64_t rest = bits[block] & (~std::uint64_t{0} << (from % 64));
+            while (rest == 0) {
+                block = (block + 1) % words.blocks;
+                rest = bits[block];
+            }
+            sample.push_back(static_cast<int>(block * 64) + std::countr_zero(rest));
+        }
+    }
+
+    int best = sample.front();
+    float bestScore = -std::numeric_limits<float>::infinity();
+    for (const int word : sample) {
+        float score = 0.0f;
+        for (int p = 0; p < current.length; ++p) {
+            score += weights[p][words.letterAt(static_cast<std::size_t>(word), p)];
+        }
+        if (score > bestScore) {
+            best = word;
+            bestScore = score;
+        }
+    }
+    return best;
+}
+
+// Decides the most constrained slot, then the next, and on failure backs up to the deepest
+// decision among the conflict's reasons. That decision's word is ruled out with the remaining
+// reasons, which then explain any later failure of its slot.
+CrosswordFiller::Search::Outcome CrosswordFiller::Search::solve(State& state, const int depth) {
+    for (;;) {
+        if (++nodes % kClockInterval == 0
+            && (std::chrono::steady_clock::now() > deadline || (stop && stop->load(std::memory_order_relaxed)))) {
+            timedOut = true;
+        }
+        aborted = aborted || timedOut || nodes > nodeLimit;
+        if (aborted) {
+            return {};
+        }
+        const int slot = pickSlot(state);
+        if (slot < 0) {
+            solution = state;
+            return {true, {}};
+        }
+        const int word = pickWord(state, slot);
+
+        State next = state;
+        std::uint64_t* bits = domain(next, slot);
+        std::fill(bits, bits + bucket(slot).blocks, 0);
+        bits[word / 64] = std::uint64_t{1} << (word % 64);
+        next.counts[slot] = 1;
+        next.reasons[slot].reset();
+        next.reasons[slot].set(static_cast<std::size_t>(depth));
+        std::vector<int> queue{slot};
+        Reasons conflict;
+        if (propagate(next, queue, conflict)) {
+            Outcome deeper = solve(next, depth + 1);
+            if (deeper.solved || aborted) {
+                return deeper;
+            }
+            conflict = deeper.conflict;
+        }
+        if (!conflict.test(static_cast<std::size_t>(depth))) {
+            return {false, conflict};
+        }
+        conflict.reset(static_cast<std::size_t>(depth));
+
+        domain(state, slot)[word / 64] &= ~(std::uint64_t{1} << (word % 64));
+        --state.counts[slot];
+        state.reasons[slot] |= conflict;
+        if (state.counts[slot] == 0) {
+            return {false, state.reasons[slot]};
+        }
+        queue.assign(1, slot);
+        if (!propagate(state, queue, conflict)) {
+            return {false, conflict};
+        }
+    }
+}
+
+std::vector<std::string> CrosswordFiller::Search::grid(const std::vector<std::string>& blockTemplate) const {
+    std::vector<std::string> filled = blockTemplate;
+    const int cols = static_cast<int>(filled.front().size());
+    for (int s = 0; s < static_cast<int>(slots.size()); ++s) {
+        const std::string word = filler.index_->word(slots[s].length,
+                                                     static_cast<std::size_t>(firstWord(domain(solution, s), bucket(s).blocks)));
+        for (int p = 0; p < slots[s].length; ++p) {
+            const int cell = slots[s].cells[p];
+            filled[cell / cols][cell % cols] = word[p];
+        }
+    }
+    return filled;
+}
+
+std::optional<CrosswordPuzzle> CrosswordFiller::fill(const std::vector<std::string>& blockTemplate,
+                                                     const std::chrono::milliseconds budget,
+                                                     const std::atomic<bool>* stop) const {
+    Search search(*this, std::chrono::steady_clock::now() + budget, stop);
+    State start;
+    if (!search.setUp(blockTemplate, start)) {
+        return std::nullopt;
+    }
+    std::vector<int> queue(search.slots.size());
+    for (int s = 0; s < static_cast<int>(queue.size()); ++s) {
+        queue[s] = s;
+    }
+    Reasons conflict;
+    if (!search.propagate(start, queue, conflict)) {
+        return std::nullopt;
+    }
+    // Without an abort the search either filled the grid or proved there is no fill.
+    for (long allowance = kRestartNodes; !search.timedOut; allowance *= 2) {
+        search.nodeLimit = search.nodes + allowance;
+        search.aborted = false;
+        State state = start;
+        if (search.solve(state, 0).solved) {
+            return buildCrosswordPuzzle(search.grid(blockTemplate));
+        }
+        if (!search.aborted) {
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string> generateBlockTemplate(const int side, std::mt19937& gen) {
+    const int n = std::clamp(side, 3, CrosswordFiller::kMaxSide);
+    std::vector<std::string> grid(static_cast<std::size_t>(n), std::string(static_cast<std::size_t>(n), '.'));
+    const int target = n * n / 6;
+    // Stacks of long slots rarely have a fill, so blocks go on past the target until none is
+    // longer than this.
+    const int longestSlot = std::min(n, n / 2 + 2);
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    int blocks = 0;
+    int longest = n;
+    for (int attempt = 0; attempt < n * n * 8 && (blocks < target || longest > longestSlot); ++attempt) {
+        // Of a few random open cells, block the one in the longest run, so long slots are broken
+        // up before short ones.
+        int row = -1;
+        int col = -1;
+        int run = 0;
+        for (int k = 0; k < 4; ++k) {
+            const int r = pick(gen);
+            const int c = pick(gen);
+            const int through = grid[r][c] == '#' ? 0 : runThrough(grid, r, c);
+            if (through > run) {
+                row = r;
+                col = c;
+                run = through;
+            }
+        }
+        if (row < 0) {
+            continue;
+        }
+        const int mirrorRow = n - 1 - row;
+        const int mirrorCol = n - 1 - col;
+        grid[row][col] = '#';
+        grid[mirrorRow][mirrorCol] = '#';
+        if (isValidTemplate(grid)) {
+            blocks += row == mirrorRow && col == mirrorCol ? 1 : 2;
+            longest = longestRun(grid);
+        } else {
+            grid[row][col] = '.';
+            grid[mirrorRow][mirrorCol] = '.';
+        }
+    }
+    return grid;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "CrosswordGenerator.h"
+#include "WordPatternIndex.h"
+
+// Fills dense, American-style crossword grids from a dictionary. A slot's candidates are a
+// bitset over the index's words of its length, so restricting a slot to a letter at a position is
+// one AND per block of 64 words with the index's bitset for that (position, letter).
+class CrosswordFiller {
+public:
+    static constexpr int kMaxSide = 25;
+
+    explicit CrosswordFiller(std::shared_ptr<const WordPatternIndex> index);
+
+    [[nodiscard]] std::size_t wordCount() const { return index_->size(); }
+
+    // blockTemplate has one string per row: '#' for blocks, '.' or ' ' for open cells and letters
+    // for cells that must keep them. Every open cell must be in an across or down slot of at least
+    // two cells. The grid is filled so every slot holds a different dictionary word, using
+    // arc-consistency propagation over the crossing cells, the slot with the fewest candidates
+    // first and conflict-directed backjumping. nullopt when the template is unusable, has no fill,
+    // or the budget runs out or stop is raised first.
+    [[nodiscard]] std::optional<CrosswordPuzzle> fill(const std::vector<std::string>& blockTemplate,
+                                                      std::chrono::milliseconds budget = std::chrono::seconds(10),
+                                                      const std::atomic<bool>* stop = nullptr) const;
+
+private:
+    struct Search;
+
+    std::shared_ptr<const WordPatternIndex> index_;
+};
+
+// A side x side template of '#' and '.' with 180-degree rotational symmetry, every slot at least
+// three cells long and all open cells connected; about one cell in six is a block.
+std::vector<std::string> generateBlockTemplate(int side, std::mt19937& gen);
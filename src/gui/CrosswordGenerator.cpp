@@ -1,116 +1,66 @@
 #include "CrosswordGenerator.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <cmath>
+#include <future>
+#include <mutex>
 #include <numeric>
 #include <optional>
 #include <random>
 #include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
-namespace {
-struct Placement {
-    std::string word;
-    bool across = true;
-    int row = 0;
-    int col = 0;
-};
+#include "CrosswordBoard.h"
 
+namespace {
 static std::mt19937& rng() {
     static thread_local std::mt19937 gen{std::random_device{}()};
     return gen;
 }
 
-bool inBounds(int r, int c, int rows, int cols) {
-    return r >= 0 && c >= 0 && r < rows && c < cols;
-}
-
-bool canPlace(const std::string& word,
-              bool across,
-              int row,
-              int col,
-              const std::vector<std::string>& grid) {
-    const int rows = static_cast<int>(grid.size());
-    const int cols = rows == 0 ? 0 : static_cast<int>(grid.front().size());
-    if (rows == 0 || cols == 0) return false;
-    const int len = static_cast<int>(word.size());
-
-    if (across) {
-        if (col < 0 || col + len > cols) return false;
-    } else {
-        if (row < 0 || row + len > rows) return false;
-    }
-
-    auto hasLetter = [&](int r, int c) {
-        return inBounds(r, c, rows, cols) && std::isalpha(static_cast<unsigned char>(grid[r][c]));
-    };
-
-    const int br = row - (across ? 0 : 1);
-    const int bc = col - (across ? 1 : 0);
-    if (hasLetter(br, bc)) return false;
-    const int ar = row + (across ? 0 : len);
-    const int ac = col + (across ? len : 0);
-    if (hasLetter(ar, ac)) return false;
-
-    for (int i = 0; i < len; ++i) {
-        const int r = row + (across ? 0 : i);
-        const int c = col + (across ? i : 0);
-        const char existing = grid[r][c];
-        const bool crossingCell = std::isalpha(static_cast<unsigned char>(existing));
-        if (crossingCell && existing != word[i]) {
-            return false;
-        }
-
-        if (across) {
-            if (!crossingCell && (hasLetter(r - 1, c) || hasLetter(r + 1, c))) {
-                return false;
-            }
-        } else {
-            if (!crossingCell && (hasLetter(r, c - 1) || hasLetter(r, c + 1))) {
-                return false;
-            }
-        }
-    }
-    return true;
-}
-
-bool placeWord(const std::string& word,
-               bool across,
-               int row,
-               int col,
-               std::vector<std::string>& grid,
-               std::vector<Placement>& placed,
-               int& crossings) {
-    if (!canPlace(word, across, row, col, grid)) {
+bool placeWord(const std::string& word, bool across, int row, int col, CrosswordBoard& board, int& crossings) {
+    const int crossed = board.place(word, across, row, col);
+    if (crossed < 0) {
         return false;
     }
-    bool crossed = false;
-    for (int i = 0; i < static_cast<int>(word.size()); ++i) {
-        const int r = row + (across ? 0 : i);
-        const int c = col + (across ? i : 0);
-        if (std::isalpha(static_cast<unsigned char>(grid[r][c]))) {
-            crossed = true;
-        }
-        grid[r][c] = word[i];
-    }
-    if (crossed) {
+    if (crossed > 0) {
         ++crossings;
     }
-    placed.push_back(Placement{word, across, row, col});
     return true;
 }
 
-std::vector<std::pair<int, int>> findMatchingLetters(const std::vector<std::string>& grid, char letter) {
-    std::vector<std::pair<int, int>> coords;
-    for (int r = 0; r < static_cast<int>(grid.size()); ++r) {
-        for (int c = 0; c < static_cast<int>(grid[r].size()); ++c) {
-            if (grid[r][c] == letter) {
-                coords.emplace_back(r, c);
+// Tries to hang word off a letter already on the board, through each of its letters in random
+// order. Candidates come from the board's per-letter positions, visited from a random start.
+bool placeCrossing(const std::string& word, CrosswordBoard& board, int& crossings) {
+    std::vector<int> letterOrder(word.size());
+    std::iota(letterOrder.begin(), letterOrder.end(), 0);
+    std::shuffle(letterOrder.begin(), letterOrder.end(), rng());
+
+    for (int li : letterOrder) {
+        const auto& matches = board.positions(word[li]);
+        if (matches.empty()) {
+            continue;
+        }
+        const std::size_t first = std::uniform_int_distribution<std::size_t>(0, matches.size() - 1)(rng());
+        for (std::size_t k = 0; k < matches.size(); ++k) {
+            const auto [mr, mc] = matches[(first + k) % matches.size()];
+            bool acrossFirst = std::uniform_int_distribution<int>(0, 1)(rng()) == 0;
+            const int acrossCol = mc - li;
+            const int downRow = mr - li;
+            if (acrossFirst) {
+                if (placeWord(word, true, mr, acrossCol, board, crossings)) return true;
+                if (placeWord(word, false, downRow, mc, board, crossings)) return true;
+            } else {
+                if (placeWord(word, false, downRow, mc, board, crossings)) return true;
+                if (placeWord(word, true, mr, acrossCol, board, crossings)) return true;
             }
         }
     }
-    return coords;
+    return false;
 }
 
 void trimGrid(std::vector<std::string>& grid, int& rowOffset, int& colOffset) {
@@ -222,6 +172,193 @@ CrosswordPuzzle buildPuzzle(const std::vector<std::string>& rawGrid, int , int )
     return puzzle;
 }
 
+// Search attempts alternate between these two; backtracking gets a node budget per attempt and
+// tries this many of the best placements of each word.
+constexpr int kBacktrackNodes = 400;
+constexpr int kBacktrackBranching = 3;
+// Once every word is placed, this many more attempts look for a better layout before stopping.
+constexpr int kRefineAttempts = 256;
+
+struct Candidate {
+    bool across = true;
+    int row = 0;
+    int col = 0;
+    int crossings = 0;
+};
+
+// Every placement of word that crosses at least one letter on the board.
+void collectCandidates(const CrosswordBoard& board, const std::string& word, std::vector<Candidate>& out) {
+    out.clear();
+    for (int li = 0; li < static_cast<int>(word.size()); ++li) {
+        for (const auto [r, c] : board.positions(word[li])) {
+            for (const bool across : {true, false}) {
+                const int row = across ? r : r - li;
+                const int col = across ? c - li : c;
+                const int crossed = board.crossings(word, across, row, col);
+                if (crossed <= 0) {
+                    continue;
+                }
+                // A placement crossing several letters is reached once through each of them.
+                const auto same = [&](const Candidate& other) {
+                    return other.across == across && other.row == row && other.col == col;
+                };
+                if (crossed == 1 || std::none_of(out.begin(), out.end(), same)) {
+                    out.push_back(Candidate{across, row, col, crossed});
+                }
+            }
+        }
+    }
+}
+
+// Candidates with the most crossings first, in random order among equals.
+void rankCandidates(std::vector<Candidate>& candidates, std::mt19937& gen) {
+    std::shuffle(candidates.begin(), candidates.end(), gen);
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.crossings > b.crossings;
+    });
+}
+
+struct Layout {
+    CrosswordBoard board;
+    int crossings = 0;
+};
+
+// The first word lies across the middle of the board; it is one of the longest three.
+Layout startLayout(const std::vector<std::string>& words, const int side, std::mt19937& gen, std::vector<int>& pending) {
+    pending.resize(words.size());
+    std::iota(pending.begin(), pending.end(), 0);
+    std::shuffle(pending.begin(), pending.end(), gen);
+    std::stable_sort(pending.begin(), pending.end(), [&words](const int a, const int b) {
+        return words[a].size() > words[b].size();
+    });
+    const int pick = std::uniform_int_distribution<int>(0, std::min<int>(2, static_cast<int>(pending.size()) - 1))(gen);
+    std::swap(pending[0], pending[pick]);
+
+    Layout layout{CrosswordBoard(side, side), 0};
+    const std::string& first = words[pending.front()];
+    layout.board.place(first, true, side / 2, (side - static_cast<int>(first.size())) / 2);
+    pending.erase(pending.begin());
+    return layout;
+}
+
+// Places words one at a time where they cross the most letters, sweeping the unplaced ones
+// again while any of them still finds a spot.
+Layout greedyLayout(const std::vector<std::string>& words, const int side, std::mt19937& gen) {
+    std::vector<int> pending;
+    Layout layout = startLayout(words, side, gen, pending);
+    std::vector<Candidate> candidates;
+    for (bool progress = true; progress && !pending.empty();) {
+        progress = false;
+        for (auto it = pending.begin(); it != pending.end();) {
+            collectCandidates(layout.board, words[*it], candidates);
+            if (candidates.empty()) {
+                ++it;
+                continue;
+            }
+            rankCandidates(candidates, gen);
+            const Candidate& best = candidates.front();
+            layout.board.place(words[*it], best.across, best.row, best.col);
+            layout.crossings += best.crossings;
+            it = pending.erase(it);
+            progress = true;
+        }
+    }
+    return layout;
+}
+
+// Depth-first search that places the most constrained word next (the one with the fewest
+// crossing placements) and tries its few best placements, keeping the layout that placed the
+// most words. Words with no placement are skipped over rather than ending the branch.
+class Backtracker {
+public:
+    Backtracker(const std::vector<std::string>& words, std::mt19937& gen) : words_(words), gen_(gen) {}
+
+    Layout run(const int side) {
+        std::vector<int> pending;
+        Layout start = startLayout(words_, side, gen_, pending);
+        best_ = start;
+        nodesLeft_ = kBacktrackNodes;
+        search(start, pending);
+        return best_;
+    }
+
+private:
+    const std::vector<std::string>& words_;
+    std::mt19937& gen_;
+    Layout best_{CrosswordBoard(0, 0), 0};
+    int nodesLeft_ = 0;
+
+    void search(const Layout& layout, std::vector<int>& pending) {
+        if (layout.board.wordCount() > best_.board.wordCount()
+            || (layout.board.wordCount() == best_.board.wordCount() && layout.crossings > best_.crossings)) {
+            best_ = layout;
+        }
+        if (pending.empty()) {
+            nodesLeft_ = 0;
+            return;
+        }
+        if (--nodesLeft_ <= 0) {
+            return;
+        }
+
+        std::size_t chosen = pending.size();
+        std::vector<Candidate> choices;
+        std::vector<Candidate> candidates;
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            collectCandidates(layout.board, words_[pending[i]], candidates);
+            if (!candidates.empty() && (chosen == pending.size() || candidates.size() < choices.size())) {
+                chosen = i;
+                choices.swap(candidates);
+            }
+        }
+        if (chosen == pending.size()) {
+            return;
+        }
+        rankCandidates(choices, gen_);
+
+        const int word = pending[chosen];
+        std::swap(pending[chosen], pending.back());
+        pending.pop_back();
+        const int branches = std::min<int>(kBacktrackBranching, static_cast<int>(choices.size()));
+        for (int b = 0; b < branches && nodesLeft_ > 0; ++b) {
+            const Candidate& choice = choices[b];
+            Layout next = layout;
+            next.board.place(words_[word], choice.across, choice.row, choice.col);
+            next.crossings += choice.crossings;
+            search(next, pending);
+        }
+        pending.push_back(word);
+        std::swap(pending[chosen], pending.back());
+    }
+};
+
+CrosswordLayoutScore scoreLayout(const Layout& layout, std::vector<std::string>& grid) {
+    CrosswordLayoutScore score;
+    score.placedWords = layout.board.wordCount();
+    score.crossings = layout.crossings;
+    grid = layout.board.grid();
+    int minR = layout.board.rows(), minC = layout.board.cols(), maxR = -1, maxC = -1;
+    int letters = 0;
+    for (int r = 0; r < layout.board.rows(); ++r) {
+        for (int c = 0; c < layout.board.cols(); ++c) {
+            if (grid[r][c] != '.') {
+                ++letters;
+                minR = std::min(minR, r);
+                minC = std::min(minC, c);
+                maxR = std::max(maxR, r);
+                maxC = std::max(maxC, c);
+            }
+        }
+    }
+    if (letters > 0) {
+        const int height = maxR - minR + 1;
+        const int width = maxC - minC + 1;
+        score.density = static_cast<double>(letters) / (height * width);
+        score.compactness = static_cast<double>(std::min(height, width)) / std::max(height, width);
+    }
+    return score;
+}
+
 std::string cleanWord(const std::string& raw) {
     std::string out;
     for (char ch : raw) {
@@ -233,8 +370,12 @@ std::string cleanWord(const std::string& raw) {
 }
 }
 
+CrosswordPuzzle buildCrosswordPuzzle(const std::vector<std::string>& grid) {
+    return buildPuzzle(grid, 0, 0);
+}
+
 std::optional<CrosswordPuzzle> generateCrossword(const std::vector<std::string>& rawWords, const int rows, const int cols) {
-    if (rows < 3 || cols < 3) {
+    if (rows < 3 || cols < 3 || rows > CrosswordBoard::kMaxSide || cols > CrosswordBoard::kMaxSide) {
         return std::nullopt;
     }
 
@@ -253,41 +394,17 @@ std::optional<CrosswordPuzzle> generateCrossword(const std::vector<std::string>&
         std::shuffle(words.begin() + 1, words.end(), rng());
     }
 
-    std::vector<std::string> grid(rows, std::string(cols, '.'));
-    std::vector<Placement> placed;
+    CrosswordBoard board(rows, cols);
     int crossings = 0;
 
     const auto& first = words.front();
-    if (!placeWord(first, true, rows / 2, std::max(0, (cols - static_cast<int>(first.size())) / 2), grid, placed, crossings)) {
+    if (!placeWord(first, true, rows / 2, std::max(0, (cols - static_cast<int>(first.size())) / 2), board, crossings)) {
         return std::nullopt;
     }
 
     for (size_t wi = 1; wi < words.size(); ++wi) {
         const std::string& word = words[wi];
-        bool placedWord = false;
-
-        std::vector<int> letterOrder(word.size());
-        std::iota(letterOrder.begin(), letterOrder.end(), 0);
-        std::shuffle(letterOrder.begin(), letterOrder.end(), rng());
-
-        for (int li : letterOrder) {
-            const char letter = word[li];
-            auto matches = findMatchingLetters(grid, letter);
-            std::shuffle(matches.begin(), matches.end(), rng());
-            for (const auto& [mr, mc] : matches) {
-                bool acrossFirst = std::uniform_int_distribution<int>(0, 1)(rng()) == 0;
-                const int acrossCol = mc - li;
-                const int downRow = mr - li;
-                if (acrossFirst) {
-                    if (placeWord(word, true, mr, acrossCol, grid, placed, crossings)) { placedWord = true; break; }
-                    if (placeWord(word, false, downRow, mc, grid, placed, crossings)) { placedWord = true; break; }
-                } else {
-                    if (placeWord(word, false, downRow, mc, grid, placed, crossings)) { placedWord = true; break; }
-                    if (placeWord(word, true, mr, acrossCol, grid, placed, crossings)) { placedWord = true; break; }
-                }
-            }
-            if (placedWord) break;
-        }
+        bool placedWord = placeCrossing(word, board, crossings);
 
         if (!placedWord) {
             std::vector<int> rowOrder(rows);
@@ -300,12 +417,12 @@ std::optional<CrosswordPuzzle> generateCrossword(const std::vector<std::string>&
                 for (int c : colOrder) {
                     bool acrossFirst = std::uniform_int_distribution<int>(0, 1)(rng()) == 0;
                     if (acrossFirst) {
-                        if (placeWord(word, true, r, c, grid, placed, crossings) || placeWord(word, false, r, c, grid, placed, crossings)) {
+                        if (placeWord(word, true, r, c, board, crossings) || placeWord(word, false, r, c, board, crossings)) {
                             placedWord = true;
                             break;
                         }
                     } else {
-                        if (placeWord(word, false, r, c, grid, placed, crossings) || placeWord(word, true, r, c, grid, placed, crossings)) {
+                        if (placeWord(word, false, r, c, board, crossings) || placeWord(word, true, r, c, board, crossings)) {
                             placedWord = true;
                             break;
                         }
@@ -320,6 +437,7 @@ std::optional<CrosswordPuzzle> generateCrossword(const std::vector<std::string>&
         }
     }
 
+    auto grid = board.grid();
     for (auto& row : grid) {
         for (auto& ch : row) {
             if (ch == '.') ch = '#';
@@ -344,3 +462,82 @@ std::optional<CrosswordPuzzle> generateCrossword(const std::vector<std::string>&
 
     return buildPuzzle(centered, rowOffset, colOffset);
 }
+
+std::optional<CrosswordPuzzle> searchCrossword(const std::vector<std::string>& rawWords, const CrosswordSearchOptions& options) {
+    const int maxSide = std::clamp(options.maxSide, 3, CrosswordBoard::kMaxSide);
+    std::vector<std::string> words;
+    int letters = 0;
+    int longest = 0;
+    for (const auto& raw : rawWords) {
+        auto cleaned = cleanWord(raw);
+        if (cleaned.empty() || static_cast<int>(cleaned.size()) > maxSide) continue;
+        letters += static_cast<int>(cleaned.size());
+        longest = std::max(longest, static_cast<int>(cleaned.size()));
+        words.push_back(std::move(cleaned));
+    }
+    if (words.empty()) {
+        return std::nullopt;
+    }
+
+    // Crosswords laid out this way fill roughly half of their bounding box, so smaller boards
+    // than this rarely hold every word.
+    const int minSide = std::clamp(std::max(longest, static_cast<int>(std::ceil(std::sqrt(2.0 * letters)))), 3, maxSide);
+    const int sides = maxSide - minSide + 1;
+    const auto deadline = std::chrono::steady_clock::now() + options.budget;
+
+    std::mutex mutex;
+    std::optional<CrosswordLayoutScore> bestScore;
+    std::vector<std::string> bestGrid;
+    std::atomic<int> attempts{0};
+    std::atomic<int> completedAt{-1};
+
+    const auto work = [&](const unsigned seed) {
+        std::mt19937 gen(seed);
+        Backtracker backtracker(words, gen);
+        std::vector<std::string> grid;
+        while (std::chrono::steady_clock::now() < deadline
+               && !(options.stop && options.stop->load(std::memory_order_relaxed))) {
+            const int attempt = attempts++;
+            const int complete = completedAt.load();
+            if (complete >= 0 && attempt >= complete + kRefineAttempts) {
+                break;
+            }
+            // Each board size gets a greedy and a backtracking attempt in turn.
+            const int side = minSide + (attempt / 2) % sides;
+            const Layout layout = attempt % 2 == 0 ? greedyLayout(words, side, gen) : backtracker.run(side);
+            const CrosswordLayoutScore score = scoreLayout(layout, grid);
+            if (score.placedWords == static_cast<int>(words.size())) {
+                int none = -1;
+                completedAt.compare_exchange_strong(none, attempt);
+            }
+            std::lock_guard lock(mutex);
+            if (!bestScore || *bestScore < score) {
+                bestScore = score;
+                bestGrid.swap(grid);
+            }
+        }
+    };
+
+    const int workers = options.workers > 0 ? options.workers : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::random_device seeds;
+    std::vector<std::future<void>> running;
+    for (int i = 0; i < workers; ++i) {
+        running.push_back(std::async(std::launch::async, work, seeds()));
+    }
+    for (auto& worker : running) {
+        worker.get();
+    }
+
+    for (auto& row : bestGrid) {
+        for (auto& ch : row) {
+            if (ch == '.') ch = '#';
+        }
+    }
+    int rowOffset = 0;
+    int colOffset = 0;
+    trimGrid(bestGrid, rowOffset, colOffset);
+    if (bestGrid.empty()) {
+        return std::nullopt;
+    }
+    return buildPuzzle(bestGrid, rowOffset, colOffset);
+}
@@ -1,10 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "CrosswordBoard.h"
+
 struct CrosswordEntry {
     int number = 0;
     std::string word;
@@ -18,3 +22,45 @@ struct CrosswordPuzzle {
 };
 
 std::optional<CrosswordPuzzle> generateCrossword(const std::vector<std::string>& rawWords, int rows, int cols);
+
+// Numbers a grid of letters and '#' blocks row by row and lists its across and down entries of
+// two or more cells.
+CrosswordPuzzle buildCrosswordPuzzle(const std::vector<std::string>& grid);
+
+struct CrosswordSearchOptions {
+    // Square boards from the smallest that could plausibly hold the words up to this side are
+    // tried in turn.
+    int maxSide = CrosswordBoard::kMaxSide;
+    std::chrono::milliseconds budget{1000};
+    // 0 runs one worker per hardware thread.
+    int workers = 0;
+    // When set, the search also stops as soon as this turns true, e.g. when its window closes.
+    const std::atomic<bool>* stop = nullptr;
+};
+
+// Layouts are ranked by placed words first, so every placed word outweighs any amount of the
+// rest; among layouts placing as many, by a blend of crossings (cells shared by an across and a
+// down word), density (letters over the bounding box) and compactness (the short side of the
+// bounding box over the long one).
+struct CrosswordLayoutScore {
+    int placedWords = 0;
+    int crossings = 0;
+    double density = 0.0;
+    double compactness = 0.0;
+
+    [[nodiscard]] double shape() const { return crossings * 10.0 + density * 100.0 + compactness * 50.0; }
+    [[nodiscard]] bool operator<(const CrosswordLayoutScore& other) const {
+        if (placedWords != other.placedWords) {
+            return placedWords < other.placedWords;
+        }
+        return shape() < other.shape();
+    }
+};
+
+// Lays the words out many times on parallel workers, alternating randomized greedy passes with
+// bounded backtracking across board sizes, and returns the best layout by CrosswordLayoutScore
+// trimmed to its letters. The search stops at the budget, or shortly after a layout places every
+// word, or when options.stop is raised. Words that cannot be joined to the rest are left out
+// rather than failing the layout, so the result is nullopt only when no word is usable.
+std::optional<CrosswordPuzzle> searchCrossword(const std::vector<std::string>& rawWords,
+                                               const CrosswordSearchOptions& options = {});
@@ -0,0 +1,72 @@
+#include "CrosswordSearcher.h"
+
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
+#include <chrono>
+#include <random>
+#include <utility>
+
+#include "CrosswordFiller.h"
+
+namespace {
+constexpr std::chrono::seconds kFillBudget{10};
+}
+
+CrosswordSearcher::CrosswordSearcher(QObject* parent) : QObject(parent) {}
+
+CrosswordSearcher::~CrosswordSearcher() {
+    stop_ = true;
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool CrosswordSearcher::start(std::vector<std::string> words) {
+    return run([words, stop = &stop_]() {
+        CrosswordSearchOptions options;
+        options.stop = stop;
+        return searchCrossword(words, options);
+    }, words);
+}
+
+bool CrosswordSearcher::fill(std::shared_ptr<const WordPatternIndex> words, const int side) {
+    return run([words = std::move(words), side, stop = &stop_]() -> std::optional<CrosswordPuzzle> {
+        if (!words || words->empty()) {
+            return std::nullopt;
+        }
+        const CrosswordFiller filler(words);
+        std::mt19937 gen(std::random_device{}());
+        const auto until = std::chrono::steady_clock::now() + kFillBudget;
+        // Some templates have a slot pattern no dictionary word fits; another draw usually does.
+        for (auto now = std::chrono::steady_clock::now(); now < until && !*stop; now = std::chrono::steady_clock::now()) {
+            const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(until - now);
+            if (std::optional<CrosswordPuzzle> puzzle = filler.fill(generateBlockTemplate(side, gen), left, stop)) {
+                return puzzle;
+            }
+        }
+        return std::nullopt;
+    }, {});
+}
+
+bool CrosswordSearcher::run(std::function<std::optional<CrosswordPuzzle>()> search, std::vector<std::string> words) {
+    if (running_) {
+        return false;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    running_ = true;
+
+    QPointer<CrosswordSearcher> self(this);
+    worker_ = std::thread([self, search = std::move(search), words = std::move(words)]() {
+        std::optional<CrosswordPuzzle> puzzle = search();
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, puzzle = std::move(puzzle), words]() {
+            if (self) {
+                self->running_ = false;
+                emit self->finished(puzzle, words);
+            }
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
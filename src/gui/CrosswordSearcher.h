@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QObject>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CrosswordGenerator.h"
+#include "WordPatternIndex.h"
+
+// Runs searchCrossword, or a dense CrosswordFiller fill, on a background thread, so the window
+// stays responsive for the whole search budget. The result arrives through finished() on the GUI
+// thread; destroying the searcher stops a running search rather than waiting out its budget.
+class CrosswordSearcher : public QObject {
+    Q_OBJECT
+public:
+    explicit CrosswordSearcher(QObject* parent = nullptr);
+    ~CrosswordSearcher() override;
+
+    // False while a search is running.
+    bool start(std::vector<std::string> words);
+    // Fills a generated side x side block template from words, trying fresh templates until one
+    // fills or the budget runs out. False while a search is running.
+    bool fill(std::shared_ptr<const WordPatternIndex> words, int side);
+    [[nodiscard]] bool isRunning() const { return running_; }
+
+signals:
+    // words are the ones searched for, empty for a fill; puzzle is nullopt when none of them was
+    // usable or no template could be filled.
+    void finished(const std::optional<CrosswordPuzzle>& puzzle, const std::vector<std::string>& words);
+
+private:
+    bool run(std::function<std::optional<CrosswordPuzzle>()> search, std::vector<std::string> words);
+
+    std::thread worker_;
+    bool running_ = false;
+    std::atomic<bool> stop_{false};
+};
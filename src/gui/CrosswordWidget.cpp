@@ -4,8 +4,11 @@
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QKeyEvent>
+#include <QRegion>
 #include <QSize>
+#include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <utility>
 
 CrosswordWidget::CrosswordWidget(QWidget* parent) : QWidget(parent) {
@@ -20,6 +23,7 @@ void CrosswordWidget::setPuzzle(const CrosswordPuzzle& puzzle) {
     userInput_.clear();
     userInput_.resize(rows, std::vector<char>(cols, ' '));
     resetSelectionState();
+    rebuildEntries();
     
     if (rows > 0 && cols > 0) {
         const int width = cols * idealCellSize_;
@@ -35,6 +39,7 @@ void CrosswordWidget::clear() {
     puzzle_ = CrosswordPuzzle{};
     userInput_.clear();
     resetSelectionState();
+    rebuildEntries();
     update();
 }
 
@@ -69,27 +74,18 @@ void CrosswordWidget::mousePressEvent(QMouseEvent* event) {
     if (rows == 0 || cols == 0) return;
 
     const double cell = static_cast<double>(idealCellSize_);
-    const double totalWidth = cols * cell;
-    const double totalHeight = rows * cell;
-    double offsetX = 0.0;
-    double offsetY = 0.0;
-    if (width() > totalWidth) {
-        offsetX = (width() - totalWidth) * 0.5;
-    }
-    if (height() > totalHeight) {
-        offsetY = (height() - totalHeight) * 0.5;
-    }
-
-    const int clickCol = static_cast<int>((event->pos().x() - offsetX) / cell);
-    const int clickRow = static_cast<int>((event->pos().y() - offsetY) / cell);
+    const QPointF origin = gridOrigin();
+    const int clickCol = static_cast<int>(std::floor((event->pos().x() - origin.x()) / cell));
+    const int clickRow = static_cast<int>(std::floor((event->pos().y() - origin.y()) / cell));
 
     if (clickRow >= 0 && clickRow < rows && clickCol >= 0 && clickCol < cols) {
         if (puzzle_.grid[clickRow][clickCol] != '#') {
+            updateCell(selectedRow_, selectedCol_);
             selectedRow_ = clickRow;
             selectedCol_ = clickCol;
             entryDirection_ = EntryDir::Unset;
             setFocus();
-            update();
+            updateCell(selectedRow_, selectedCol_);
         }
     }
 }
@@ -106,6 +102,8 @@ void CrosswordWidget::keyPressEvent(QKeyEvent* event) {
         const int dc = (event->key() == Qt::Key_Left) ? -1 : (event->key() == Qt::Key_Right ? 1 : 0);
         if (dr != 0 || dc != 0) {
             entryDirection_ = (dr != 0) ? EntryDir::Down : EntryDir::Across;
+            const int fromRow = selectedRow_;
+            const int fromCol = selectedCol_;
 
             if (selectedRow_ < 0 || selectedCol_ < 0) {
                 
@@ -139,7 +137,8 @@ void CrosswordWidget::keyPressEvent(QKeyEvent* event) {
                     nc += dc;
                 }
             }
-            update();
+            updateCell(fromRow, fromCol);
+            updateCell(selectedRow_, selectedCol_);
             event->accept();
             return;
         }
@@ -149,18 +148,18 @@ void CrosswordWidget::keyPressEvent(QKeyEvent* event) {
     if (text.length() == 1) {
         const QChar ch = text.at(0);
         if (ch.isLetter() || ch == ' ') {
-            userInput_[selectedRow_][selectedCol_] = ch.toLatin1();
+            setLetter(selectedRow_, selectedCol_, ch.toLatin1());
             moveToNextCell();
-            update();
+            updateCell(selectedRow_, selectedCol_);
             event->accept();
             return;
         }
     }
 
     if (event->key() == Qt::Key_Backspace || event->key() == Qt::Key_Delete) {
-        userInput_[selectedRow_][selectedCol_] = ' ';
+        setLetter(selectedRow_, selectedCol_, ' ');
         moveToPreviousCell();
-        update();
+        updateCell(selectedRow_, selectedCol_);
         event->accept();
         return;
     }
@@ -259,78 +258,133 @@ void CrosswordWidget::resetSelectionState() {
     entryDirection_ = EntryDir::Unset;
 }
 
-std::vector<std::vector<bool>> CrosswordWidget::computeCorrectCells() const {
+bool CrosswordWidget::isCompleted() const {
+    return testMode_ && !entries_.empty() && uncoveredCells_ == 0;
+}
+
+void CrosswordWidget::rebuildEntries() {
     const int rows = static_cast<int>(puzzle_.grid.size());
     const int cols = rows == 0 ? 0 : static_cast<int>(puzzle_.grid.front().size());
-    std::vector<std::vector<bool>> correct(rows, std::vector<bool>(cols, false));
-
-    if (!testMode_ || userInput_.empty()) {
-        return correct;
-    }
+    entries_.clear();
+    cellEntries_.assign(static_cast<std::size_t>(rows * cols), {-1, -1});
+    solvedCover_.assign(static_cast<std::size_t>(rows * cols), 0);
+    uncoveredCells_ = 0;
 
     auto isBlock = [&](int r, int c) {
         return puzzle_.grid[r][c] == '#';
     };
-
-    auto markRange = [&](int r, int c, int dr, int dc) {
-        int rr = r;
-        int cc = c;
-        bool wordCorrect = true;
-        std::vector<std::pair<int, int>> cells;
-        while (rr >= 0 && rr < rows && cc >= 0 && cc < cols && !isBlock(rr, cc)) {
-            cells.emplace_back(rr, cc);
-            const char expected = static_cast<char>(std::toupper(static_cast<unsigned char>(puzzle_.grid[rr][cc])));
-            const char input = static_cast<char>(std::toupper(static_cast<unsigned char>(userInput_[rr][cc])));
-            if (input != expected) {
-                wordCorrect = false;
-            }
-            rr += dr;
-            cc += dc;
-        }
-        if (wordCorrect) {
-            for (const auto& [rCell, cCell] : cells) {
-                correct[rCell][cCell] = true;
-            }
+    auto addEntry = [&](int r, int c, int dr, int dc) {
+        Entry entry{r, c, dr, dc, 0, 0};
+        const int slot = dr == 0 ? 0 : 1;
+        for (int rr = r, cc = c; rr < rows && cc < cols && !isBlock(rr, cc); rr += dr, cc += dc) {
+            cellEntries_[static_cast<std::size_t>(rr * cols + cc)][slot] = static_cast<int>(entries_.size());
+            entry.wrong += cellMatches(rr, cc) ? 0 : 1;
+            ++entry.length;
         }
+        entries_.push_back(entry);
     };
 
-    
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
-            const bool startAcross = !isBlock(r, c) && (c == 0 || isBlock(r, c - 1)) && c + 1 < cols && !isBlock(r, c + 1);
+            if (isBlock(r, c)) {
+                continue;
+            }
+            ++uncoveredCells_;
+            const bool startAcross = (c == 0 || isBlock(r, c - 1)) && c + 1 < cols && !isBlock(r, c + 1);
             if (startAcross) {
-                markRange(r, c, 0, 1);
+                addEntry(r, c, 0, 1);
             }
-            const bool startDown = !isBlock(r, c) && (r == 0 || isBlock(r - 1, c)) && r + 1 < rows && !isBlock(r + 1, c);
+            const bool startDown = (r == 0 || isBlock(r - 1, c)) && r + 1 < rows && !isBlock(r + 1, c);
             if (startDown) {
-                markRange(r, c, 1, 0);
+                addEntry(r, c, 1, 0);
             }
         }
     }
+    for (const Entry& entry : entries_) {
+        if (entry.wrong == 0) {
+            coverEntry(entry, 1);
+        }
+    }
+}
 
-    return correct;
+void CrosswordWidget::coverEntry(const Entry& entry, const int delta) {
+    const int cols = static_cast<int>(puzzle_.grid.front().size());
+    for (int i = 0; i < entry.length; ++i) {
+        auto& cover = solvedCover_[static_cast<std::size_t>((entry.row + i * entry.dr) * cols + entry.col + i * entry.dc)];
+        if (delta > 0 && cover == 0) {
+            --uncoveredCells_;
+        }
+        cover = static_cast<std::uint8_t>(cover + delta);
+        if (delta < 0 && cover == 0) {
+            ++uncoveredCells_;
+        }
+    }
 }
 
-bool CrosswordWidget::isCompleted() const {
-    if (!testMode_ || userInput_.empty()) return false;
+void CrosswordWidget::setLetter(const int row, const int col, const char letter) {
+    const bool matched = cellMatches(row, col);
+    userInput_[row][col] = letter;
+    const bool matches = cellMatches(row, col);
+
+    // Besides the cell itself, only entries that turn solved or unsolved change colour.
+    QRegion dirty(cellRect(row, col));
+    if (matched != matches) {
+        const int cols = static_cast<int>(puzzle_.grid.front().size());
+        for (const int index : cellEntries_[static_cast<std::size_t>(row * cols + col)]) {
+            if (index < 0) {
+                continue;
+            }
+            Entry& entry = entries_[static_cast<std::size_t>(index)];
+            const bool wasSolved = entry.wrong == 0;
+            entry.wrong += matches ? -1 : 1;
+            if (wasSolved != (entry.wrong == 0)) {
+                coverEntry(entry, wasSolved ? -1 : 1);
+                dirty += entryRect(entry);
+            }
+        }
+    }
+    update(dirty);
+}
+
+bool CrosswordWidget::cellMatches(const int row, const int col) const {
+    const char expected = static_cast<char>(std::toupper(static_cast<unsigned char>(puzzle_.grid[row][col])));
+    const char input = static_cast<char>(std::toupper(static_cast<unsigned char>(userInput_[row][col])));
+    return input == expected;
+}
+
+bool CrosswordWidget::isCellCorrect(const int row, const int col) const {
+    const int cols = static_cast<int>(puzzle_.grid.front().size());
+    return testMode_ && solvedCover_[static_cast<std::size_t>(row * cols + col)] > 0;
+}
 
-    const auto correct = computeCorrectCells();
+QPointF CrosswordWidget::gridOrigin() const {
     const int rows = static_cast<int>(puzzle_.grid.size());
     const int cols = rows == 0 ? 0 : static_cast<int>(puzzle_.grid.front().size());
+    const double cell = static_cast<double>(idealCellSize_);
+    return {std::max(0.0, (width() - cols * cell) * 0.5), std::max(0.0, (height() - rows * cell) * 0.5)};
+}
 
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            if (puzzle_.grid[r][c] != '#' && (r >= static_cast<int>(correct.size()) || c >= static_cast<int>(correct[r].size()) || !correct[r][c])) {
-                return false;
-            }
-        }
+QRect CrosswordWidget::cellRect(const int row, const int col) const {
+    const double cell = static_cast<double>(idealCellSize_);
+    const QPointF origin = gridOrigin();
+    // A pixel of slack keeps the shared cell borders in the repainted area.
+    return QRectF(origin.x() + col * cell, origin.y() + row * cell, cell, cell).toAlignedRect().adjusted(-1, -1, 1, 1);
+}
+
+QRect CrosswordWidget::entryRect(const Entry& entry) const {
+    const int last = entry.length - 1;
+    return cellRect(entry.row, entry.col).united(cellRect(entry.row + last * entry.dr, entry.col + last * entry.dc));
+}
+
+void CrosswordWidget::updateCell(const int row, const int col) {
+    if (canMoveTo(row, col)) {
+        update(cellRect(row, col));
     }
-    return true;
 }
 
-void CrosswordWidget::paintEvent(QPaintEvent* ) {
+void CrosswordWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
-    painter.fillRect(rect(), backgroundColor_);
+    painter.fillRect(event->rect(), backgroundColor_);
 
     const int rows = static_cast<int>(puzzle_.grid.size());
     const int cols = rows == 0 ? 0 : static_cast<int>(puzzle_.grid.front().size());
@@ -341,36 +395,25 @@ void CrosswordWidget::paintEvent(QPaintEvent* ) {
     }
 
     const double cell = static_cast<double>(idealCellSize_);
-    
-    const double totalWidth = cols * cell;
-    const double totalHeight = rows * cell;
-    double offsetX = 0.0;
-    double offsetY = 0.0;
-    if (width() > totalWidth) {
-        offsetX = (width() - totalWidth) * 0.5;
-    }
-    if (height() > totalHeight) {
-        offsetY = (height() - totalHeight) * 0.5;
-    }
+    const QPointF origin = gridOrigin();
+    const double offsetX = origin.x();
+    const double offsetY = origin.y();
 
     QFont numFont = painter.font();
     numFont.setPointSizeF(std::max(6.0, cell * 0.28));
     QFont letterFont = painter.font();
     letterFont.setPointSizeF(std::max(10.0, cell * 0.55));
 
-    const auto correctCells = testMode_ ? computeCorrectCells() : std::vector<std::vector<bool>>{};
-
+    // Only the cells in the exposed region are drawn; a keystroke exposes a few cells, or the
+    // entries it solved or unsolved.
+    const QRegion& exposed = event->region();
     for (int r = 0; r < rows; ++r) {
         for (int c = 0; c < cols; ++c) {
             const char ch = puzzle_.grid[r][c];
-            if (ch != '#') {
+            if (ch != '#' && exposed.intersects(cellRect(r, c))) {
                 const QRectF tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
-                
-                const bool correct = r < static_cast<int>(correctCells.size()) &&
-                                     c < static_cast<int>(correctCells[r].size()) &&
-                                     correctCells[r][c];
 
-                if (correct) {
+                if (isCellCorrect(r, c)) {
                     painter.fillRect(tile, QColor(144, 238, 144));
                 } else if (testMode_ && r == selectedRow_ && c == selectedCol_) {
                     painter.fillRect(tile, QColor(200, 220, 255));
@@ -2,7 +2,12 @@
 
 #include <QWidget>
 #include <QColor>
+#include <QPointF>
+#include <QRect>
+#include <array>
+#include <cstdint>
 #include <utility>
+#include <vector>
 
 #include "CrosswordGenerator.h"
 
@@ -33,6 +38,23 @@ private:
     QColor backgroundColor_{Qt::white};
     enum class EntryDir { Unset, Across, Down };
     EntryDir entryDirection_ = EntryDir::Unset;
+    // Across and down entries (runs of two or more open cells) with the number of their cells
+    // whose input is still wrong, and the entries through each cell (-1 for none), row-major.
+    // A cell shows as correct while one of its entries is all correct; solvedCover_ counts those
+    // entries per cell. A keystroke touches at most the two entries through the cell.
+    struct Entry {
+        int row = 0;
+        int col = 0;
+        int dr = 0;
+        int dc = 0;
+        int length = 0;
+        int wrong = 0;
+    };
+    std::vector<Entry> entries_;
+    std::vector<std::array<int, 2>> cellEntries_;
+    std::vector<std::uint8_t> solvedCover_;
+    // Open cells not covered by a solved entry; the puzzle is complete at zero.
+    int uncoveredCells_ = 0;
     
     bool canMoveRight(int row, int col) const;
     bool canMoveDown(int row, int col) const;
@@ -42,6 +64,14 @@ private:
     void moveToPreviousCell();
     void setDirectionIfUnset();
     void resetSelectionState();
-    std::vector<std::vector<bool>> computeCorrectCells() const;
     bool isCompleted() const;
+    void rebuildEntries();
+    void coverEntry(const Entry& entry, int delta);
+    void setLetter(int row, int col, char letter);
+    bool cellMatches(int row, int col) const;
+    bool isCellCorrect(int row, int col) const;
+    QPointF gridOrigin() const;
+    QRect cellRect(int row, int col) const;
+    QRect entryRect(const Entry& entry) const;
+    void updateCell(int row, int col);
 };
@@ -0,0 +1,88 @@
+#include "DictionaryLoader.h"
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QFile>
+#include <QMetaObject>
+#include <QPointer>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#include "WordDictionary.h"
+
+namespace {
+// Keeps a compiled dictionary mapped for as long as anything uses it.
+struct MappedFile {
+    QFile file;
+    uchar* data = nullptr;
+
+    ~MappedFile() {
+        if (data) {
+            file.unmap(data);
+        }
+    }
+};
+
+std::optional<WordDictionary> mapCompiled(const QString& path) {
+    auto mapped = std::make_shared<MappedFile>();
+    mapped->file.setFileName(path);
+    if (!mapped->file.open(QIODevice::ReadOnly) || mapped->file.size() <= 0) {
+        return std::nullopt;
+    }
+    mapped->data = mapped->file.map(0, mapped->file.size());
+    if (!mapped->data) {
+        return std::nullopt;
+    }
+    const std::span<const std::uint8_t> bytes(mapped->data, static_cast<std::size_t>(mapped->file.size()));
+    return WordDictionary::open(bytes, mapped);
+}
+
+WordDictionary compileList(const QString& path) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {};
+    }
+    const qint64 size = file.size();
+    if (uchar* data = size > 0 ? file.map(0, size) : nullptr) {
+        WordDictionary dictionary = WordDictionary::fromText(
+            std::string_view(reinterpret_cast<const char*>(data), static_cast<std::size_t>(size)));
+        file.unmap(data);
+        return dictionary;
+    }
+    const QByteArray text = file.readAll();
+    return WordDictionary::fromText(std::string_view(text.constData(), static_cast<std::size_t>(text.size())));
+}
+}
+
+DictionaryLoader::DictionaryLoader(QObject* parent) : QObject(parent) {}
+
+DictionaryLoader::~DictionaryLoader() {
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+}
+
+bool DictionaryLoader::start(const QString& compiledPath, const QString& listPath) {
+    if (running_) {
+        return false;
+    }
+    if (worker_.joinable()) {
+        worker_.join();
+    }
+    running_ = true;
+
+    QPointer<DictionaryLoader> self(this);
+    worker_ = std::thread([self, compiledPath, listPath]() {
+        std::optional<WordDictionary> compiled = mapCompiled(compiledPath);
+        const bool mapped = compiled.has_value();
+        auto words = std::make_shared<const WordPatternIndex>(mapped ? std::move(*compiled) : compileList(listPath));
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, words, mapped]() {
+            if (self) {
+                self->running_ = false;
+                emit self->finished(words, mapped);
+            }
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <memory>
+#include <thread>
+
+#include "WordPatternIndex.h"
+
+// Loads the word dictionary on a background thread, so the window never waits for it. The compiled
+// dictionary (see tools/build_dictionary.cpp) is memory-mapped and stays mapped as the store of
+// the words; when it is missing or invalid the plain word list is compiled in memory instead.
+// Either way the index for word search and the crossword filler is built on the same thread and
+// holds only bitsets over the dictionary's words by rank.
+class DictionaryLoader : public QObject {
+    Q_OBJECT
+public:
+    explicit DictionaryLoader(QObject* parent = nullptr);
+    ~DictionaryLoader() override;
+
+    // False while a load is running.
+    bool start(const QString& compiledPath, const QString& listPath);
+    [[nodiscard]] bool isRunning() const { return running_; }
+
+signals:
+    // words is empty when neither file could be read; mapped says which one was used.
+    void finished(const std::shared_ptr<const WordPatternIndex>& words, bool mapped);
+
+private:
+    std::thread worker_;
+    bool running_ = false;
+};
@@ -0,0 +1,97 @@
+#include "MazeMipmap.h"
+
+#include <algorithm>
+
+namespace {
+constexpr uchar kWall = 255;
+
+void carveBorderGap(QImage& image, const MazeWalls& walls, const std::pair<int, int> cell) {
+    const auto [row, col] = cell;
+    if (row < 0 || col < 0 || row >= walls.rows || col >= walls.cols) return;
+    if (row == 0) {
+        image.scanLine(0)[2 * col + 1] = 0;
+    } else if (row == walls.rows - 1) {
+        image.scanLine(2 * walls.rows)[2 * col + 1] = 0;
+    } else if (col == 0) {
+        image.scanLine(2 * row + 1)[0] = 0;
+    } else if (col == walls.cols - 1) {
+        image.scanLine(2 * row + 1)[2 * walls.cols] = 0;
+    }
+}
+}
+
+QImage makeMazeMipmapBase(const MazeWalls& walls, const std::pair<int, int> entranceCell, const std::pair<int, int> exitCell) {
+    if (walls.rows <= 0 || walls.cols <= 0) {
+        return {};
+    }
+    const int width = 2 * walls.cols + 1;
+    const int height = 2 * walls.rows + 1;
+    QImage image(width, height, QImage::Format_Indexed8);
+    image.setColorCount(256);
+    image.fill(0);
+
+    for (int c = 0; c < walls.cols; ++c) {
+        image.scanLine(0)[2 * c + 1] = kWall;
+    }
+    for (int r = 0; r < walls.rows; ++r) {
+        uchar* cellLine = image.scanLine(2 * r + 1);
+        uchar* wallLine = image.scanLine(2 * r + 2);
+        cellLine[0] = kWall;
+        for (int c = 0; c < walls.cols; ++c) {
+            if (walls.eastClosed(r, c)) cellLine[2 * c + 2] = kWall;
+            if (walls.southClosed(r, c)) wallLine[2 * c + 1] = kWall;
+        }
+    }
+
+    // Posts only where at least one wall meets them, so open areas downsample to the background.
+    for (int y = 0; y < height; y += 2) {
+        uchar* line = image.scanLine(y);
+        const uchar* above = y > 0 ? image.constScanLine(y - 1) : nullptr;
+        const uchar* below = y + 1 < height ? image.constScanLine(y + 1) : nullptr;
+        for (int x = 0; x < width; x += 2) {
+            const bool joined = (x > 0 && line[x - 1]) || (x + 1 < width && line[x + 1]) ||
+                                (above && above[x]) || (below && below[x]);
+            line[x] = joined ? kWall : 0;
+        }
+    }
+
+    carveBorderGap(image, walls, entranceCell);
+    carveBorderGap(image, walls, exitCell);
+    return image;
+}
+
+QImage downsampleMazeMipmap(const QImage& level) {
+    if (level.isNull() || (level.width() <= 1 && level.height() <= 1)) {
+        return {};
+    }
+    const int width = (level.width() + 1) / 2;
+    const int height = (level.height() + 1) / 2;
+    QImage out(width, height, QImage::Format_Indexed8);
+    out.setColorTable(level.colorTable());
+
+    for (int y = 0; y < height; ++y) {
+        const uchar* top = level.constScanLine(2 * y);
+        const uchar* bottom = level.constScanLine(std::min(2 * y + 1, level.height() - 1));
+        uchar* dst = out.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            const int x0 = 2 * x;
+            const int x1 = std::min(x0 + 1, level.width() - 1);
+            const int sum = top[x0] + top[x1] + bottom[x0] + bottom[x1];
+            dst[x] = static_cast<uchar>((sum + 2) / 4);
+        }
+    }
+    return out;
+}
+
+QVector<QRgb> mazeMipmapColorTable(const QColor& walls, const QColor& background) {
+    QVector<QRgb> table(256);
+    for (int i = 0; i < 256; ++i) {
+        const auto mix = [i](const int bg, const int wall) {
+            return (bg * (255 - i) + wall * i + 127) / 255;
+        };
+        table[i] = qRgb(mix(background.red(), walls.red()),
+                        mix(background.green(), walls.green()),
+                        mix(background.blue(), walls.blue()));
+    }
+    return table;
+}
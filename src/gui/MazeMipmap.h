@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QColor>
+#include <QImage>
+#include <QVector>
+#include <QRgb>
+#include <utility>
+
+#include "maze_walls.h"
+
+// Level 0 spends two pixels per cell (cell + shared wall); every further level halves both axes.
+constexpr double kMazeMipmapBaseCellPx = 2.0;
+
+QImage makeMazeMipmapBase(const MazeWalls& walls, std::pair<int, int> entranceCell, std::pair<int, int> exitCell);
+QImage downsampleMazeMipmap(const QImage& level);
+QVector<QRgb> mazeMipmapColorTable(const QColor& walls, const QColor& background);
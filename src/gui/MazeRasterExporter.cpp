@@ -0,0 +1,405 @@
+#include "MazeRasterExporter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "Crc32.h"
+
+namespace {
+constexpr int kBandRows = 256;
+
+struct RasterGeometry {
+    int width = 0;
+    int height = 0;
+    int rowBytes = 0;
+    int cell = 0;
+    int lineWidth = 0;
+};
+
+void setSpan(std::uint8_t* row, const int width, int x0, int x1) {
+    x0 = std::max(0, x0);
+    x1 = std::min(width, x1);
+    if (x0 >= x1) return;
+    int first = x0 >> 3;
+    const int last = (x1 - 1) >> 3;
+    const auto headMask = static_cast<std::uint8_t>(0xffu >> (x0 & 7));
+    const auto tailMask = static_cast<std::uint8_t>(0xffu << (7 - ((x1 - 1) & 7)));
+    if (first == last) {
+        row[first] |= static_cast<std::uint8_t>(headMask & tailMask);
+        return;
+    }
+    row[first++] |= headMask;
+    if (last > first) {
+        std::memset(row + first, 0xff, static_cast<std::size_t>(last - first));
+    }
+    row[last] |= tailMask;
+}
+
+void clearSpan(std::uint8_t* row, const int width, int x0, int x1) {
+    x0 = std::max(0, x0);
+    x1 = std::min(width, x1);
+    for (int x = x0; x < x1; ++x) {
+        row[x >> 3] &= static_cast<std::uint8_t>(~(0x80u >> (x & 7)));
+    }
+}
+
+struct GapRect {
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+};
+
+std::vector<GapRect> gapRects(const MazeWalls& walls, const RasterGeometry& geo, const MazeRasterStyle& style) {
+    std::vector<GapRect> gaps;
+    const int cell = geo.cell;
+    const int lw = geo.lineWidth;
+    const int outer = lw * 2;
+    const int gapW = std::max(lw, cell - lw * 2);
+    for (const auto& [row, col] : {style.entranceCell, style.exitCell}) {
+        if (row < 0 || col < 0 || row >= walls.rows || col >= walls.cols) continue;
+        const int x = col * cell;
+        const int y = row * cell;
+        if (row == 0) {
+            gaps.push_back({x + (cell - gapW) / 2, y - outer, x + (cell - gapW) / 2 + gapW, y + outer});
+        } else if (row == walls.rows - 1) {
+            gaps.push_back({x + (cell - gapW) / 2, y + cell - outer, x + (cell - gapW) / 2 + gapW, y + cell + outer});
+        } else if (col == 0) {
+            gaps.push_back({x - outer, y + (cell - gapW) / 2, x + outer, y + (cell - gapW) / 2 + gapW});
+        } else if (col == walls.cols - 1) {
+            gaps.push_back({x + cell - outer, y + (cell - gapW) / 2, x + cell + outer, y + (cell - gapW) / 2 + gapW});
+        }
+    }
+    return gaps;
+}
+
+std::vector<std::uint8_t> renderBand(const MazeWalls& walls,
+                                     const RasterGeometry& geo,
+                                     const std::vector<GapRect>& gaps,
+                                     const int y0,
+                                     const int y1) {
+    const int rowBytes = geo.rowBytes;
+    const int cell = geo.cell;
+    const int lw = geo.lineWidth;
+    const int half = lw / 2;
+    std::vector<std::uint8_t> band(static_cast<std::size_t>(y1 - y0) * rowBytes, 0);
+    std::vector<std::uint8_t> verticals(static_cast<std::size_t>(rowBytes), 0);
+    int verticalsRow = -1;
+
+    for (int y = y0; y < y1; ++y) {
+        std::uint8_t* out = band.data() + static_cast<std::size_t>(y - y0) * rowBytes;
+
+        const int cellRow = std::min(y / cell, walls.rows - 1);
+        if (cellRow != verticalsRow) {
+            std::fill(verticals.begin(), verticals.end(), std::uint8_t{0});
+            for (int c = 0; c + 1 < walls.cols; ++c) {
+                if (walls.eastClosed(cellRow, c)) {
+                    const int x = (c + 1) * cell;
+                    setSpan(verticals.data(), geo.width, x - half, x - half + lw);
+                }
+            }
+            setSpan(verticals.data(), geo.width, 0, lw - half);
+            setSpan(verticals.data(), geo.width, geo.width - half, geo.width);
+            verticalsRow = cellRow;
+        }
+        std::memcpy(out, verticals.data(), static_cast<std::size_t>(rowBytes));
+
+        if (y < lw - half || y >= geo.height - half) {
+            setSpan(out, geo.width, 0, geo.width);
+        }
+        for (int k = (y + half) / cell; k >= 1 && k * cell - half + lw > y; --k) {
+            if (k >= walls.rows || y < k * cell - half) continue;
+            const int r = k - 1;
+            int c = 0;
+            while (c < walls.cols) {
+                if (!walls.southClosed(r, c)) {
+                    ++c;
+                    continue;
+                }
+                const int start = c;
+                while (c < walls.cols && walls.southClosed(r, c)) ++c;
+                setSpan(out, geo.width, start * cell, c * cell);
+            }
+        }
+
+        for (const auto& gap : gaps) {
+            if (y >= gap.y0 && y < gap.y1) {
+                clearSpan(out, geo.width, gap.x0, gap.x1);
+            }
+        }
+    }
+    return band;
+}
+
+void putBigEndian(std::vector<std::uint8_t>& out, const std::uint32_t value) {
+    out.push_back(static_cast<std::uint8_t>(value >> 24));
+    out.push_back(static_cast<std::uint8_t>(value >> 16));
+    out.push_back(static_cast<std::uint8_t>(value >> 8));
+    out.push_back(static_cast<std::uint8_t>(value));
+}
+
+void writeChunk(std::ofstream& file, const char* type, const std::vector<std::uint8_t>& payload) {
+    std::vector<std::uint8_t> header;
+    putBigEndian(header, static_cast<std::uint32_t>(payload.size()));
+    header.insert(header.end(), type, type + 4);
+    file.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+    file.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    std::uint32_t crc = crc32Update(0, reinterpret_cast<const std::uint8_t*>(type), 4);
+    crc = crc32Update(crc, payload.data(), payload.size());
+    std::vector<std::uint8_t> trailer;
+    putBigEndian(trailer, crc);
+    file.write(reinterpret_cast<const char*>(trailer.data()), 4);
+}
+
+// Single fixed-Huffman deflate stream. Rows are matched against a run of the previous byte or
+// against the same position one scanline up, which is where almost all redundancy in a maze lies.
+class PngRowCompressor {
+public:
+    PngRowCompressor(std::ofstream& file, const int rowBytes)
+        : file_(file), stride_(rowBytes + 1), window_(static_cast<std::size_t>(stride_) * 2, 0) {
+        out_.push_back(0x78);
+        out_.push_back(0x01);
+        putBits(0, 1);
+        putBits(1, 2);
+    }
+
+    void addRow(const std::uint8_t* row) {
+        std::uint8_t* current = window_.data() + stride_;
+        current[0] = 0;
+        std::memcpy(current + 1, row, static_cast<std::size_t>(stride_ - 1));
+        updateAdler(current, static_cast<std::size_t>(stride_));
+
+        int i = 0;
+        while (i < stride_) {
+            const int remaining = std::min(258, stride_ - i);
+            int runLength = 0;
+            if (havePrevious_ || i > 0) {
+                const std::uint8_t prev = current[i - 1];
+                while (runLength < remaining && current[i + runLength] == prev) ++runLength;
+            }
+            int upLength = 0;
+            if (havePrevious_ && stride_ <= 32768) {
+                const std::uint8_t* up = current - stride_;
+                while (upLength < remaining && current[i + upLength] == up[i + upLength]) ++upLength;
+            }
+            if (std::max(runLength, upLength) >= 3) {
+                const bool useRun = runLength >= upLength;
+                const int length = useRun ? runLength : upLength;
+                putMatch(length, useRun ? 1 : stride_);
+                i += length;
+            } else {
+                putLiteral(current[i]);
+                ++i;
+            }
+        }
+        std::memcpy(window_.data(), current, static_cast<std::size_t>(stride_));
+        havePrevious_ = true;
+        flushChunks(false);
+    }
+
+    void finish() {
+        putSymbol(256);
+        putBits(1, 1);
+        putBits(1, 2);
+        putSymbol(256);
+        if (bitCount_ > 0) {
+            out_.push_back(static_cast<std::uint8_t>(bitBuffer_));
+            bitBuffer_ = 0;
+            bitCount_ = 0;
+        }
+        putBigEndian(out_, (adlerB_ << 16) | adlerA_);
+        flushChunks(true);
+    }
+
+private:
+    std::ofstream& file_;
+    int stride_;
+    std::vector<std::uint8_t> window_;
+    bool havePrevious_ = false;
+    std::vector<std::uint8_t> out_;
+    std::uint32_t bitBuffer_ = 0;
+    int bitCount_ = 0;
+    std::uint32_t adlerA_ = 1;
+    std::uint32_t adlerB_ = 0;
+
+    void updateAdler(const std::uint8_t* data, const std::size_t size) {
+        for (std::size_t i = 0; i < size; ++i) {
+            adlerA_ = (adlerA_ + data[i]) % 65521u;
+            adlerB_ = (adlerB_ + adlerA_) % 65521u;
+        }
+    }
+
+    void putBits(const std::uint32_t value, const int count) {
+        bitBuffer_ |= value << bitCount_;
+        bitCount_ += count;
+        while (bitCount_ >= 8) {
+            out_.push_back(static_cast<std::uint8_t>(bitBuffer_));
+            bitBuffer_ >>= 8;
+            bitCount_ -= 8;
+        }
+    }
+
+    void putCode(const std::uint32_t code, const int length) {
+        std::uint32_t reversed = 0;
+        for (int i = 0; i < length; ++i) {
+            reversed |= ((code >> i) & 1u) << (length - 1 - i);
+        }
+        putBits(reversed, length);
+    }
+
+    void putSymbol(const int symbol) {
+        if (symbol < 144) {
+            putCode(0x30u + static_cast<std::uint32_t>(symbol), 8);
+        } else if (symbol < 256) {
+            putCode(0x190u + static_cast<std::uint32_t>(symbol - 144), 9);
+        } else if (symbol < 280) {
+            putCode(static_cast<std::uint32_t>(symbol - 256), 7);
+        } else {
+            putCode(0xc0u + static_cast<std::uint32_t>(symbol - 280), 8);
+        }
+    }
+
+    void putLiteral(const std::uint8_t value) {
+        putSymbol(value);
+    }
+
+    void putMatch(const int length, const int distance) {
+        static constexpr std::array<int, 29> lengthBase = {
+            3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+            35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static constexpr std::array<int, 29> lengthExtra = {
+            0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+            3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        static constexpr std::array<int, 30> distBase = {
+            1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+            257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+        static constexpr std::array<int, 30> distExtra = {
+            0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+            7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+        int li = 28;
+        while (lengthBase[li] > length) --li;
+        putSymbol(257 + li);
+        if (lengthExtra[li] > 0) {
+            putBits(static_cast<std::uint32_t>(length - lengthBase[li]), lengthExtra[li]);
+        }
+        int di = 29;
+        while (distBase[di] > distance) --di;
+        putCode(static_cast<std::uint32_t>(di), 5);
+        if (distExtra[di] > 0) {
+            putBits(static_cast<std::uint32_t>(distance - distBase[di]), distExtra[di]);
+        }
+    }
+
+    void flushChunks(const bool all) {
+        constexpr std::size_t chunkSize = 1 << 16;
+        if (!all && out_.size() < chunkSize) return;
+        writeChunk(file_, "IDAT", out_);
+        out_.clear();
+    }
+};
+
+std::vector<std::uint8_t> pngHeader(const RasterGeometry& geo) {
+    std::vector<std::uint8_t> ihdr;
+    putBigEndian(ihdr, static_cast<std::uint32_t>(geo.width));
+    putBigEndian(ihdr, static_cast<std::uint32_t>(geo.height));
+    ihdr.push_back(1);
+    ihdr.push_back(3);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    ihdr.push_back(0);
+    return ihdr;
+}
+
+std::vector<std::uint8_t> pngPalette(const MazeRasterStyle& style) {
+    std::vector<std::uint8_t> plte;
+    for (const std::uint32_t rgb : {style.backgroundRgb, style.wallRgb}) {
+        plte.push_back(static_cast<std::uint8_t>(rgb >> 16));
+        plte.push_back(static_cast<std::uint8_t>(rgb >> 8));
+        plte.push_back(static_cast<std::uint8_t>(rgb));
+    }
+    return plte;
+}
+}
+
+bool exportMazeRaster(const MazeWalls& walls,
+                      const MazeRasterStyle& style,
+                      const MazeRasterFormat format,
+                      const std::string& path) {
+    if (walls.rows <= 0 || walls.cols <= 0 || style.cellPx <= 0) {
+        return false;
+    }
+    RasterGeometry geo;
+    geo.cell = style.cellPx;
+    geo.lineWidth = std::max(2, geo.cell / 8);
+    const long long width = static_cast<long long>(walls.cols) * geo.cell;
+    const long long height = static_cast<long long>(walls.rows) * geo.cell;
+    if (width > 0x7fffffffLL || height > 0x7fffffffLL) {
+        return false;
+    }
+    geo.width = static_cast<int>(width);
+    geo.height = static_cast<int>(height);
+    geo.rowBytes = (geo.width + 7) / 8;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::optional<PngRowCompressor> compressor;
+    if (format == MazeRasterFormat::Png) {
+        static constexpr std::array<std::uint8_t, 8> signature = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+        file.write(reinterpret_cast<const char*>(signature.data()), signature.size());
+        writeChunk(file, "IHDR", pngHeader(geo));
+        writeChunk(file, "PLTE", pngPalette(style));
+        compressor.emplace(file, geo.rowBytes);
+    } else {
+        file << "P4\n" << geo.width << ' ' << geo.height << '\n';
+    }
+
+    const std::vector<GapRect> gaps = gapRects(walls, geo, style);
+    const int workers = std::max(1u, std::thread::hardware_concurrency());
+    std::deque<std::future<std::vector<std::uint8_t>>> pending;
+    int nextBand = 0;
+    auto launch = [&]() {
+        const int y0 = nextBand;
+        const int y1 = std::min(geo.height, y0 + kBandRows);
+        pending.push_back(std::async(std::launch::async, [&walls, &geo, &gaps, y0, y1]() {
+            return renderBand(walls, geo, gaps, y0, y1);
+        }));
+        nextBand = y1;
+    };
+
+    while (nextBand < geo.height || !pending.empty()) {
+        while (nextBand < geo.height && static_cast<int>(pending.size()) < workers * 2) {
+            launch();
+        }
+        const std::vector<std::uint8_t> band = pending.front().get();
+        pending.pop_front();
+        if (compressor) {
+            for (std::size_t offset = 0; offset < band.size(); offset += static_cast<std::size_t>(geo.rowBytes)) {
+                compressor->addRow(band.data() + offset);
+            }
+        } else {
+            file.write(reinterpret_cast<const char*>(band.data()), static_cast<std::streamsize>(band.size()));
+        }
+        if (!file) {
+            for (auto& job : pending) job.wait();
+            return false;
+        }
+    }
+
+    if (compressor) {
+        compressor->finish();
+        writeChunk(file, "IEND", {});
+    }
+    file.flush();
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "maze_walls.h"
+
+enum class MazeRasterFormat { Png, Pbm };
+
+struct MazeRasterStyle {
+    int cellPx = 10;
+    std::uint32_t wallRgb = 0x1e1e1e;
+    std::uint32_t backgroundRgb = 0xffffff;
+    std::pair<int, int> entranceCell{-1, -1};
+    std::pair<int, int> exitCell{-1, -1};
+};
+
+// Rasterizes the maze in horizontal bands straight from the wall bitsets and streams them to disk,
+// so memory stays bounded by a handful of bands regardless of the image size.
+bool exportMazeRaster(const MazeWalls& walls,
+                      const MazeRasterStyle& style,
+                      MazeRasterFormat format,
+                      const std::string& path);
@@ -1,19 +1,26 @@
 #include "MazeWidget.h"
+#include "MazeMipmap.h"
 #include <QColor>
+#include <QCoreApplication>
 #include <QElapsedTimer>
 #include <QKeyEvent>
 #include <QMouseEvent>
 #include <QPaintEvent>
 #include <QPainter>
+#include <QPointer>
 #include <QScrollArea>
 #include <QScrollBar>
+#include <QShowEvent>
+#include <QThreadPool>
 #include <QWheelEvent>
 #include <QSizePolicy>
 #include <algorithm>
 #include <cmath>
-#include <unordered_set>
 
 namespace {
+constexpr double kMinOverviewCellPx = 1.0 / 16.0;
+constexpr double kOverviewZoomStep = 0.8;
+
 std::pair<int, int> nodeRowCol(const MazeGraph& g, const int nodeId) {
     if (nodeId < 0 || nodeId >= static_cast<int>(g.nodes.size())) return {-1, -1};
     const auto& n = g.nodes[nodeId];
@@ -25,6 +32,7 @@ std::pair<int, int> nodeRowCol(const MazeGraph& g, const int nodeId) {
 MazeWidget::MazeWidget(QWidget* parent) : QWidget(parent) {
     setFocusPolicy(Qt::StrongFocus);
     setMinimumSize(420, 420);
+    mipColorTable_ = mazeMipmapColorTable(wallColor_, backgroundColor_);
 
     animationTimer_ = new QTimer(this);
     animationTimer_->setInterval(16);
@@ -32,6 +40,10 @@ MazeWidget::MazeWidget(QWidget* parent) : QWidget(parent) {
     connect(animationTimer_, &QTimer::timeout, this, &MazeWidget::updateAnimation);
 }
 
+MazeWidget::~MazeWidget() {
+    ++*mipmapTicket_;
+}
+
 void MazeWidget::setGraph(const MazeGraph& graph,
                           const bool tested,
                           const bool showMarkers,
@@ -39,6 +51,7 @@ void MazeWidget::setGraph(const MazeGraph& graph,
                           const int exitNode,
                           const int playerNode) {
     graph_ = graph;
+    walls_ = make_maze_walls(graph_);
     tested_ = tested;
     showMarkers_ = showMarkers;
     entranceNode_ = entranceNode;
@@ -49,6 +62,7 @@ void MazeWidget::setGraph(const MazeGraph& graph,
     playerRow_ = targetRow_ = pr >= 0 ? pr : 0;
     playerCol_ = targetCol_ = pc >= 0 ? pc : 0;
 
+    rebuildMipmap();
     applySizeFromGraph();
     update();
 }
@@ -56,46 +70,89 @@ void MazeWidget::setGraph(const MazeGraph& graph,
 void MazeWidget::setColors(const QColor& walls, const QColor& background) {
     wallColor_ = walls;
     backgroundColor_ = background;
+    mipColorTable_ = mazeMipmapColorTable(wallColor_, backgroundColor_);
+    for (auto& level : mipLevels_) {
+        level.setColorTable(mipColorTable_);
+    }
     update();
 }
 
+void MazeWidget::rebuildMipmap() {
+    const quint64 ticket = ++*mipmapTicket_;
+    mipLevels_.clear();
+    // Widgets made only to render an export or a printout are never shown, so they never pay
+    // for the pyramid; a hidden widget builds it when it is first shown.
+    mipmapPending_ = !isVisible();
+    if (mipmapPending_ || walls_.rows <= 0 || walls_.cols <= 0) {
+        return;
+    }
+
+    QPointer<MazeWidget> self(this);
+    std::shared_ptr<std::atomic<quint64>> current = mipmapTicket_;
+    QThreadPool::globalInstance()->start([self, current, ticket, walls = walls_,
+                                          entrance = nodeRowCol(graph_, entranceNode_),
+                                          exitCell = nodeRowCol(graph_, exitNode_)]() {
+        QImage level = makeMazeMipmapBase(walls, entrance, exitCell);
+        double levelCellPx = kMazeMipmapBaseCellPx;
+        while (!level.isNull() && current->load() == ticket) {
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, ticket, level]() {
+                if (!self || self->mipmapTicket_->load() != ticket) return;
+                self->mipLevels_.push_back(level);
+                self->mipLevels_.back().setColorTable(self->mipColorTable_);
+                if (self->inOverview()) self->update();
+            }, Qt::QueuedConnection);
+            if (levelCellPx <= kMinOverviewCellPx) break;
+            level = downsampleMazeMipmap(level);
+            levelCellPx /= 2.0;
+        }
+    });
+}
+
+void MazeWidget::showEvent(QShowEvent* event) {
+    QWidget::showEvent(event);
+    if (mipmapPending_) {
+        rebuildMipmap();
+    }
+}
+
 QRect MazeWidget::cellRect(const int row, const int col) const {
     if (graph_.rows <= 0 || graph_.cols <= 0) return {};
     if (row < 0 || col < 0 || row >= graph_.rows || col >= graph_.cols) return {};
 
-    const int cell = cellSizePx();
-    const int mazeWidth = graph_.cols * cell;
-    const int mazeHeight = graph_.rows * cell;
-    const int offsetX = std::max(0, (width() - mazeWidth) / 2);
-    const int offsetY = std::max(0, (height() - mazeHeight) / 2);
-    return QRect(offsetX + col * cell, offsetY + row * cell, cell, cell);
+    const double cell = cellScale_;
+    const double mazeWidth = graph_.cols * cell;
+    const double mazeHeight = graph_.rows * cell;
+    const double offsetX = std::max(0.0, std::floor((width() - mazeWidth) / 2.0));
+    const double offsetY = std::max(0.0, std::floor((height() - mazeHeight) / 2.0));
+    return QRectF(offsetX + col * cell, offsetY + row * cell, cell, cell).toAlignedRect();
 }
 
 QPointF MazeWidget::cellCenter(const double row, const double col) const {
     if (graph_.rows <= 0 || graph_.cols <= 0) return {};
     if (row < 0.0 || col < 0.0 || row >= static_cast<double>(graph_.rows) || col >= static_cast<double>(graph_.cols)) return {};
 
-    const int cell = cellSizePx();
-    const int mazeWidth = graph_.cols * cell;
-    const int mazeHeight = graph_.rows * cell;
-    const int offsetX = std::max(0, (width() - mazeWidth) / 2);
-    const int offsetY = std::max(0, (height() - mazeHeight) / 2);
+    const double cell = cellScale_;
+    const double mazeWidth = graph_.cols * cell;
+    const double mazeHeight = graph_.rows * cell;
+    const double offsetX = std::max(0.0, std::floor((width() - mazeWidth) / 2.0));
+    const double offsetY = std::max(0.0, std::floor((height() - mazeHeight) / 2.0));
     return QPointF(offsetX + (col + 0.5) * cell, offsetY + (row + 0.5) * cell);
 }
 
 QSize MazeWidget::sizeHint() const {
     if (graph_.rows > 0 && graph_.cols > 0) {
-        const int cell = cellSizePx();
-        return {graph_.cols * cell, graph_.rows * cell};
+        return {std::max(1, static_cast<int>(std::ceil(graph_.cols * cellScale_))),
+                std::max(1, static_cast<int>(std::ceil(graph_.rows * cellScale_)))};
     }
     constexpr int defaultCells = 20;
     const int cell = cellSizePx();
     return {defaultCells * cell, defaultCells * cell};
 }
 
-void MazeWidget::paintEvent(QPaintEvent* ) {
+void MazeWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
-    painter.fillRect(rect(), backgroundColor_);
+    const QRect dirty = event->rect();
+    painter.fillRect(dirty, backgroundColor_);
     painter.setRenderHint(QPainter::Antialiasing, false);
 
     if (graph_.nodes.empty()) {
@@ -104,122 +161,89 @@ void MazeWidget::paintEvent(QPaintEvent* ) {
         return;
     }
 
+    const double cell = cellScale_;
+    const double mazeWidth = graph_.cols * cell;
+    const double mazeHeight = graph_.rows * cell;
+    const double offsetX = std::max(0.0, std::floor((width() - mazeWidth) / 2.0));
+    const double offsetY = std::max(0.0, std::floor((height() - mazeHeight) / 2.0));
+
+    if (inOverview()) {
+        paintOverview(painter, dirty, offsetX, offsetY);
+    } else {
+        paintWalls(painter, dirty, static_cast<int>(offsetX), static_cast<int>(offsetY));
+    }
+
+    if (showMarkers_) {
+        const double displayRow = isAnimating_
+            ? playerRow_ + (targetRow_ - playerRow_) * animationProgress_
+            : playerRow_;
+        const double displayCol = isAnimating_
+            ? playerCol_ + (targetCol_ - playerCol_) * animationProgress_
+            : playerCol_;
+
+        const double cx = offsetX + (displayCol + 0.5) * cell;
+        const double cy = offsetY + (displayRow + 0.5) * cell;
+        const double size = inOverview() ? std::max(3.0, cell / 2.0) : std::max(2, cellSizePx() / 2);
+        const QRectF markerRect(cx - size / 2.0, cy - size / 2.0, size, size);
+        painter.setBrush(QColor(52, 122, 235));
+        painter.setPen(Qt::NoPen);
+        painter.drawEllipse(markerRect);
+    }
+}
+
+void MazeWidget::paintWalls(QPainter& painter, const QRect& dirty, const int offsetX, const int offsetY) {
     const int cell = cellSizePx();
     const int rows = graph_.rows;
     const int cols = graph_.cols;
     const int mazeWidth = cols * cell;
     const int mazeHeight = rows * cell;
 
-    const int offsetX = std::max(0, (width() - mazeWidth) / 2);
-    const int offsetY = std::max(0, (height() - mazeHeight) / 2);
-
     const int lineWidth = std::max(2, cell / 8);
-    const int outerLineWidth = lineWidth * 2;  
-    
-    struct Segment {
-        int x1; int y1; int x2; int y2;
-        bool operator==(const Segment& other) const {
-            return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
-        }
-    };
-    struct SegmentHash {
-        size_t operator()(const Segment& s) const noexcept {
-            size_t h1 = std::hash<int>()(s.x1);
-            size_t h2 = std::hash<int>()(s.y1);
-            size_t h3 = std::hash<int>()(s.x2);
-            size_t h4 = std::hash<int>()(s.y2);
-            return (((h1 * 1315423911u) ^ h2) * 1315423911u ^ h3) * 1315423911u ^ h4;
-        }
-    };
-    
-    std::unordered_set<Segment, SegmentHash> innerSegments;
-    std::unordered_set<Segment, SegmentHash> outerSegments;
-    
-    auto addInnerSegment = [&](int x1, int y1, int x2, int y2) {
-        if (x1 == x2 && y1 == y2) return;
-        if (x2 < x1 || (x1 == x2 && y2 < y1)) {
-            std::swap(x1, x2);
-            std::swap(y1, y2);
-        }
-        innerSegments.insert(Segment{x1, y1, x2, y2});
-    };
-    
-    auto addOuterSegment = [&](int x1, int y1, int x2, int y2) {
-        if (x1 == x2 && y1 == y2) return;
-        if (x2 < x1 || (x1 == x2 && y2 < y1)) {
-            std::swap(x1, x2);
-            std::swap(y1, y2);
-        }
-        outerSegments.insert(Segment{x1, y1, x2, y2});
-    };
-
-    
-    for (const auto& e : graph_.edges) {
-        if (e.open) continue;
-        const auto& from = graph_.nodes[e.from];
-        const auto& to = graph_.nodes[e.to];
-        if (from.row == to.row) {
-            
-            const int cMin = std::min(from.col, to.col);
-            const int x = offsetX + (cMin + 1) * cell;
-            const int y1 = offsetY + from.row * cell;
-            const int y2 = offsetY + (from.row + 1) * cell;
-            addInnerSegment(x, y1, x, y2);
-        } else if (from.col == to.col) {
-            
-            const int rMin = std::min(from.row, to.row);
-            const int y = offsetY + (rMin + 1) * cell;
-            const int x1 = offsetX + from.col * cell;
-            const int x2 = offsetX + (from.col + 1) * cell;
-            addInnerSegment(x1, y, x2, y);
+    const int outerLineWidth = lineWidth * 2;
+
+    const int margin = outerLineWidth;
+    const int colBegin = std::clamp((dirty.left() - offsetX - margin) / cell, 0, cols - 1);
+    const int colEnd = std::clamp((dirty.right() - offsetX + margin) / cell, 0, cols - 1);
+    const int rowBegin = std::clamp((dirty.top() - offsetY - margin) / cell, 0, rows - 1);
+    const int rowEnd = std::clamp((dirty.bottom() - offsetY + margin) / cell, 0, rows - 1);
+
+    std::vector<QLine> innerLines;
+    for (int r = rowBegin; r <= rowEnd; ++r) {
+        for (int c = colBegin; c <= colEnd; ++c) {
+            if (c + 1 < cols && walls_.eastClosed(r, c)) {
+                const int x = offsetX + (c + 1) * cell;
+                innerLines.emplace_back(x, offsetY + r * cell, x, offsetY + (r + 1) * cell);
+            }
+            if (r + 1 < rows && walls_.southClosed(r, c)) {
+                const int y = offsetY + (r + 1) * cell;
+                innerLines.emplace_back(offsetX + c * cell, y, offsetX + (c + 1) * cell, y);
+            }
         }
     }
 
-    
-    
-    for (int col = 0; col < cols; ++col) {
+    std::vector<QLine> outerLines;
+    for (int col = colBegin; col <= colEnd; ++col) {
         int x1 = offsetX + col * cell;
         int x2 = offsetX + (col + 1) * cell;
         if (col == 0) x1 -= outerLineWidth / 2;
         if (col == cols - 1) x2 += outerLineWidth / 2;
-        addOuterSegment(x1, offsetY, x2, offsetY);
+        outerLines.emplace_back(x1, offsetY, x2, offsetY);
+        outerLines.emplace_back(x1, offsetY + mazeHeight, x2, offsetY + mazeHeight);
     }
-    
-    for (int col = 0; col < cols; ++col) {
-        int x1 = offsetX + col * cell;
-        int x2 = offsetX + (col + 1) * cell;
-        if (col == 0) x1 -= outerLineWidth / 2;
-        if (col == cols - 1) x2 += outerLineWidth / 2;
-        addOuterSegment(x1, offsetY + mazeHeight, x2, offsetY + mazeHeight);
-    }
-    
-    for (int row = 0; row < rows; ++row) {
-        int y1 = offsetY + row * cell;
-        int y2 = offsetY + (row + 1) * cell;
-        if (row == 0) y1 -= outerLineWidth / 2;
-        if (row == rows - 1) y2 += outerLineWidth / 2;
-        addOuterSegment(offsetX, y1, offsetX, y2);
-    }
-    
-    for (int row = 0; row < rows; ++row) {
+    for (int row = rowBegin; row <= rowEnd; ++row) {
         int y1 = offsetY + row * cell;
         int y2 = offsetY + (row + 1) * cell;
         if (row == 0) y1 -= outerLineWidth / 2;
         if (row == rows - 1) y2 += outerLineWidth / 2;
-        addOuterSegment(offsetX + mazeWidth, y1, offsetX + mazeWidth, y2);
+        outerLines.emplace_back(offsetX, y1, offsetX, y2);
+        outerLines.emplace_back(offsetX + mazeWidth, y1, offsetX + mazeWidth, y2);
     }
 
-    
     painter.setPen(QPen(wallColor_, lineWidth, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin));
-    for (const auto& seg : innerSegments) {
-        painter.drawLine(seg.x1, seg.y1, seg.x2, seg.y2);
-    }
+    painter.drawLines(innerLines.data(), static_cast<int>(innerLines.size()));
 
-    
     painter.setPen(QPen(wallColor_, outerLineWidth, Qt::SolidLine, Qt::RoundCap, Qt::MiterJoin));
-    for (const auto& seg : outerSegments) {
-        painter.drawLine(seg.x1, seg.y1, seg.x2, seg.y2);
-    }
+    painter.drawLines(outerLines.data(), static_cast<int>(outerLines.size()));
 
     auto carveGap = [&](int nodeId) {
         if (nodeId < 0 || nodeId >= static_cast<int>(graph_.nodes.size())) return;
@@ -242,23 +266,44 @@ void MazeWidget::paintEvent(QPaintEvent* ) {
 
     carveGap(entranceNode_);
     carveGap(exitNode_);
+}
 
-    if (showMarkers_) {
-        const double displayRow = isAnimating_
-            ? playerRow_ + (targetRow_ - playerRow_) * animationProgress_
-            : playerRow_;
-        const double displayCol = isAnimating_
-            ? playerCol_ + (targetCol_ - playerCol_) * animationProgress_
-            : playerCol_;
+void MazeWidget::paintOverview(QPainter& painter, const QRect& dirty, const double offsetX, const double offsetY) {
+    if (mipLevels_.empty()) {
+        painter.setPen(Qt::gray);
+        painter.drawText(dirty, Qt::AlignCenter, "Preparing overview...");
+        return;
+    }
 
-        const double cx = offsetX + (displayCol + 0.5) * cell;
-        const double cy = offsetY + (displayRow + 0.5) * cell;
-        const int size = std::max(2, cell / 2);
-        const QRectF markerRect(cx - size / 2.0, cy - size / 2.0, size, size);
-        painter.setBrush(QColor(52, 122, 235));
-        painter.setPen(Qt::NoPen);
-        painter.drawEllipse(markerRect);
+    // Coarsest level that still has at least one texel per screen pixel.
+    const double cell = cellScale_;
+    std::size_t levelIndex = 0;
+    double levelCellPx = kMazeMipmapBaseCellPx;
+    while (levelIndex + 1 < mipLevels_.size() && levelCellPx / 2.0 >= cell) {
+        ++levelIndex;
+        levelCellPx /= 2.0;
+    }
+    const QImage& level = mipLevels_[levelIndex];
+
+    const QRectF mazeRect(offsetX, offsetY, graph_.cols * cell, graph_.rows * cell);
+    const QRectF target = QRectF(dirty).intersected(mazeRect);
+    if (target.isEmpty()) {
+        return;
+    }
+    const double sx = level.width() / mazeRect.width();
+    const double sy = level.height() / mazeRect.height();
+    const QRect source = QRectF((target.left() - offsetX) * sx, (target.top() - offsetY) * sy,
+                                target.width() * sx, target.height() * sy)
+                             .toAlignedRect()
+                             .intersected(level.rect());
+    if (source.isEmpty()) {
+        return;
     }
+    const QRectF snapped(offsetX + source.left() / sx, offsetY + source.top() / sy,
+                         source.width() / sx, source.height() / sy);
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, levelCellPx > cell);
+    painter.drawImage(snapped, level.copy(source));
 }
 
 void MazeWidget::keyPressEvent(QKeyEvent* event) {
@@ -414,13 +459,22 @@ int MazeWidget::cellSizePx() const {
     return cellPixelSize_;
 }
 
+bool MazeWidget::inOverview() const {
+    return cellScale_ < static_cast<double>(minCellSize_);
+}
+
 void MazeWidget::applySizeFromGraph() {
     const double scaled = static_cast<double>(baseCellSize_) * zoomFactor_;
-    const int cell = std::max(minCellSize_, static_cast<int>(std::round(scaled)));
-    cellPixelSize_ = cell;
+    if (scaled < static_cast<double>(minCellSize_)) {
+        cellPixelSize_ = minCellSize_;
+        cellScale_ = std::max(kMinOverviewCellPx, scaled);
+    } else {
+        cellPixelSize_ = std::max(minCellSize_, static_cast<int>(std::round(scaled)));
+        cellScale_ = static_cast<double>(cellPixelSize_);
+    }
 
     if (graph_.rows > 0 && graph_.cols > 0) {
-        setFixedSize(graph_.cols * cell, graph_.rows * cell);
+        setFixedSize(sizeHint());
     } else {
         setMinimumSize(0, 0);
         setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
@@ -430,21 +484,36 @@ void MazeWidget::applySizeFromGraph() {
 }
 
 void MazeWidget::setZoomFactor(const double factor) {
-    const double clamped = std::clamp(factor, 0.4, 3.0);
-    int targetCell = static_cast<int>(std::round(static_cast<double>(baseCellSize_) * clamped));
-    targetCell = std::max(minCellSize_, targetCell);
-    zoomFactor_ = static_cast<double>(targetCell) / static_cast<double>(baseCellSize_);
+    const double base = static_cast<double>(baseCellSize_);
+    const double clamped = std::clamp(factor, kMinOverviewCellPx / base, 3.0);
+    if (base * clamped < static_cast<double>(minCellSize_)) {
+        zoomFactor_ = clamped;
+    } else {
+        const int targetCell = std::max(minCellSize_, static_cast<int>(std::round(base * clamped)));
+        zoomFactor_ = static_cast<double>(targetCell) / base;
+    }
     applySizeFromGraph();
     update();
 }
 
 void MazeWidget::zoomIn() {
-    const double next = static_cast<double>(cellPixelSize_ + 1) / static_cast<double>(baseCellSize_);
+    const double base = static_cast<double>(baseCellSize_);
+    if (inOverview()) {
+        const double next = cellScale_ / kOverviewZoomStep;
+        setZoomFactor(std::min(next, static_cast<double>(minCellSize_)) / base);
+        return;
+    }
+    const double next = static_cast<double>(cellPixelSize_ + 1) / base;
     setZoomFactor(next);
 }
 
 void MazeWidget::zoomOut() {
-    const double next = static_cast<double>(std::max(minCellSize_, cellPixelSize_ - 1)) / static_cast<double>(baseCellSize_);
+    const double base = static_cast<double>(baseCellSize_);
+    if (inOverview() || cellPixelSize_ <= minCellSize_) {
+        setZoomFactor(cellScale_ * kOverviewZoomStep / base);
+        return;
+    }
+    const double next = static_cast<double>(cellPixelSize_ - 1) / base;
     setZoomFactor(next);
 }
 
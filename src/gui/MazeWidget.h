@@ -7,14 +7,23 @@
 #include <QColor>
 #include <QRect>
 #include <QPointF>
+#include <QImage>
+#include <QVector>
+#include <QRgb>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "maze.h"
+#include "maze_walls.h"
+
+class QPainter;
 
 class MazeWidget : public QWidget {
     Q_OBJECT
 public:
     explicit MazeWidget(QWidget* parent = nullptr);
+    ~MazeWidget() override;
 
     void setGraph(const MazeGraph& graph, bool tested, bool showMarkers, int entranceNode, int exitNode, int playerNode);
     void startMove(int fromRow, int fromCol, int toRow, int toCol);
@@ -41,15 +50,22 @@ protected:
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
+    void showEvent(QShowEvent* event) override;
 
 private:
     MazeGraph graph_;
+    MazeWalls walls_;
     bool tested_ = false;
     bool showMarkers_ = false;
     int baseCellSize_ = 34;
     int minCellSize_ = 10;
     double zoomFactor_ = 1.0;
     int cellPixelSize_ = 28;
+    double cellScale_ = 28.0;
+    std::vector<QImage> mipLevels_;
+    QVector<QRgb> mipColorTable_;
+    std::shared_ptr<std::atomic<quint64>> mipmapTicket_ = std::make_shared<std::atomic<quint64>>(0);
+    bool mipmapPending_ = false;
 
     
     QTimer* animationTimer_ = nullptr;
@@ -75,5 +91,9 @@ private:
 
     void updateAnimation();
     [[nodiscard]] int cellSizePx() const;
+    [[nodiscard]] bool inOverview() const;
     void applySizeFromGraph();
+    void rebuildMipmap();
+    void paintWalls(QPainter& painter, const QRect& dirty, int offsetX, int offsetY);
+    void paintOverview(QPainter& painter, const QRect& dirty, double offsetX, double offsetY);
 };
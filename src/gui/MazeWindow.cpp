@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <functional>
 #include <QAbstractItemView>
+#include <QApplication>
 #include <QCloseEvent>
 #include <QComboBox>
 #include <QCoreApplication>
@@ -12,7 +14,8 @@
 #include <QHBoxLayout>
 #include <QImage>
 #include <QLabel>
-#include <QListWidget>
+#include <QItemSelectionModel>
+#include <QListView>
 #include <QLineEdit>
 #include <QMenu>
 #include <QMessageBox>
@@ -42,131 +45,30 @@
 #include <QStatusBar>
 #include <QDir>
 #include <QFile>
-#include <QJsonArray>
-#include <QJsonDocument>
-#include <QJsonObject>
 #include <QSaveFile>
 #include <QStandardPaths>
 #include <QPrintPreviewDialog>
+#include <QProgressDialog>
 #include <QPrintPreviewWidget>
 #include "puzzles/maze_graph.h"
+#include "puzzles/maze_walls.h"
+#include "CrosswordFiller.h"
+#include "CrosswordSearcher.h"
+#include "DictionaryLoader.h"
+#include "MazeRasterExporter.h"
+#include "PuzzleVectorExporter.h"
+#include "PuzzleArchive.h"
+#include "PuzzleSerialization.h"
+#include "PuzzleThumbnailer.h"
+#include "SavedPuzzleListModel.h"
+#include "SudokuBatchGenerator.h"
+#include "SudokuImporter.h"
+#include "SudokuSolver.h"
 
 namespace {
 constexpr int kMinUnits = 2;
 constexpr int kMaxUnits = 1000;
 
-QJsonObject graphToJson(const MazeGraph& graph) {
-    QJsonObject obj;
-    obj["rows"] = graph.rows;
-    obj["cols"] = graph.cols;
-    obj["entranceNode"] = graph.entranceNode;
-    obj["exitNode"] = graph.exitNode;
-
-    QJsonArray nodes;
-    for (const auto& n : graph.nodes) {
-        QJsonObject nodeObj;
-        nodeObj["id"] = n.id;
-        nodeObj["row"] = n.row;
-        nodeObj["col"] = n.col;
-        nodes.append(nodeObj);
-    }
-    obj["nodes"] = nodes;
-
-    QJsonArray edges;
-    for (const auto& e : graph.edges) {
-        QJsonObject edgeObj;
-        edgeObj["from"] = e.from;
-        edgeObj["to"] = e.to;
-        edgeObj["open"] = e.open;
-        edges.append(edgeObj);
-    }
-    obj["edges"] = edges;
-    return obj;
-}
-
-std::optional<MazeGraph> graphFromJson(const QJsonObject& obj) {
-    MazeGraph graph;
-    graph.rows = obj.value("rows").toInt();
-    graph.cols = obj.value("cols").toInt();
-    graph.entranceNode = obj.value("entranceNode").toInt(-1);
-    graph.exitNode = obj.value("exitNode").toInt(-1);
-
-    const auto nodesArr = obj.value("nodes").toArray();
-    const auto edgesArr = obj.value("edges").toArray();
-    if (graph.rows <= 0 || graph.cols <= 0 || nodesArr.isEmpty() || edgesArr.isEmpty()) {
-        return std::nullopt;
-    }
-
-    graph.nodes.reserve(nodesArr.size());
-    for (const auto& val : nodesArr) {
-        const auto nodeObj = val.toObject();
-        MazeNode node;
-        node.id = nodeObj.value("id").toInt();
-        node.row = nodeObj.value("row").toInt();
-        node.col = nodeObj.value("col").toInt();
-        graph.nodes.push_back(node);
-    }
-
-    graph.edges.reserve(edgesArr.size());
-    for (const auto& val : edgesArr) {
-        const auto edgeObj = val.toObject();
-        MazeEdge edge;
-        edge.from = edgeObj.value("from").toInt();
-        edge.to = edgeObj.value("to").toInt();
-        edge.open = edgeObj.value("open").toBool();
-        graph.edges.push_back(edge);
-    }
-
-    return graph;
-}
-
-QJsonArray intGridToJson(const std::vector<std::vector<int>>& grid) {
-    QJsonArray rows;
-    for (const auto& row : grid) {
-        QJsonArray jsonRow;
-        for (int cell : row) {
-            jsonRow.append(cell);
-        }
-        rows.append(jsonRow);
-    }
-    return rows;
-}
-
-std::vector<std::vector<int>> intGridFromJson(const QJsonArray& arr) {
-    std::vector<std::vector<int>> grid;
-    grid.reserve(arr.size());
-    for (const auto& rowVal : arr) {
-        if (!rowVal.isArray()) {
-            grid.clear();
-            return {};
-        }
-        const auto rowArray = rowVal.toArray();
-        std::vector<int> row;
-        row.reserve(rowArray.size());
-        for (const auto& cellVal : rowArray) {
-            row.push_back(cellVal.toInt());
-        }
-        grid.push_back(std::move(row));
-    }
-    return grid;
-}
-
-int algorithmToInt(const GenerationAlgorithm algorithm) {
-    return static_cast<int>(algorithm);
-}
-
-GenerationAlgorithm algorithmFromInt(const int value) {
-    switch (value) {
-        case static_cast<int>(GenerationAlgorithm::DFS): return GenerationAlgorithm::DFS;
-        case static_cast<int>(GenerationAlgorithm::BFS): return GenerationAlgorithm::BFS;
-        case static_cast<int>(GenerationAlgorithm::Wilson): return GenerationAlgorithm::Wilson;
-        case static_cast<int>(GenerationAlgorithm::Kruskal): return GenerationAlgorithm::Kruskal;
-        case static_cast<int>(GenerationAlgorithm::Prim): return GenerationAlgorithm::Prim;
-        case static_cast<int>(GenerationAlgorithm::Tessellation): return GenerationAlgorithm::Tessellation;
-        default: return GenerationAlgorithm::DFS;
-    }
-}
-
 void showSizedMessage(QWidget* parent, QMessageBox::Icon icon, const QString& title, const QString& text) {
     QMessageBox box(icon, title, text, QMessageBox::Ok, parent);
     box.setModal(true);
@@ -178,6 +80,60 @@ void showSizedMessage(QWidget* parent, QMessageBox::Icon icon, const QString& ti
     box.exec();
 }
 
+constexpr const char* kPictureFilters = "PNG Images (*.png);;SVG Images (*.svg);;PDF Documents (*.pdf)";
+
+enum class PictureFormat { Png, Svg, Pdf, Pbm };
+
+PictureFormat pictureFormatFor(const QString& path, const QString& selectedFilter) {
+    if (path.endsWith(".svg", Qt::CaseInsensitive)) return PictureFormat::Svg;
+    if (path.endsWith(".pdf", Qt::CaseInsensitive)) return PictureFormat::Pdf;
+    if (path.endsWith(".pbm", Qt::CaseInsensitive)) return PictureFormat::Pbm;
+    if (path.endsWith(".png", Qt::CaseInsensitive)) return PictureFormat::Png;
+    if (selectedFilter.startsWith("SVG")) return PictureFormat::Svg;
+    if (selectedFilter.startsWith("PDF")) return PictureFormat::Pdf;
+    if (selectedFilter.startsWith("PBM")) return PictureFormat::Pbm;
+    return PictureFormat::Png;
+}
+
+bool savePicture(const QString& path,
+                 const QString& selectedFilter,
+                 const QSize& size,
+                 const QColor& background,
+                 const std::function<void(QPainter&)>& paint) {
+    switch (pictureFormatFor(path, selectedFilter)) {
+        case PictureFormat::Svg:
+            return writeVectorSvg(recordVectorDocument(size, background, paint), path);
+        case PictureFormat::Pdf:
+            return writeVectorPdf(recordVectorDocument(size, background, paint), path);
+        default:
+            break;
+    }
+    QImage image(size, QImage::Format_ARGB32);
+    image.fill(background);
+    QPainter painter(&image);
+    paint(painter);
+    painter.end();
+    return image.save(path, "PNG");
+}
+
+QString sudokuBatchSummary(const SudokuBatchStats& stats) {
+    return QString("%1 puzzles from %2 candidates (%3 off-tier, %4 duplicates), %5 puzzles/s")
+        .arg(stats.accepted)
+        .arg(stats.generated)
+        .arg(stats.offTier)
+        .arg(stats.duplicates)
+        .arg(stats.perSecond(), 0, 'f', 1);
+}
+
+QString sudokuImportSummary(const SudokuImportStats& stats) {
+    return QString("%1 puzzles from %2 lines (%3 malformed, %4 invalid), %5 lines/s")
+        .arg(stats.accepted)
+        .arg(stats.lines)
+        .arg(stats.malformed)
+        .arg(stats.rejected)
+        .arg(stats.perSecond(), 0, 'f', 0);
+}
+
 QColor pickColorWithHex(QWidget* parent, const QColor& current, const QString& title) {
     QDialog dlg(parent);
     dlg.setWindowTitle(title);
@@ -295,15 +251,23 @@ MazeWindow::MazeWindow(QWidget* parent) : QMainWindow(parent) {
     auto* central = new QWidget(this);
     setCentralWidget(central);
 
-    savedList_ = new QListWidget(this);
+    savedSearch_ = new QLineEdit(this);
+    savedSearch_->setPlaceholderText("Search");
+    savedSearch_->setClearButtonEnabled(true);
+    savedSearch_->setMaximumWidth(200);
+
+    savedList_ = new QListView(this);
     savedList_->setSelectionMode(QAbstractItemView::SingleSelection);
+    savedList_->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    savedList_->setUniformItemSizes(true);
+    savedList_->setIconSize(QSize(PuzzleThumbnailer::kSize, PuzzleThumbnailer::kSize));
     savedList_->setMaximumWidth(200);
-    connect(savedList_, &QListWidget::currentRowChanged, this, &MazeWindow::handleSelectionChanged);
     savedList_->setContextMenuPolicy(Qt::CustomContextMenu);
-    connect(savedList_, &QListWidget::customContextMenuRequested, this, &MazeWindow::showContextMenu);
+    connect(savedList_, &QListView::customContextMenuRequested, this, &MazeWindow::showContextMenu);
 
     auto* leftLayout = new QVBoxLayout;
     leftLayout->addWidget(new QLabel("Saved Puzzles", this));
+    leftLayout->addWidget(savedSearch_);
     leftLayout->addWidget(savedList_, 1);
     leftLayout->setContentsMargins(8, 8, 8, 8);
     leftLayout->setSpacing(8);
@@ -591,9 +555,23 @@ MazeWindow::MazeWindow(QWidget* parent) : QMainWindow(parent) {
     addWordButton_ = new QPushButton("Add Word", this);
     connect(addWordButton_, &QPushButton::clicked, this, [this]() { addWordRow(); });
 
+    // A dense fill needs no word list: the grid is filled from the dictionary instead.
+    crosswordDenseCheck_ = new QCheckBox("Fill a dense grid from the dictionary", this);
+    crosswordSideSpin_ = new QSpinBox(this);
+    crosswordSideSpin_->setRange(5, CrosswordFiller::kMaxSide);
+    crosswordSideSpin_->setValue(13);
+    crosswordSideSpin_->setEnabled(false);
+    connect(crosswordDenseCheck_, &QCheckBox::toggled, this, [this](bool dense) {
+        wordListContainer_->setEnabled(!dense);
+        addWordButton_->setEnabled(!dense);
+        crosswordSideSpin_->setEnabled(dense);
+    });
+
     auto* crosswordForm = new QFormLayout;
     crosswordForm->addRow("Words", wordListContainer_);
     crosswordForm->addRow("", addWordButton_);
+    crosswordForm->addRow("", crosswordDenseCheck_);
+    crosswordForm->addRow("Grid Size", crosswordSideSpin_);
     crosswordGeneratorPage_->setLayout(crosswordForm);
 
     wordSearchGeneratorPage_ = new QWidget(this);
@@ -614,11 +592,21 @@ MazeWindow::MazeWindow(QWidget* parent) : QMainWindow(parent) {
     auto* sudokuForm = new QFormLayout;
     sudokuNameEdit_ = new QLineEdit(this);
     sudokuNameEdit_->setPlaceholderText("Puzzle name (optional)");
+    sudokuSizeCombo_ = new QComboBox(this);
+    sudokuSizeCombo_->addItem("4 x 4", 2);
+    sudokuSizeCombo_->addItem("9 x 9", 3);
+    sudokuSizeCombo_->addItem("16 x 16", 4);
+    sudokuSizeCombo_->addItem("25 x 25", 5);
+    sudokuSizeCombo_->setCurrentIndex(1);
     sudokuDifficultyCombo_ = new QComboBox(this);
     sudokuDifficultyCombo_->addItem("Easy", 0);
     sudokuDifficultyCombo_->addItem("Medium", 1);
     sudokuDifficultyCombo_->addItem("Hard", 2);
+    sudokuDifficultyCombo_->setItemData(0, "Solvable with naked and hidden singles", Qt::ToolTipRole);
+    sudokuDifficultyCombo_->setItemData(1, "Needs pairs, triples or pointing pairs", Qt::ToolTipRole);
+    sudokuDifficultyCombo_->setItemData(2, "Needs an X-Wing, Swordfish or XY-Wing", Qt::ToolTipRole);
     sudokuForm->addRow("Name", sudokuNameEdit_);
+    sudokuForm->addRow("Size", sudokuSizeCombo_);
     sudokuForm->addRow("Difficulty", sudokuDifficultyCombo_);
     sudokuGeneratorPage_->setLayout(sudokuForm);
     
@@ -648,8 +636,8 @@ MazeWindow::MazeWindow(QWidget* parent) : QMainWindow(parent) {
     generatorStack_->addWidget(cryptogramGeneratorPage_);
     generatorStack_->setCurrentWidget(mazeGeneratorPage_);
 
-    auto* createButton = new QPushButton("Create Puzzle", this);
-    connect(createButton, &QPushButton::clicked, this, &MazeWindow::generateMaze);
+    createButton_ = new QPushButton("Create Puzzle", this);
+    connect(createButton_, &QPushButton::clicked, this, &MazeWindow::generateMaze);
     auto* cancelButton = new QPushButton("Cancel", this);
     connect(cancelButton, &QPushButton::clicked, this, &MazeWindow::cancelGenerator);
 
@@ -665,7 +653,7 @@ MazeWindow::MazeWindow(QWidget* parent) : QMainWindow(parent) {
     generatorErrorLabel_->setWordWrap(true);
     generatorErrorLabel_->setVisible(false);
     generateLayout->addWidget(generatorErrorLabel_);
-    generateLayout->addWidget(createButton);
+    generateLayout->addWidget(createButton_);
     generateLayout->addWidget(cancelButton);
     generateLayout->addStretch(1);
     generatePage_->setLayout(generateLayout);
@@ -689,9 +677,22 @@ MazeWindow::MazeWindow(QWidget* parent) : QMainWindow(parent) {
         warnUnsupportedStart();
     });
 
-    if (!wordSearchGen_.loadDictionary("words.txt")) {
-        updateStatusBarText("Warning: Could not load word dictionary. Word search may not work properly.");
-    }
+    // words.dawg is compiled from words.txt by the BuildDictionary tool at build time and installed
+    // next to the executable; without it the list is compiled on the loader's thread.
+    dictionaryLoader_ = new DictionaryLoader(this);
+    connect(dictionaryLoader_, &DictionaryLoader::finished, this,
+            [this](const std::shared_ptr<const WordPatternIndex>& words, bool) {
+        dictionaryWords_ = words;
+        wordSearchGen_.setDictionary(words);
+        if (words->empty()) {
+            updateStatusBarText("Warning: Could not load word dictionary. Word search may not work properly.");
+        }
+    });
+    const QString installedDictionary = QDir(QCoreApplication::applicationDirPath()).filePath("words.dawg");
+    dictionaryLoader_->start(QFile::exists(installedDictionary) ? installedDictionary : QString("words.dawg"), "words.txt");
+
+    crosswordSearcher_ = new CrosswordSearcher(this);
+    connect(crosswordSearcher_, &CrosswordSearcher::finished, this, &MazeWindow::crosswordSearched);
 
     createMenusAndToolbars();
     statusBar()->addWidget(statusLabel_, 1);
@@ -699,6 +700,27 @@ MazeWindow::MazeWindow(QWidget* parent) : QMainWindow(parent) {
 
     updateGeneratorView();
     updateSizeControls();
+    persistence_ = new PersistenceService(libraryDirectoryPath(), stateFilePath(), this);
+    connect(persistence_, &PersistenceService::saveDue, this, &MazeWindow::submitState);
+    library_ = new PuzzleLibrary(*persistence_, this);
+    thumbnailer_ = new PuzzleThumbnailer(thumbnailDirectoryPath(), this);
+    thumbnailer_->setColors(mazeWallColor_, mazeBackgroundColor_);
+    sudokuBatch_ = new SudokuBatchGenerator(this);
+    sudokuImporter_ = new SudokuImporter(this);
+    savedModel_ = new SavedPuzzleListModel(*library_, thumbnailer_, this);
+    savedList_->setModel(savedModel_);
+    connect(savedList_->selectionModel(), &QItemSelectionModel::currentChanged, this, [this](const QModelIndex& current) {
+        if (!quietSelection_) {
+            handleSelectionChanged(savedModel_->libraryRow(current.row()));
+        }
+    });
+    connect(savedSearch_, &QLineEdit::textChanged, this, [this](const QString& text) {
+        const int row = currentSavedRow();
+        savedModel_->setFilter(text);
+        if (savedModel_->viewRow(row) >= 0) {
+            setCurrentSavedRow(row, false);
+        }
+    });
     restoreState();
     updateStatus();
     refreshActions();
@@ -789,7 +811,7 @@ void MazeWindow::generateMaze() {
 
     QString mazeName = nameEdit_->text().trimmed();
     if (mazeName.isEmpty()) {
-        mazeName = QString("Maze %1").arg(savedPuzzles_.size() + 1);
+        mazeName = QString("Maze %1").arg(library_->count() + 1);
     }
 
     if (algorithm == GenerationAlgorithm::Tessellation) {
@@ -816,18 +838,10 @@ void MazeWindow::generateMaze() {
         game_.exitNode(),
         game_.playerNode()
     };
-    savedMazes_.push_back(savedMaze);
-    
-    SavedPuzzle puzzle;
-    puzzle.type = SavedPuzzle::Type::Maze;
-    puzzle.maze = savedMazes_.back();
-    savedPuzzles_.push_back(puzzle);
+    library_->add(SavedPuzzle(std::move(savedMaze)));
 
-    const int row = static_cast<int>(savedPuzzles_.size()) - 1;
-    savedList_->addItem(mazeName.isEmpty() ? QString("Maze %1").arg(row + 1) : mazeName);
-    savedList_->blockSignals(true);
-    savedList_->setCurrentRow(row);
-    savedList_->blockSignals(false);
+    const int row = library_->count() - 1;
+    setCurrentSavedRow(row, false);
 
     handleSelectionChanged(row);
 
@@ -847,6 +861,24 @@ void MazeWindow::generateMaze() {
 }
 
 void MazeWindow::generateCrossword() {
+    if (crosswordSearcher_->isRunning()) {
+        return;
+    }
+    if (crosswordDenseCheck_->isChecked()) {
+        if (dictionaryLoader_->isRunning()) {
+            showSizedMessage(this, QMessageBox::Information, "Dictionary Loading", "The word dictionary is still loading. Try again in a moment.");
+            return;
+        }
+        if (!dictionaryWords_ || dictionaryWords_->empty()) {
+            showSizedMessage(this, QMessageBox::Warning, "Generation Failed", "A dense crossword needs the word dictionary, which could not be loaded.");
+            return;
+        }
+        lastCrosswordHints_.clear();
+        createButton_->setEnabled(false);
+        updateStatusBarText("Filling the crossword grid...");
+        crosswordSearcher_->fill(dictionaryWords_, crosswordSideSpin_->value());
+        return;
+    }
     const auto entries = collectWords();
     if (entries.empty()) {
         showSizedMessage(this, QMessageBox::Warning, "Invalid Input", "Add at least one word with a hint.");
@@ -865,11 +897,20 @@ void MazeWindow::generateCrossword() {
         lastCrosswordHints_[word] = hint;
     }
 
-    constexpr int rows = 15;
-    constexpr int cols = 15;
-    const auto puzzle = ::generateCrossword(words, rows, cols);
+    // The search runs for up to its whole budget, so it stays off the GUI thread; Create is
+    // disabled until it reports back.
+    createButton_->setEnabled(false);
+    updateStatusBarText("Laying out the crossword...");
+    crosswordSearcher_->start(std::move(words));
+}
+
+void MazeWindow::crosswordSearched(const std::optional<CrosswordPuzzle>& puzzle, const std::vector<std::string>& words) {
+    createButton_->setEnabled(true);
     if (!puzzle) {
-        showSizedMessage(this, QMessageBox::Warning, "Generation Failed", "Could not create a crossword with the given words.");
+        // No words means the dictionary fill ran out of time.
+        showSizedMessage(this, QMessageBox::Warning, "Generation Failed",
+                         words.empty() ? "Could not fill a crossword grid of that size from the dictionary."
+                                       : "Could not create a crossword with the given words.");
         return;
     }
 
@@ -880,20 +921,14 @@ void MazeWindow::generateCrossword() {
     coordLabel_->setVisible(false);
     currentCrossword_ = puzzle;
     
-    SavedPuzzle savedPuzzle;
-    savedPuzzle.type = SavedPuzzle::Type::Crossword;
-    savedPuzzle.crossword = SavedCrossword{
-        QString("Crossword %1").arg(savedPuzzles_.size() + 1).toStdString(),
+    library_->add(SavedPuzzle(SavedCrossword{
+        QString("Crossword %1").arg(library_->count() + 1).toStdString(),
         *puzzle,
         lastCrosswordHints_
-    };
-    savedPuzzles_.push_back(savedPuzzle);
+    }));
     
-    const int row = static_cast<int>(savedPuzzles_.size()) - 1;
-    savedList_->addItem(QString("Crossword %1").arg(row + 1));
-    savedList_->blockSignals(true);
-    savedList_->setCurrentRow(row);
-    savedList_->blockSignals(false);
+    const int row = library_->count() - 1;
+    setCurrentSavedRow(row, false);
     
     puzzleViewStack_->setCurrentWidget(crosswordView_);
     crosswordWidget_->setPuzzle(*puzzle);
@@ -901,6 +936,20 @@ void MazeWindow::generateCrossword() {
     rightStack_->setCurrentWidget(playPage_);
     refreshActions();
     updateStatus();
+    // The search keeps the best layout it finds even when some words would not fit.
+    QStringList leftOut;
+    for (const auto& word : words) {
+        auto placed = [&word](const CrosswordEntry& entry) { return entry.word == word; };
+        if (std::none_of(puzzle->across.begin(), puzzle->across.end(), placed)
+            && std::none_of(puzzle->down.begin(), puzzle->down.end(), placed)) {
+            leftOut << QString::fromStdString(word);
+        }
+    }
+    if (words.empty()) {
+        updateStatusBarText("Crossword filled from the dictionary; its clues are left blank.");
+    } else if (!leftOut.isEmpty()) {
+        updateStatusBarText(QString("Crossword ready; left out: %1").arg(leftOut.join(", ")));
+    }
     if (generatorErrorLabel_) {
         generatorErrorLabel_->clear();
         generatorErrorLabel_->setVisible(false);
@@ -939,6 +988,11 @@ void MazeWindow::generateWordSearch() {
     const int size = wordSearchSizeSpin_->value();
     const int wordCount = wordCountSpin_->value();
     
+    if (dictionaryLoader_->isRunning()) {
+        showSizedMessage(this, QMessageBox::Information, "Dictionary Loading", "The word dictionary is still loading. Try again in a moment.");
+        return;
+    }
+    
     WordSearchPuzzle puzzle = wordSearchGen_.generate(size, wordCount);
     
     if (puzzle.words.empty()) {
@@ -955,16 +1009,12 @@ void MazeWindow::generateWordSearch() {
     coordLabel_->setVisible(false);
     currentWordSearch_ = puzzle;
     
-    SavedPuzzle saved;
-    saved.type = SavedPuzzle::Type::WordSearch;
-    saved.wordSearch = SavedWordSearch{
-        "Word Search " + std::to_string(savedPuzzles_.size() + 1),
+    library_->add(SavedPuzzle(SavedWordSearch{
+        "Word Search " + std::to_string(library_->count() + 1),
         puzzle
-    };
-    savedPuzzles_.push_back(saved);
+    }));
     
-    savedList_->addItem(QString::fromStdString(saved.wordSearch->name));
-    savedList_->setCurrentRow(static_cast<int>(savedPuzzles_.size()) - 1);
+    setCurrentSavedRow(library_->count() - 1);
     
     showWordSearch(puzzle);
     rightStack_->setCurrentWidget(playPage_);
@@ -996,7 +1046,8 @@ void MazeWindow::generateSudoku() {
     const int difficulty = sudokuDifficultyCombo_
         ? sudokuDifficultyCombo_->currentData().toInt()
         : 0;
-    const auto puzzle = ::generateSudoku(difficulty);
+    const int boxSize = sudokuSizeCombo_ ? sudokuSizeCombo_->currentData().toInt() : 3;
+    const auto puzzle = ::generateSudoku(difficulty, boxSize);
     if (!puzzle) {
         showSizedMessage(this, QMessageBox::Warning, "Invalid Input", "Could not create a Sudoku puzzle.");
         return;
@@ -1009,25 +1060,19 @@ void MazeWindow::generateSudoku() {
     coordLabel_->setVisible(false);
     currentSudoku_ = puzzle;
     QString sudokuName = sudokuNameEdit_ ? sudokuNameEdit_->text().trimmed() : QString();
-    const int nextIndex = static_cast<int>(savedPuzzles_.size()) + 1;
+    const int nextIndex = library_->count() + 1;
     if (sudokuName.isEmpty()) {
         sudokuName = QString("Sudoku %1").arg(nextIndex);
     }
     
-    SavedPuzzle savedPuzzle;
-    savedPuzzle.type = SavedPuzzle::Type::Sudoku;
-    savedPuzzle.sudoku = SavedSudoku{
+    library_->add(SavedPuzzle(SavedSudoku{
         sudokuName.toStdString(),
         *puzzle,
         difficulty
-    };
-    savedPuzzles_.push_back(savedPuzzle);
+    }));
     
-    const int row = static_cast<int>(savedPuzzles_.size()) - 1;
-    savedList_->addItem(sudokuName);
-    savedList_->blockSignals(true);
-    savedList_->setCurrentRow(row);
-    savedList_->blockSignals(false);
+    const int row = library_->count() - 1;
+    setCurrentSavedRow(row, false);
     
     puzzleViewStack_->setCurrentWidget(sudokuView_);
     sudokuWidget_->setPuzzle(*puzzle);
@@ -1051,7 +1096,7 @@ void MazeWindow::generateSudoku() {
 void MazeWindow::generateCryptogram() {
     QString name = cryptogramNameEdit_ ? cryptogramNameEdit_->text().trimmed() : QString();
     if (name.isEmpty()) {
-        name = QString("Cryptogram %1").arg(savedPuzzles_.size() + 1);
+        name = QString("Cryptogram %1").arg(library_->count() + 1);
     }
     
     if (!cryptogramPlaintextEdit_) {
@@ -1074,22 +1119,15 @@ void MazeWindow::generateCryptogram() {
     coordLabel_->setVisible(false);
     currentCryptogram_ = puzzle;
     
-    SavedPuzzle savedPuzzle;
-    savedPuzzle.type = SavedPuzzle::Type::Cryptogram;
-    savedPuzzle.cryptogram = SavedCryptogram{
+    library_->add(SavedPuzzle(SavedCryptogram{
         name.toStdString(),
         puzzle,
         avoidSelf,
         hintCount
-    };
-    savedPuzzles_.push_back(savedPuzzle);
-    savedCryptograms_.push_back(*savedPuzzle.cryptogram);
+    }));
     
-    const int row = static_cast<int>(savedPuzzles_.size()) - 1;
-    savedList_->addItem(name);
-    savedList_->blockSignals(true);
-    savedList_->setCurrentRow(row);
-    savedList_->blockSignals(false);
+    const int row = library_->count() - 1;
+    setCurrentSavedRow(row, false);
     
     puzzleViewStack_->setCurrentWidget(cryptogramView_);
     cryptogramWidget_->setPuzzle(puzzle);
@@ -1125,22 +1163,20 @@ void MazeWindow::saveSudokuImage() {
     }
 
     const auto& puzzle = *currentSudoku_;
-    const int rows = static_cast<int>(puzzle.grid.size());
-    const int cols = rows == 0 ? 0 : static_cast<int>(puzzle.grid.front().size());
-    if (rows == 0 || cols == 0) {
+    const int box = sudokuBoxSize(puzzle.grid);
+    const int rows = box * box;
+    const int cols = rows;
+    if (box == 0) {
         showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Nothing to export.");
         return;
     }
 
     QString sudokuName = "Sudoku";
     int difficulty = 0;
-    const int row = savedList_->currentRow();
-    if (row >= 0 && row < static_cast<int>(savedPuzzles_.size())) {
-        const auto& saved = savedPuzzles_[row];
-        if (saved.type == SavedPuzzle::Type::Sudoku && saved.sudoku) {
-            sudokuName = QString::fromStdString(saved.sudoku->name);
-            difficulty = saved.sudoku->difficulty;
-        }
+    const int row = currentSavedRow();
+    if (const SavedPuzzle* saved = library_->puzzleAt(row); saved && saved->sudoku()) {
+        sudokuName = QString::fromStdString(saved->sudoku()->name);
+        difficulty = saved->sudoku()->difficulty;
     }
     if (sudokuName.trimmed().isEmpty()) {
         sudokuName = "Sudoku";
@@ -1168,66 +1204,65 @@ void MazeWindow::saveSudokuImage() {
     const int imageWidth = gridWidth + padding * 2;
     const int imageHeight = gridHeight + padding * 2 + headerHeight;
 
-    QImage image(imageWidth, imageHeight, QImage::Format_ARGB32);
-    image.fill(mazeBackgroundColor_);
-
-    QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing, true);
-    painter.setRenderHint(QPainter::TextAntialiasing, true);
-
-    if (!title.isEmpty()) {
-        painter.setFont(titleFont);
-        painter.setPen(mazeWallColor_);
-        painter.drawText(QRect(padding, padding / 2, imageWidth - padding * 2, headerHeight),
-                         Qt::AlignLeft | Qt::AlignVCenter, title);
+    const QString suggested = sudokuName.isEmpty()
+        ? QString("sudoku.png")
+        : sudokuName + ".png";
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this, "Save Sudoku Image", suggested, kPictureFilters, &selectedFilter);
+    if (path.isEmpty()) {
+        return;
     }
 
-    const int offsetX = padding;
-    const int offsetY = padding + headerHeight;
+    auto paint = [&](QPainter& painter) {
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setRenderHint(QPainter::TextAntialiasing, true);
 
-    painter.setFont(numberFont);
-    const QColor blockShade = mazeBackgroundColor_.lighter(108);
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            const QRect tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
-            if (((r / 3) + (c / 3)) % 2 == 0) {
-                painter.fillRect(tile, blockShade);
-            } else {
-                painter.fillRect(tile, mazeBackgroundColor_);
-            }
+        if (!title.isEmpty()) {
+            painter.setFont(titleFont);
+            painter.setPen(mazeWallColor_);
+            painter.drawText(QRect(padding, padding / 2, imageWidth - padding * 2, headerHeight),
+                             Qt::AlignLeft | Qt::AlignVCenter, title);
+        }
 
-            const int value = puzzle.grid[r][c];
-            if (value != 0) {
-                painter.setPen(mazeWallColor_);
-                painter.drawText(tile, Qt::AlignCenter, QString::number(value));
+        const int offsetX = padding;
+        const int offsetY = padding + headerHeight;
+
+        painter.setFont(numberFont);
+        const QColor blockShade = mazeBackgroundColor_.lighter(108);
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const QRect tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
+                if (((r / box) + (c / box)) % 2 == 0) {
+                    painter.fillRect(tile, blockShade);
+                } else {
+                    painter.fillRect(tile, mazeBackgroundColor_);
+                }
+
+                const int value = puzzle.grid[r][c];
+                if (value != 0) {
+                    painter.setPen(mazeWallColor_);
+                    painter.drawText(tile, Qt::AlignCenter, QString(QChar(sudokuSymbol(value))));
+                }
             }
         }
-    }
 
-    painter.setPen(QPen(mazeWallColor_, 1));
-    for (int i = 0; i <= rows; ++i) {
-        painter.drawLine(offsetX, offsetY + i * cell, offsetX + gridWidth, offsetY + i * cell);
-    }
-    for (int i = 0; i <= cols; ++i) {
-        painter.drawLine(offsetX + i * cell, offsetY, offsetX + i * cell, offsetY + gridHeight);
-    }
-
-    painter.setPen(QPen(mazeWallColor_, 3));
-    for (int i = 0; i <= rows; i += 3) {
-        painter.drawLine(offsetX, offsetY + i * cell, offsetX + gridWidth, offsetY + i * cell);
-    }
-    for (int i = 0; i <= cols; i += 3) {
-        painter.drawLine(offsetX + i * cell, offsetY, offsetX + i * cell, offsetY + gridHeight);
-    }
+        painter.setPen(QPen(mazeWallColor_, 1));
+        for (int i = 0; i <= rows; ++i) {
+            painter.drawLine(offsetX, offsetY + i * cell, offsetX + gridWidth, offsetY + i * cell);
+        }
+        for (int i = 0; i <= cols; ++i) {
+            painter.drawLine(offsetX + i * cell, offsetY, offsetX + i * cell, offsetY + gridHeight);
+        }
 
-    const QString suggested = sudokuName.isEmpty()
-        ? QString("sudoku.png")
-        : sudokuName + ".png";
-    const QString path = QFileDialog::getSaveFileName(this, "Save Sudoku Image", suggested, "PNG Images (*.png)");
-    if (path.isEmpty()) {
-        return;
-    }
-    if (!image.save(path, "PNG")) {
+        painter.setPen(QPen(mazeWallColor_, 3));
+        for (int i = 0; i <= rows; i += box) {
+            painter.drawLine(offsetX, offsetY + i * cell, offsetX + gridWidth, offsetY + i * cell);
+        }
+        for (int i = 0; i <= cols; i += box) {
+            painter.drawLine(offsetX + i * cell, offsetY, offsetX + i * cell, offsetY + gridHeight);
+        }
+    };
+    if (!savePicture(path, selectedFilter, QSize(imageWidth, imageHeight), mazeBackgroundColor_, paint)) {
         showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not save the sudoku image.");
     }
 }
@@ -1239,18 +1274,16 @@ void MazeWindow::saveCryptogramImage() {
     }
     const auto& puzzle = *currentCryptogram_;
     QString cryptoName = "cryptogram";
-    const int row = savedList_->currentRow();
-    if (row >= 0 && row < static_cast<int>(savedPuzzles_.size())) {
-        const auto& saved = savedPuzzles_[row];
-        if (saved.type == SavedPuzzle::Type::Cryptogram && saved.cryptogram) {
-            cryptoName = QString::fromStdString(saved.cryptogram->name);
-        }
+    const int row = currentSavedRow();
+    if (library_->contains(row) && library_->typeAt(row) == SavedPuzzle::Type::Cryptogram) {
+        cryptoName = QString::fromStdString(library_->nameAt(row));
     }
     
     const QString suggested = cryptoName.isEmpty()
         ? QString("cryptogram.png")
         : cryptoName + ".png";
-    const QString path = QFileDialog::getSaveFileName(this, "Save Cryptogram Image", suggested, "PNG Images (*.png)");
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this, "Save Cryptogram Image", suggested, kPictureFilters, &selectedFilter);
     if (path.isEmpty()) {
         return;
     }
@@ -1259,14 +1292,13 @@ void MazeWindow::saveCryptogramImage() {
     const int contentWidth = 900;
     const int cellSize = 32;
     const QSize measured = CryptogramWidget::renderPuzzle(nullptr, puzzle, nullptr, nullptr, nullptr, -1, false, contentWidth, padding, cellSize, nullptr, mazeWallColor_, mazeBackgroundColor_);
-    QImage image(measured.width(), measured.height(), QImage::Format_ARGB32);
-    image.fill(mazeBackgroundColor_);
-    QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing, true);
-    painter.setRenderHint(QPainter::TextAntialiasing, true);
-    CryptogramWidget::renderPuzzle(&painter, puzzle, nullptr, nullptr, nullptr, -1, false, contentWidth, padding, cellSize, nullptr, mazeWallColor_, mazeBackgroundColor_);
+    auto paint = [&](QPainter& painter) {
+        painter.setRenderHint(QPainter::Antialiasing, true);
+        painter.setRenderHint(QPainter::TextAntialiasing, true);
+        CryptogramWidget::renderPuzzle(&painter, puzzle, nullptr, nullptr, nullptr, -1, false, contentWidth, padding, cellSize, nullptr, mazeWallColor_, mazeBackgroundColor_);
+    };
     
-    if (!image.save(path, "PNG")) {
+    if (!savePicture(path, selectedFilter, measured, mazeBackgroundColor_, paint)) {
         showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not save the cryptogram image.");
     }
 }
@@ -1342,7 +1374,7 @@ void MazeWindow::updateStatus() {
 
     QString mazeName = "—";
     if (!game_.hasMaze() || activeMode_ != ActiveMode::Maze) {
-    updateStatusBarText(savedList_->count() == 0
+    updateStatusBarText(library_->isEmpty()
         ? "No saved puzzles yet. Click New Puzzle to create one."
         : "Select a puzzle and use Play/Restart to test.");
         coordLabel_->setVisible(false);
@@ -1351,8 +1383,8 @@ void MazeWindow::updateStatus() {
     coordLabel_->setVisible(true);
 
     const int idx = loadedIndex_;
-    if (idx >= 0 && idx < static_cast<int>(savedPuzzles_.size()) && savedPuzzles_[idx].maze) {
-        mazeName = QString::fromStdString(savedPuzzles_[idx].maze->name);
+    if (library_->contains(idx) && library_->typeAt(idx) == SavedPuzzle::Type::Maze) {
+        mazeName = QString::fromStdString(library_->nameAt(idx));
     }
     updateStatusBarText("");
 
@@ -1543,22 +1575,22 @@ void MazeWindow::cancelGenerator() {
 void MazeWindow::handleSelectionChanged(const int ) {
     saveActiveProgress();
     
-    const int row = savedList_->currentRow();
+    const int row = currentSavedRow();
     refreshActions();
 
-    if (row >= 0 && row < static_cast<int>(savedPuzzles_.size())) {
-        const auto& puzzle = savedPuzzles_[row];
+    if (library_->contains(row)) {
+        const SavedPuzzle& puzzle = *library_->puzzleAt(row);
         
-        if (puzzle.type == SavedPuzzle::Type::Maze && puzzle.maze) {
-            const auto& saved = *puzzle.maze;
+        if (puzzle.maze()) {
+            const auto& saved = *puzzle.maze();
             puzzleViewStack_->setCurrentWidget(mazeView_);
             coordLabel_->setVisible(false);
             activeMode_ = ActiveMode::None;
             mazeWidget_->setGraph(saved.graph, false, false, saved.entranceNode, saved.exitNode, saved.playerNode);
             updateStatusBarText("Right-click a puzzle in the list and choose Test to start.");
             crosswordWidget_->clear();
-        } else if (puzzle.type == SavedPuzzle::Type::Crossword && puzzle.crossword) {
-            const auto& saved = *puzzle.crossword;
+        } else if (puzzle.crossword()) {
+            const auto& saved = *puzzle.crossword();
             activeMode_ = ActiveMode::None;
             mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
             coordLabel_->setVisible(false);
@@ -1567,8 +1599,8 @@ void MazeWindow::handleSelectionChanged(const int ) {
             lastCrosswordHints_ = saved.hints;
             showCrossword(saved.puzzle);
             updateStatusBarText("Right-click to export crossword image.");
-        } else if (puzzle.type == SavedPuzzle::Type::WordSearch && puzzle.wordSearch) {
-            const auto& saved = *puzzle.wordSearch;
+        } else if (puzzle.wordSearch()) {
+            const auto& saved = *puzzle.wordSearch();
             activeMode_ = ActiveMode::None;
             mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
             coordLabel_->setVisible(false);
@@ -1577,8 +1609,8 @@ void MazeWindow::handleSelectionChanged(const int ) {
             currentWordSearch_ = saved.puzzle;
             showWordSearch(saved.puzzle);
             updateStatusBarText("Word search puzzle ready.");
-        } else if (puzzle.type == SavedPuzzle::Type::Sudoku && puzzle.sudoku) {
-            const auto& saved = *puzzle.sudoku;
+        } else if (puzzle.sudoku()) {
+            const auto& saved = *puzzle.sudoku();
             activeMode_ = ActiveMode::None;
             mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
             coordLabel_->setVisible(false);
@@ -1587,8 +1619,8 @@ void MazeWindow::handleSelectionChanged(const int ) {
             currentSudoku_ = saved.puzzle;
             showSudoku(saved.puzzle);
             updateStatusBarText("Sudoku puzzle ready.");
-        } else if (puzzle.type == SavedPuzzle::Type::Cryptogram && puzzle.cryptogram) {
-            const auto& saved = *puzzle.cryptogram;
+        } else if (puzzle.cryptogram()) {
+            const auto& saved = *puzzle.cryptogram();
             activeMode_ = ActiveMode::None;
             mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
             coordLabel_->setVisible(false);
@@ -1601,7 +1633,7 @@ void MazeWindow::handleSelectionChanged(const int ) {
     } else {
         mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
         coordLabel_->setVisible(false);
-        updateStatusBarText(savedList_->count() == 0
+        updateStatusBarText(library_->isEmpty()
             ? "No saved puzzles yet. Click New Puzzle to create one."
             : "Right-click a puzzle in the list and choose Test to start.");
     }
@@ -1610,40 +1642,22 @@ void MazeWindow::handleSelectionChanged(const int ) {
 }
 
 void MazeWindow::deleteSelected() {
-    const int row = savedList_->currentRow();
-    if (row < 0 || row >= static_cast<int>(savedPuzzles_.size())) {
+    const int row = currentSavedRow();
+    if (!library_->contains(row)) {
         return;
     }
     
     const bool wasInTestMode = inTestMode_;
     const int deletedIndex = loadedIndex_;
 
-    if (savedPuzzles_[row].type == SavedPuzzle::Type::Maze && savedPuzzles_[row].maze) {
-        auto it = std::find_if(savedMazes_.begin(), savedMazes_.end(), 
-            [&](const SavedMaze& m) { return m.name == savedPuzzles_[row].maze->name; });
-        if (it != savedMazes_.end()) {
-            savedMazes_.erase(it);
-        }
-    } else if (savedPuzzles_[row].type == SavedPuzzle::Type::Sudoku) {
-        
-    } else if (savedPuzzles_[row].type == SavedPuzzle::Type::Cryptogram && savedPuzzles_[row].cryptogram) {
-        auto it = std::find_if(savedCryptograms_.begin(), savedCryptograms_.end(),
-            [&](const SavedCryptogram& c) { return c.name == savedPuzzles_[row].cryptogram->name; });
-        if (it != savedCryptograms_.end()) {
-            savedCryptograms_.erase(it);
-        }
-    }
-    
-    savedPuzzles_.erase(savedPuzzles_.begin() + row);
-    delete savedList_->takeItem(row);
+    library_->remove(row);
     
     if (wasInTestMode && deletedIndex == row) {
         clearActivePuzzle();
     }
 
-    if (savedList_->count() > 0) {
-        const int nextRow = std::min(row, savedList_->count() - 1);
-        savedList_->setCurrentRow(nextRow);
+    if (!library_->isEmpty()) {
+        setCurrentSavedRow(std::min(row, library_->count() - 1));
     } else {
         clearActivePuzzle();
     }
@@ -1653,19 +1667,19 @@ void MazeWindow::deleteSelected() {
 }
 
 void MazeWindow::loadMaze(const int index) {
-    if (index < 0 || index >= static_cast<int>(savedPuzzles_.size())) {
+    if (!library_->contains(index)) {
         clearActivePuzzle();
         return;
     }
 
-    const auto& puzzle = savedPuzzles_[index];
-    if (puzzle.type != SavedPuzzle::Type::Maze || !puzzle.maze) {
+    const SavedPuzzle& puzzle = *library_->puzzleAt(index);
+    if (!puzzle.maze()) {
         return;
     }
 
     inTestMode_ = true;
     activeMode_ = ActiveMode::Maze;
-    const auto& saved = *puzzle.maze;
+    const auto& saved = *puzzle.maze();
     game_.load(saved.graph, saved.entranceNode, saved.exitNode, saved.playerNode);
     mazeWidget_->setGraph(game_.graph(), game_.tested(), true, game_.entranceNode(), game_.exitNode(), game_.playerNode());
     puzzleViewStack_->setCurrentWidget(mazeView_);
@@ -1685,19 +1699,19 @@ void MazeWindow::loadMaze(const int index) {
 }
 
 void MazeWindow::loadCrossword(const int index) {
-    if (index < 0 || index >= static_cast<int>(savedPuzzles_.size())) {
+    if (!library_->contains(index)) {
         clearActivePuzzle();
         return;
     }
 
-    const auto& puzzle = savedPuzzles_[index];
-    if (puzzle.type != SavedPuzzle::Type::Crossword || !puzzle.crossword) {
+    const SavedPuzzle& puzzle = *library_->puzzleAt(index);
+    if (!puzzle.crossword()) {
         return;
     }
 
     inTestMode_ = true;
     activeMode_ = ActiveMode::Crossword;
-    const auto& saved = *puzzle.crossword;
+    const auto& saved = *puzzle.crossword();
     game_ = MazeGame{};
     mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
     coordLabel_->setVisible(false);
@@ -1716,19 +1730,19 @@ void MazeWindow::loadCrossword(const int index) {
 }
 
 void MazeWindow::loadWordSearch(const int index) {
-    if (index < 0 || index >= static_cast<int>(savedPuzzles_.size())) {
+    if (!library_->contains(index)) {
         clearActivePuzzle();
         return;
     }
 
-    const auto& puzzle = savedPuzzles_[index];
-    if (puzzle.type != SavedPuzzle::Type::WordSearch || !puzzle.wordSearch) {
+    const SavedPuzzle& puzzle = *library_->puzzleAt(index);
+    if (!puzzle.wordSearch()) {
         return;
     }
 
     inTestMode_ = true;
     activeMode_ = ActiveMode::WordSearch;
-    const auto& saved = *puzzle.wordSearch;
+    const auto& saved = *puzzle.wordSearch();
     game_ = MazeGame{};
     mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
     coordLabel_->setVisible(false);
@@ -1746,19 +1760,19 @@ void MazeWindow::loadWordSearch(const int index) {
 }
 
 void MazeWindow::loadSudoku(const int index) {
-    if (index < 0 || index >= static_cast<int>(savedPuzzles_.size())) {
+    if (!library_->contains(index)) {
         clearActivePuzzle();
         return;
     }
 
-    const auto& puzzle = savedPuzzles_[index];
-    if (puzzle.type != SavedPuzzle::Type::Sudoku || !puzzle.sudoku) {
+    const SavedPuzzle& puzzle = *library_->puzzleAt(index);
+    if (!puzzle.sudoku()) {
         return;
     }
 
     inTestMode_ = true;
     activeMode_ = ActiveMode::Sudoku;
-    const auto& saved = *puzzle.sudoku;
+    const auto& saved = *puzzle.sudoku();
     game_ = MazeGame{};
     mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
     coordLabel_->setVisible(false);
@@ -1776,13 +1790,13 @@ void MazeWindow::loadSudoku(const int index) {
 }
 
 void MazeWindow::loadCryptogram(const int index) {
-    if (index < 0 || index >= static_cast<int>(savedPuzzles_.size())) {
+    if (!library_->contains(index)) {
         clearActivePuzzle();
         return;
     }
     
-    const auto& puzzle = savedPuzzles_[index];
-    if (puzzle.type != SavedPuzzle::Type::Cryptogram || !puzzle.cryptogram) {
+    const SavedPuzzle& puzzle = *library_->puzzleAt(index);
+    if (!puzzle.cryptogram()) {
         return;
     }
     
@@ -1791,12 +1805,12 @@ void MazeWindow::loadCryptogram(const int index) {
     game_ = MazeGame{};
     mazeWidget_->setGraph(MazeGraph{}, false, false, -1, -1, -1);
     coordLabel_->setVisible(false);
-    currentCryptogram_ = puzzle.cryptogram->puzzle;
+    currentCryptogram_ = puzzle.cryptogram()->puzzle;
     currentCrossword_.reset();
     currentWordSearch_.reset();
     currentSudoku_.reset();
     puzzleViewStack_->setCurrentWidget(cryptogramView_);
-    cryptogramWidget_->setPuzzle(puzzle.cryptogram->puzzle);
+    cryptogramWidget_->setPuzzle(puzzle.cryptogram()->puzzle);
     cryptogramWidget_->setTestMode(true);
     loadedIndex_ = index;
     updateStatus();
@@ -1840,7 +1854,7 @@ void MazeWindow::clearActivePuzzle() {
 }
 
 void MazeWindow::refreshActions() {
-    const bool canPlay = savedList_ && savedList_->currentRow() >= 0 && savedList_->currentRow() < savedList_->count();
+    const bool canPlay = currentSavedRow() >= 0;
     if (playAction_) playAction_->setEnabled(canPlay);
     if (endTestAction_) endTestAction_->setEnabled(inTestMode_);
     if (saveImageAction_) saveImageAction_->setEnabled(canPlay);
@@ -1864,6 +1878,7 @@ QString MazeWindow::sudokuDifficultyLabel(const int difficulty) const {
         case 0: return "Easy";
         case 1: return "Medium";
         case 2: return "Hard";
+        case 3: return "Expert";
         default: return "Custom";
     }
 }
@@ -1881,6 +1896,16 @@ void MazeWindow::createMenusAndToolbars() {
     saveImageAction_ = fileMenu->addAction("Save as Image...");
     connect(saveImageAction_, &QAction::triggered, this, &MazeWindow::saveSelectedImage);
 
+    fileMenu->addSeparator();
+    QAction* importAction = fileMenu->addAction("Import Library...");
+    connect(importAction, &QAction::triggered, this, &MazeWindow::importLibrary);
+    QAction* exportAction = fileMenu->addAction("Export Library...");
+    connect(exportAction, &QAction::triggered, this, &MazeWindow::exportLibrary);
+    QAction* sudokuBatchAction = fileMenu->addAction("Generate Sudoku Batch...");
+    connect(sudokuBatchAction, &QAction::triggered, this, &MazeWindow::generateSudokuBatch);
+    QAction* sudokuImportAction = fileMenu->addAction("Import Sudoku List...");
+    connect(sudokuImportAction, &QAction::triggered, this, &MazeWindow::importSudokuList);
+
     fileMenu->addSeparator();
     exitAction_ = fileMenu->addAction("Exit");
     exitAction_->setShortcut(QKeySequence::Quit);
@@ -1902,6 +1927,12 @@ void MazeWindow::createMenusAndToolbars() {
     auto* hexColorsAction = viewMenu->addAction("Set Colors (Hex)...");
     connect(hexColorsAction, &QAction::triggered, this, &MazeWindow::pickMazeColorsHex);
     viewMenu->addSeparator();
+    auto* sudokuMarksAction = viewMenu->addAction("Sudoku Pencil Marks");
+    sudokuMarksAction->setCheckable(true);
+    connect(sudokuMarksAction, &QAction::toggled, this, [this](const bool show) {
+        if (sudokuWidget_) sudokuWidget_->setShowCandidates(show);
+    });
+    viewMenu->addSeparator();
     zoomInAction_ = viewMenu->addAction("Zoom In");
     zoomInAction_->setShortcuts({
         QKeySequence::ZoomIn,                                
@@ -1941,6 +1972,7 @@ void MazeWindow::applyMazeColors() {
     if (wordSearchWidget_) wordSearchWidget_->setColors(mazeWallColor_, mazeBackgroundColor_);
     if (sudokuWidget_) sudokuWidget_->setColors(mazeWallColor_, mazeBackgroundColor_);
     if (cryptogramWidget_) cryptogramWidget_->setColors(mazeWallColor_, mazeBackgroundColor_);
+    if (thumbnailer_) thumbnailer_->setColors(mazeWallColor_, mazeBackgroundColor_);
 }
 
 bool MazeWindow::eventFilter(QObject* watched, QEvent* event) {
@@ -2056,18 +2088,39 @@ void MazeWindow::updateStatusBarText(const QString& message) {
 }
 
 void MazeWindow::closeEvent(QCloseEvent* event) {
-    saveActiveProgress();
-    persistState();
+    submitState();
+    persistence_->flush();
     QMainWindow::closeEvent(event);
     if (event->isAccepted()) {
         QCoreApplication::quit();
     }
 }
 
+int MazeWindow::currentSavedRow() const {
+    return savedModel_ ? savedModel_->libraryRow(savedList_->currentIndex().row()) : -1;
+}
+
+void MazeWindow::setCurrentSavedRow(const int row, const bool notify) {
+    if (library_->contains(row) && savedModel_->viewRow(row) < 0) {
+        savedSearch_->clear();
+    }
+    const bool wasQuiet = quietSelection_;
+    quietSelection_ = !notify;
+    const int viewRow = savedModel_->viewRow(row);
+    if (viewRow >= 0) {
+        const QModelIndex index = savedModel_->index(viewRow);
+        savedList_->setCurrentIndex(index);
+        savedList_->scrollTo(index);
+    } else {
+        savedList_->clearSelection();
+        savedList_->setCurrentIndex(QModelIndex());
+    }
+    quietSelection_ = wasQuiet;
+}
+
 void MazeWindow::goHome() {
     saveActiveProgress();
-    savedList_->clearSelection();
-    savedList_->setCurrentRow(-1);
+    setCurrentSavedRow(-1);
     clearActivePuzzle();
 }
 
@@ -2095,7 +2148,7 @@ switch (activeMode_) {
 
 std::unique_ptr<QWidget> tempWidget;
 if (!widgetToRender) {
-    const int selectedRow = savedList_ ? savedList_->currentRow() : -1;
+    const int selectedRow = currentSavedRow();
     tempWidget = makeRenderWidgetForSelection(selectedRow);
     widgetToRender = tempWidget.get();
 }
@@ -2135,64 +2188,59 @@ bool MazeWindow::renderActivePuzzleIfAvailable() {
         case ActiveMode::Cryptogram: return static_cast<bool>(currentCryptogram_);
         case ActiveMode::Maze: return game_.hasMaze();
         default: {
-            const int row = savedList_ ? savedList_->currentRow() : -1;
-            if (row < 0 || row >= static_cast<int>(savedPuzzles_.size())) return false;
-            const auto& p = savedPuzzles_[row];
-            return (p.type == SavedPuzzle::Type::Maze && p.maze) ||
-                   (p.type == SavedPuzzle::Type::Crossword && p.crossword) ||
-                   (p.type == SavedPuzzle::Type::WordSearch && p.wordSearch) ||
-                   (p.type == SavedPuzzle::Type::Sudoku && p.sudoku) ||
-                   (p.type == SavedPuzzle::Type::Cryptogram && p.cryptogram);
+            const int row = currentSavedRow();
+            if (!library_->contains(row)) return false;
+            return savedPuzzleHasBody(*library_->puzzleAt(row));
         }
     }
 }
 
-std::unique_ptr<QWidget> MazeWindow::makeRenderWidgetForSelection(const int row) const {
-    if (row < 0 || row >= static_cast<int>(savedPuzzles_.size())) {
+std::unique_ptr<QWidget> MazeWindow::makeRenderWidgetForSelection(const int row) {
+    if (!library_->contains(row)) {
         return nullptr;
     }
-    const auto& p = savedPuzzles_[row];
+    const SavedPuzzle& p = *library_->puzzleAt(row);
     switch (p.type) {
         case SavedPuzzle::Type::Maze:
-            if (p.maze) {
+            if (p.maze()) {
                 auto w = std::make_unique<MazeWidget>();
                 w->setColors(mazeWallColor_, mazeBackgroundColor_);
-                w->setGraph(p.maze->graph, false, false, p.maze->entranceNode, p.maze->exitNode, p.maze->playerNode);
+                w->setGraph(p.maze()->graph, false, false, p.maze()->entranceNode, p.maze()->exitNode, p.maze()->playerNode);
                 return w;
             }
             break;
         case SavedPuzzle::Type::Crossword:
-            if (p.crossword) {
+            if (p.crossword()) {
                 auto w = std::make_unique<CrosswordWidget>();
                 w->setColors(mazeWallColor_, mazeBackgroundColor_);
-                w->setPuzzle(p.crossword->puzzle);
+                w->setPuzzle(p.crossword()->puzzle);
                 w->setTestMode(false);
                 return w;
             }
             break;
         case SavedPuzzle::Type::WordSearch:
-            if (p.wordSearch) {
+            if (p.wordSearch()) {
                 auto w = std::make_unique<WordSearchWidget>();
                 w->setColors(mazeWallColor_, mazeBackgroundColor_);
-                w->setPuzzle(p.wordSearch->puzzle);
+                w->setPuzzle(p.wordSearch()->puzzle);
                 w->setTestMode(false);
                 return w;
             }
             break;
         case SavedPuzzle::Type::Sudoku:
-            if (p.sudoku) {
+            if (p.sudoku()) {
                 auto w = std::make_unique<SudokuWidget>();
                 w->setColors(mazeWallColor_, mazeBackgroundColor_);
-                w->setPuzzle(p.sudoku->puzzle);
+                w->setPuzzle(p.sudoku()->puzzle);
                 w->setTestMode(false);
                 return w;
             }
             break;
         case SavedPuzzle::Type::Cryptogram:
-            if (p.cryptogram) {
+            if (p.cryptogram()) {
                 auto w = std::make_unique<CryptogramWidget>();
                 w->setColors(mazeWallColor_, mazeBackgroundColor_);
-                w->setPuzzle(p.cryptogram->puzzle);
+                w->setPuzzle(p.cryptogram()->puzzle);
                 w->setTestMode(false);
                 w->setFixedSize(w->sizeHint());
                 return w;
@@ -2208,28 +2256,8 @@ void MazeWindow::printActivePuzzle() {
 
     
     QString docName = "puzzle";
-    if (savedList_ && savedList_->currentRow() >= 0 && savedList_->currentRow() < savedList_->count()) {
-        const int row = savedList_->currentRow();
-        if (row >= 0 && row < static_cast<int>(savedPuzzles_.size())) {
-            const auto& p = savedPuzzles_[row];
-            switch (p.type) {
-                case SavedPuzzle::Type::Maze:
-                    if (p.maze) docName = QString::fromStdString(p.maze->name);
-                    break;
-                case SavedPuzzle::Type::Crossword:
-                    if (p.crossword) docName = QString::fromStdString(p.crossword->name);
-                    break;
-                case SavedPuzzle::Type::WordSearch:
-                    if (p.wordSearch) docName = QString::fromStdString(p.wordSearch->name);
-                    break;
-                case SavedPuzzle::Type::Sudoku:
-                    if (p.sudoku) docName = QString::fromStdString(p.sudoku->name);
-                    break;
-                case SavedPuzzle::Type::Cryptogram:
-                    if (p.cryptogram) docName = QString::fromStdString(p.cryptogram->name);
-                    break;
-            }
-        }
+    if (const int row = currentSavedRow(); library_->contains(row)) {
+        docName = QString::fromStdString(library_->nameAt(row));
     }
     printer.setDocName(docName);
 
@@ -2286,12 +2314,11 @@ void MazeWindow::printPreviewActivePuzzle() {
 }
 
 void MazeWindow::showContextMenu(const QPoint& pos) {
-    const auto item = savedList_->itemAt(pos);
-    if (!item) {
+    const int row = savedModel_->libraryRow(savedList_->indexAt(pos).row());
+    if (!library_->contains(row)) {
         return;
     }
-    const int row = savedList_->row(item);
-    savedList_->setCurrentRow(row);
+    setCurrentSavedRow(row);
 
     QMenu menu(this);
     const bool isActiveRow = inTestMode_ && row == loadedIndex_;
@@ -2313,62 +2340,62 @@ void MazeWindow::showContextMenu(const QPoint& pos) {
 
 void MazeWindow::testSelected() {
     saveActiveProgress();
-    const int row = savedList_->currentRow();
-    if (row < 0 || row >= static_cast<int>(savedPuzzles_.size())) {
+    const int row = currentSavedRow();
+    if (!library_->contains(row)) {
         return;
     }
-    const auto& puzzle = savedPuzzles_[row];
-    if (puzzle.type == SavedPuzzle::Type::Maze) {
+    const auto type = library_->typeAt(row);
+    if (type == SavedPuzzle::Type::Maze) {
         loadMaze(row);
-    } else if (puzzle.type == SavedPuzzle::Type::Crossword) {
+    } else if (type == SavedPuzzle::Type::Crossword) {
         loadCrossword(row);
-    } else if (puzzle.type == SavedPuzzle::Type::WordSearch) {
+    } else if (type == SavedPuzzle::Type::WordSearch) {
         loadWordSearch(row);
-    } else if (puzzle.type == SavedPuzzle::Type::Sudoku) {
+    } else if (type == SavedPuzzle::Type::Sudoku) {
         loadSudoku(row);
-    } else if (puzzle.type == SavedPuzzle::Type::Cryptogram) {
+    } else if (type == SavedPuzzle::Type::Cryptogram) {
         loadCryptogram(row);
     }
 }
 
 void MazeWindow::saveSelectedImage() {
     saveActiveProgress();
-    const int row = savedList_->currentRow();
-    if (row < 0 || row >= static_cast<int>(savedPuzzles_.size())) {
+    const int row = currentSavedRow();
+    if (!library_->contains(row)) {
         return;
     }
     
-    const auto& puzzle = savedPuzzles_[row];
-    if (puzzle.type == SavedPuzzle::Type::Crossword && puzzle.crossword) {
-        currentCrossword_ = puzzle.crossword->puzzle;
-        lastCrosswordHints_ = puzzle.crossword->hints;
+    const SavedPuzzle& puzzle = *library_->puzzleAt(row);
+    if (puzzle.crossword()) {
+        currentCrossword_ = puzzle.crossword()->puzzle;
+        lastCrosswordHints_ = puzzle.crossword()->hints;
         saveCrosswordImage();
         return;
     }
     
-    if (puzzle.type == SavedPuzzle::Type::WordSearch && puzzle.wordSearch) {
-        currentWordSearch_ = puzzle.wordSearch->puzzle;
+    if (puzzle.wordSearch()) {
+        currentWordSearch_ = puzzle.wordSearch()->puzzle;
         saveWordSearchImage();
         return;
     }
     
-    if (puzzle.type == SavedPuzzle::Type::Sudoku && puzzle.sudoku) {
-        currentSudoku_ = puzzle.sudoku->puzzle;
+    if (puzzle.sudoku()) {
+        currentSudoku_ = puzzle.sudoku()->puzzle;
         saveSudokuImage();
         return;
     }
     
-    if (puzzle.type == SavedPuzzle::Type::Cryptogram && puzzle.cryptogram) {
-        currentCryptogram_ = puzzle.cryptogram->puzzle;
+    if (puzzle.cryptogram()) {
+        currentCryptogram_ = puzzle.cryptogram()->puzzle;
         saveCryptogramImage();
         return;
     }
     
-    if (puzzle.type != SavedPuzzle::Type::Maze || !puzzle.maze) {
+    if (!puzzle.maze()) {
         return;
     }
     
-    const auto& saved = *puzzle.maze;
+    const auto& saved = *puzzle.maze();
     const auto& graph = saved.graph;
     const int rows = graph.rows;
     const int cols = graph.cols;
@@ -2376,396 +2403,357 @@ void MazeWindow::saveSelectedImage() {
         return;
     }
 
-    const int cell = 10;
-    QImage image(cols * cell, rows * cell, QImage::Format_ARGB32);
-    image.fill(mazeBackgroundColor_);
+    const QString suggested = QString::fromStdString(saved.name).isEmpty()
+        ? QString("maze.png")
+        : QString::fromStdString(saved.name) + ".png";
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this,
+                                                      "Save Maze Image",
+                                                      suggested,
+                                                      QString(kPictureFilters) + ";;PBM Bitmaps (*.pbm)",
+                                                      &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
 
-    QPainter painter(&image);
-    const int lineWidth = std::max(2, cell / 8);
-    painter.setRenderHint(QPainter::Antialiasing, false);
-    painter.setPen(QPen(mazeWallColor_, lineWidth, Qt::SolidLine, Qt::FlatCap, Qt::MiterJoin));
-
-    auto nodeId = [cols](int r, int c) { return r * cols + c; };
-    auto isOpen = [&](int a, int b) {
-        const int idx = edge_index_between(graph, a, b);
-        return idx >= 0 && graph.edges[idx].open;
+    auto nodeCell = [&graph](const int nodeIndex) {
+        if (nodeIndex < 0 || nodeIndex >= static_cast<int>(graph.nodes.size())) {
+            return std::pair<int, int>{-1, -1};
+        }
+        const auto& n = graph.nodes[nodeIndex];
+        return std::pair<int, int>{n.row, n.col};
     };
 
-    
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols - 1; ++c) {
-            if (!isOpen(nodeId(r, c), nodeId(r, c + 1))) {
-                const int x = (c + 1) * cell;
-                painter.drawLine(x, r * cell, x, (r + 1) * cell);
-            }
-        }
+    MazeRasterStyle style;
+    style.cellPx = 10;
+    style.wallRgb = mazeWallColor_.rgb() & 0xffffffu;
+    style.backgroundRgb = mazeBackgroundColor_.rgb() & 0xffffffu;
+    style.entranceCell = nodeCell(saved.entranceNode);
+    style.exitCell = nodeCell(saved.exitNode);
+    const MazeWalls walls = make_maze_walls(graph);
+
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    bool ok = false;
+    switch (pictureFormatFor(path, selectedFilter)) {
+        case PictureFormat::Svg:
+            ok = writeVectorSvg(makeMazeVectorDocument(walls, style), path);
+            break;
+        case PictureFormat::Pdf:
+            ok = writeVectorPdf(makeMazeVectorDocument(walls, style), path);
+            break;
+        case PictureFormat::Pbm:
+            ok = exportMazeRaster(walls, style, MazeRasterFormat::Pbm, QFile::encodeName(path).toStdString());
+            break;
+        case PictureFormat::Png:
+            ok = exportMazeRaster(walls, style, MazeRasterFormat::Png, QFile::encodeName(path).toStdString());
+            break;
     }
-    for (int r = 0; r < rows - 1; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            if (!isOpen(nodeId(r, c), nodeId(r + 1, c))) {
-                const int y = (r + 1) * cell;
-                painter.drawLine(c * cell, y, (c + 1) * cell, y);
-            }
-        }
+    QApplication::restoreOverrideCursor();
+    if (!ok) {
+        showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not save the maze image.");
     }
+}
 
-    
-    painter.drawLine(0, 0, cols * cell, 0);
-    painter.drawLine(0, rows * cell, cols * cell, rows * cell);
-    painter.drawLine(0, 0, 0, rows * cell);
-    painter.drawLine(cols * cell, 0, cols * cell, rows * cell);
+void MazeWindow::exportLibrary() {
+    saveActiveProgress();
+    if (library_->isEmpty()) {
+        showSizedMessage(this, QMessageBox::Warning, "Export Failed", "Nothing to export.");
+        return;
+    }
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this,
+                                                      "Export Library",
+                                                      "library.puzzles",
+                                                      "Puzzle Library (*.puzzles);;JSON Library (*.json)",
+                                                      &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
 
-    auto carveGap = [&](int nodeIndex) {
-        if (nodeIndex < 0 || nodeIndex >= static_cast<int>(graph.nodes.size())) return;
-        const auto& n = graph.nodes[nodeIndex];
-        const int x = n.col * cell;
-        const int y = n.row * cell;
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(mazeBackgroundColor_);
-        const int gapW = std::max(lineWidth, cell - lineWidth * 2);
-        const int outerLineWidth = lineWidth * 2;
-        if (n.row == 0) {
-            painter.drawRect(QRect(x + (cell - gapW) / 2, y - outerLineWidth, gapW, outerLineWidth * 2));
-        } else if (n.row == rows - 1) {
-            painter.drawRect(QRect(x + (cell - gapW) / 2, y + cell - outerLineWidth, gapW, outerLineWidth * 2));
-        } else if (n.col == 0) {
-            painter.drawRect(QRect(x - outerLineWidth, y + (cell - gapW) / 2, outerLineWidth * 2, gapW));
-        } else if (n.col == cols - 1) {
-            painter.drawRect(QRect(x + cell - outerLineWidth, y + (cell - gapW) / 2, outerLineWidth * 2, gapW));
-        }
-    };
+    const std::vector<SavedPuzzle> puzzles = library_->materializeAll();
 
-    carveGap(saved.entranceNode);
-    carveGap(saved.exitNode);
+    const bool json = path.endsWith(".json", Qt::CaseInsensitive)
+        || (!path.endsWith(".puzzles", Qt::CaseInsensitive) && selectedFilter.startsWith("JSON"));
+    bool ok = false;
+    if (json) {
+        QSaveFile file(path);
+        ok = file.open(QIODevice::WriteOnly | QIODevice::Truncate)
+            && file.write(libraryToJsonDocument(puzzles)) >= 0
+            && file.commit();
+    } else {
+        ok = writePuzzleArchive(path, puzzles);
+    }
+    if (!ok) {
+        showSizedMessage(this, QMessageBox::Warning, "Export Failed", "Could not write the library file.");
+    }
+}
 
-    const QString suggested = QString::fromStdString(saved.name).isEmpty()
-        ? QString("maze.png")
-        : QString::fromStdString(saved.name) + ".png";
-    const QString path = QFileDialog::getSaveFileName(this, "Save Maze Image", suggested, "PNG Images (*.png)");
+void MazeWindow::importLibrary() {
+    const QString path = QFileDialog::getOpenFileName(this,
+                                                      "Import Library",
+                                                      QString(),
+                                                      "Puzzle Libraries (*.puzzles *.json);;All Files (*)");
     if (path.isEmpty()) {
         return;
     }
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        showSizedMessage(this, QMessageBox::Warning, "Import Failed", "Could not open the library file.");
+        return;
+    }
 
-    if (!image.save(path, "PNG")) {
-        showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not save the maze image.");
+    std::optional<std::vector<SavedPuzzle>> puzzles;
+    if (isPuzzleArchive(file.peek(4))) {
+        file.close();
+        puzzles = readPuzzleArchive(path);
+    } else {
+        puzzles = libraryFromJsonDocument(file.readAll());
+    }
+    if (!puzzles) {
+        showSizedMessage(this, QMessageBox::Warning, "Import Failed", "The file is not a valid puzzle library.");
+        return;
     }
-}
 
-QString MazeWindow::stateFilePath() const {
-    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    if (dir.isEmpty()) {
-        dir = QDir::currentPath();
+    for (auto& puzzle : *puzzles) {
+        library_->add(std::move(puzzle));
     }
-    QDir().mkpath(dir);
-    return dir + "/puzzles_state.json";
+    persistState();
+    updateStatus();
+    refreshActions();
 }
 
-void MazeWindow::persistState() const {
-    if (isRestoring_) {
+void MazeWindow::generateSudokuBatch() {
+    if (sudokuBatch_->isRunning()) {
         return;
     }
 
-    
-    const_cast<MazeWindow*>(this)->saveActiveProgress();
-
-    QJsonArray puzzles;
-
-    for (const auto& saved : savedPuzzles_) {
-        QJsonObject obj;
-        switch (saved.type) {
-            case SavedPuzzle::Type::Maze:
-                if (saved.maze) {
-                    const auto& maze = *saved.maze;
-                    obj["type"] = "maze";
-                    obj["name"] = QString::fromStdString(maze.name);
-                    obj["algorithm"] = algorithmToInt(maze.algorithm);
-                    obj["width"] = maze.width;
-                    obj["height"] = maze.height;
-                    obj["graph"] = graphToJson(maze.graph);
-                    obj["entranceNode"] = maze.entranceNode;
-                    obj["exitNode"] = maze.exitNode;
-                    obj["playerNode"] = maze.playerNode;
-                    puzzles.append(obj);
-                }
-                break;
-            case SavedPuzzle::Type::Crossword:
-                if (saved.crossword) {
-                    const auto& cw = *saved.crossword;
-                    obj["type"] = "crossword";
-                    obj["name"] = QString::fromStdString(cw.name);
-                    QJsonArray grid;
-                    for (const auto& row : cw.puzzle.grid) {
-                        grid.append(QString::fromStdString(row));
-                    }
-                    obj["grid"] = grid;
-                    obj["numbers"] = intGridToJson(cw.puzzle.numbers);
-                    QJsonArray across;
-                    for (const auto& entry : cw.puzzle.across) {
-                        QJsonObject e;
-                        e["number"] = entry.number;
-                        e["word"] = QString::fromStdString(entry.word);
-                        across.append(e);
-                    }
-                    obj["across"] = across;
-                    QJsonArray down;
-                    for (const auto& entry : cw.puzzle.down) {
-                        QJsonObject e;
-                        e["number"] = entry.number;
-                        e["word"] = QString::fromStdString(entry.word);
-                        down.append(e);
-                    }
-                    obj["down"] = down;
-                    QJsonObject hints;
-                    for (const auto& [word, hint] : cw.hints) {
-                        hints[QString::fromStdString(word)] = QString::fromStdString(hint);
-                    }
-                    obj["hints"] = hints;
-                    puzzles.append(obj);
-                }
-                break;
-            case SavedPuzzle::Type::WordSearch:
-                if (saved.wordSearch) {
-                    const auto& ws = *saved.wordSearch;
-                    obj["type"] = "wordsearch";
-                    obj["name"] = QString::fromStdString(ws.name);
-                    obj["size"] = ws.puzzle.size;
-                    QJsonArray grid;
-                    for (const auto& row : ws.puzzle.grid) {
-                        std::string rowStr(row.begin(), row.end());
-                        grid.append(QString::fromStdString(rowStr));
-                    }
-                    obj["grid"] = grid;
-                    QJsonArray words;
-                    for (const auto& word : ws.puzzle.words) {
-                        words.append(QString::fromStdString(word));
-                    }
-                    obj["words"] = words;
-                    puzzles.append(obj);
-                }
-                break;
-            case SavedPuzzle::Type::Sudoku:
-                if (saved.sudoku) {
-                    const auto& sdk = *saved.sudoku;
-                    obj["type"] = "sudoku";
-                    obj["name"] = QString::fromStdString(sdk.name);
-                    obj["difficulty"] = sdk.difficulty;
-                    obj["grid"] = intGridToJson(sdk.puzzle.grid);
-                    obj["solution"] = intGridToJson(sdk.puzzle.solution);
-                    puzzles.append(obj);
-                }
-                break;
-            case SavedPuzzle::Type::Cryptogram:
-                if (saved.cryptogram) {
-                    const auto& crypto = *saved.cryptogram;
-                    obj["type"] = "cryptogram";
-                    obj["name"] = QString::fromStdString(crypto.name);
-                    obj["plainText"] = QString::fromStdString(crypto.puzzle.plainText);
-                    obj["cipherText"] = QString::fromStdString(crypto.puzzle.cipherText);
-                    QJsonObject mapping;
-                    for (const auto& [cipher, plain] : crypto.puzzle.cipherToPlain) {
-                        mapping[QString(QChar(cipher))] = QString(QChar(plain));
-                    }
-                    obj["cipherToPlain"] = mapping;
-                    QJsonArray revealed;
-                    for (char r : crypto.puzzle.revealed) {
-                        revealed.append(QString(QChar(r)));
-                    }
-                    obj["revealed"] = revealed;
-                    obj["avoidSelfMapping"] = crypto.avoidSelfMapping;
-                    obj["hintCount"] = crypto.hintCount;
-                    puzzles.append(obj);
-                }
-                break;
+    QDialog dlg(this);
+    dlg.setWindowTitle("Generate Sudoku Batch");
+    dlg.setModal(true);
+    auto* form = new QFormLayout(&dlg);
+    auto* countSpin = new QSpinBox(&dlg);
+    countSpin->setRange(1, 100000);
+    countSpin->setValue(100);
+    auto* difficultyCombo = new QComboBox(&dlg);
+    for (int tier = 0; tier < 3; ++tier) {
+        difficultyCombo->addItem(sudokuDifficultyLabel(tier), tier);
+    }
+    auto* destinationCombo = new QComboBox(&dlg);
+    destinationCombo->addItem("Add to library");
+    destinationCombo->addItem("Write to text file");
+    form->addRow("Puzzles", countSpin);
+    form->addRow("Difficulty", difficultyCombo);
+    form->addRow("Destination", destinationCombo);
+    auto* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, &dlg);
+    form->addRow(buttons);
+    QObject::connect(buttons, &QDialogButtonBox::accepted, &dlg, &QDialog::accept);
+    QObject::connect(buttons, &QDialogButtonBox::rejected, &dlg, &QDialog::reject);
+    if (dlg.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    const int count = countSpin->value();
+    const int tier = difficultyCombo->currentData().toInt();
+    // Text output is one puzzle per line, written as each arrives so a cancelled batch keeps
+    // what it produced.
+    std::shared_ptr<QFile> file;
+    if (destinationCombo->currentIndex() == 1) {
+        const QString path = QFileDialog::getSaveFileName(this, "Save Sudoku Batch", "sudoku.txt",
+                                                          "Text Files (*.txt);;All Files (*)");
+        if (path.isEmpty()) {
+            return;
+        }
+        file = std::make_shared<QFile>(path);
+        if (!file->open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not open the output file.");
+            return;
         }
     }
 
-    QJsonObject root;
-    root["version"] = 1;
-    root["puzzles"] = puzzles;
-    root["selectedIndex"] = savedList_ ? savedList_->currentRow() : -1;
-    root["loadedIndex"] = loadedIndex_;
-    root["inTestMode"] = inTestMode_;
-    root["activeType"] = static_cast<int>(activeMode_);
+    // The progress dialog is the context of every connection below, so deleting it when the
+    // batch finishes disconnects them all.
+    auto* progressDialog = new QProgressDialog("Generating puzzles...", "Cancel", 0, count, this);
+    progressDialog->setWindowTitle("Generate Sudoku Batch");
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(0);
+    progressDialog->setAutoReset(false);
+    progressDialog->setAutoClose(false);
+    connect(progressDialog, &QProgressDialog::canceled, sudokuBatch_, &SudokuBatchGenerator::cancel);
+    // Library puzzles are collected and handed over with addBatch() on each progress tick, so the
+    // store writes them as one archive rather than one record per puzzle.
+    auto pending = std::make_shared<std::vector<SavedPuzzle>>();
+    auto writeFailed = std::make_shared<bool>(false);
+    const auto addPending = [this, pending]() {
+        if (!pending->empty()) {
+            library_->addBatch(std::move(*pending));
+            pending->clear();
+        }
+    };
+    connect(sudokuBatch_, &SudokuBatchGenerator::puzzleReady, progressDialog, [this, file, tier, pending, writeFailed](const SudokuPuzzle& puzzle) {
+        if (file) {
+            if (!*writeFailed && file->write(QByteArray::fromStdString(sudokuLine(sudokuCellsFromGrid(puzzle.grid)) + '\n')) < 0) {
+                *writeFailed = true;
+                sudokuBatch_->cancel();
+            }
+            return;
+        }
+        const QString name = QString("Sudoku %1").arg(library_->count() + static_cast<int>(pending->size()) + 1);
+        pending->push_back(SavedPuzzle(SavedSudoku{name.toStdString(), puzzle, tier}));
+    });
+    connect(sudokuBatch_, &SudokuBatchGenerator::progress, progressDialog, [progressDialog, addPending](const SudokuBatchStats& stats) {
+        addPending();
+        progressDialog->setValue(stats.accepted);
+        progressDialog->setLabelText(sudokuBatchSummary(stats));
+    });
+    connect(sudokuBatch_, &SudokuBatchGenerator::finished, progressDialog,
+            [this, progressDialog, file, addPending, writeFailed](const SudokuBatchStats& stats, const bool cancelled) {
+        progressDialog->deleteLater();
+        if (file) {
+            if (!file->flush()) {
+                *writeFailed = true;
+            }
+            file->close();
+        } else {
+            addPending();
+            persistState();
+            updateStatus();
+            refreshActions();
+        }
+        if (*writeFailed) {
+            showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not write the Sudoku batch to the output file.");
+        }
+        updateStatusBarText(QString(cancelled ? "Batch cancelled: %1" : "Batch done: %1").arg(sudokuBatchSummary(stats)));
+    });
+    sudokuBatch_->start(count, tier);
+}
 
-    QSaveFile file(stateFilePath());
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+void MazeWindow::importSudokuList() {
+    if (sudokuImporter_->isRunning()) {
+        return;
+    }
+    const QString path = QFileDialog::getOpenFileName(this, "Import Sudoku List", QString(),
+                                                      "Text Files (*.txt *.sdm);;All Files (*)");
+    if (path.isEmpty()) {
         return;
     }
-    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
-    file.commit();
+
+    // Progress is by bytes, in tenths of a percent, since lines are only counted as they are read.
+    auto* progressDialog = new QProgressDialog("Importing puzzles...", "Cancel", 0, 1000, this);
+    progressDialog->setWindowTitle("Import Sudoku List");
+    progressDialog->setWindowModality(Qt::WindowModal);
+    progressDialog->setMinimumDuration(0);
+    progressDialog->setAutoReset(false);
+    progressDialog->setAutoClose(false);
+    connect(progressDialog, &QProgressDialog::canceled, sudokuImporter_, &SudokuImporter::cancel);
+    connect(sudokuImporter_, &SudokuImporter::puzzlesReady, progressDialog, [this](const std::vector<SavedSudoku>& puzzles) {
+        std::vector<SavedPuzzle> batch;
+        batch.reserve(puzzles.size());
+        for (const auto& puzzle : puzzles) {
+            batch.emplace_back(puzzle);
+        }
+        library_->addBatch(std::move(batch));
+        // Writing each batch out right away lets the library drop its bodies as soon as that write
+        // lands, instead of the whole import staying resident until the next debounced save.
+        submitState();
+    });
+    connect(sudokuImporter_, &SudokuImporter::progress, progressDialog, [progressDialog](const SudokuImportStats& stats) {
+        if (stats.totalBytes > 0) {
+            progressDialog->setValue(static_cast<int>(stats.bytesRead * 1000 / stats.totalBytes));
+        }
+        progressDialog->setLabelText(sudokuImportSummary(stats));
+    });
+    connect(sudokuImporter_, &SudokuImporter::finished, progressDialog,
+            [this, progressDialog](const SudokuImportStats& stats, const bool cancelled) {
+        progressDialog->deleteLater();
+        persistState();
+        updateStatus();
+        refreshActions();
+        if (stats.readFailed) {
+            showSizedMessage(this, QMessageBox::Warning, "Import Failed", "Could not read the whole Sudoku list.");
+        }
+        updateStatusBarText(QString(cancelled ? "Import cancelled: %1" : "Import done: %1").arg(sudokuImportSummary(stats)));
+    });
+    if (!sudokuImporter_->start(path)) {
+        progressDialog->deleteLater();
+        showSizedMessage(this, QMessageBox::Warning, "Import Failed", "Could not open the Sudoku list.");
+    }
 }
 
-void MazeWindow::restoreState() {
-    const QString path = stateFilePath();
-    QFile file(path);
-    if (!file.exists()) {
-        return;
+QString MazeWindow::stateFilePath() const {
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::currentPath();
     }
-    if (!file.open(QIODevice::ReadOnly)) {
-        return;
+    QDir().mkpath(dir);
+    return dir + "/puzzles_state.json";
+}
+
+QString MazeWindow::libraryDirectoryPath() const {
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::currentPath();
     }
-    const auto doc = QJsonDocument::fromJson(file.readAll());
-    if (!doc.isObject()) {
-        return;
+    return dir + "/library";
+}
+
+QString MazeWindow::thumbnailDirectoryPath() const {
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (dir.isEmpty()) {
+        dir = QDir::currentPath();
     }
+    return dir + "/thumbnails";
+}
 
-    const auto root = doc.object();
-    const int version = root.value("version").toInt(0);
-    if (version != 1) {
-        file.close();
+void MazeWindow::persistState() const {
+    if (isRestoring_ || !persistence_) {
         return;
     }
-    const QJsonArray puzzles = root.value("puzzles").toArray();
+    persistence_->schedule();
+}
+
+void MazeWindow::submitState() {
+    saveActiveProgress();
+
+    PuzzleStoreSession session;
+    session.selectedIndex = currentSavedRow();
+    session.loadedIndex = loadedIndex_;
+    session.inTestMode = inTestMode_;
+    session.activeType = static_cast<int>(activeMode_);
+    library_->save(session);
+}
 
+void MazeWindow::restoreState() {
     isRestoring_ = true;
     loadedIndex_ = -1;
     inTestMode_ = false;
     activeMode_ = ActiveMode::None;
-    savedPuzzles_.clear();
-    savedMazes_.clear();
-    savedCryptograms_.clear();
-    savedList_->clear();
-
-    for (const auto& entryVal : puzzles) {
-        const QJsonObject obj = entryVal.toObject();
-        const QString type = obj.value("type").toString();
-        if (type == "maze") {
-            const auto graph = graphFromJson(obj.value("graph").toObject());
-            if (!graph) {
-                continue;
-            }
-            SavedMaze maze {
-                obj.value("name").toString("Maze").toStdString(),
-                algorithmFromInt(obj.value("algorithm").toInt(static_cast<int>(GenerationAlgorithm::DFS))),
-                obj.value("width").toInt(graph->cols),
-                obj.value("height").toInt(graph->rows),
-                *graph,
-                obj.value("entranceNode").toInt(graph->entranceNode),
-                obj.value("exitNode").toInt(graph->exitNode),
-                obj.value("playerNode").toInt(graph->entranceNode)
-            };
-            SavedPuzzle saved;
-            saved.type = SavedPuzzle::Type::Maze;
-            saved.maze = maze;
-            savedPuzzles_.push_back(saved);
-            savedMazes_.push_back(maze);
-            savedList_->addItem(QString::fromStdString(maze.name));
-        } else if (type == "crossword") {
-            SavedCrossword cw;
-            cw.name = obj.value("name").toString("Crossword").toStdString();
-            for (const auto& rowVal : obj.value("grid").toArray()) {
-                cw.puzzle.grid.push_back(rowVal.toString().toStdString());
-            }
-            cw.puzzle.numbers = intGridFromJson(obj.value("numbers").toArray());
-            for (const auto& entryValAcross : obj.value("across").toArray()) {
-                const auto eObj = entryValAcross.toObject();
-                CrosswordEntry cwEntry;
-                cwEntry.number = eObj.value("number").toInt();
-                cwEntry.word = eObj.value("word").toString().toStdString();
-                cw.puzzle.across.push_back(cwEntry);
-            }
-            for (const auto& entryValDown : obj.value("down").toArray()) {
-                const auto eObj = entryValDown.toObject();
-                CrosswordEntry cwEntry;
-                cwEntry.number = eObj.value("number").toInt();
-                cwEntry.word = eObj.value("word").toString().toStdString();
-                cw.puzzle.down.push_back(cwEntry);
-            }
-            const auto hints = obj.value("hints").toObject();
-            for (auto it = hints.begin(); it != hints.end(); ++it) {
-                cw.hints[it.key().toStdString()] = it.value().toString().toStdString();
-            }
-            if (cw.puzzle.grid.empty()) {
-                continue;
-            }
-            SavedPuzzle saved;
-            saved.type = SavedPuzzle::Type::Crossword;
-            saved.crossword = cw;
-            savedPuzzles_.push_back(saved);
-            savedList_->addItem(QString::fromStdString(cw.name));
-        } else if (type == "wordsearch") {
-            SavedWordSearch ws;
-            ws.name = obj.value("name").toString("Word Search").toStdString();
-            ws.puzzle.size = obj.value("size").toInt();
-            for (const auto& rowVal : obj.value("grid").toArray()) {
-                const auto rowStr = rowVal.toString().toStdString();
-                std::vector<char> row(rowStr.begin(), rowStr.end());
-                ws.puzzle.grid.push_back(row);
-            }
-            for (const auto& wordVal : obj.value("words").toArray()) {
-                ws.puzzle.words.push_back(wordVal.toString().toStdString());
-            }
-            if (ws.puzzle.size <= 0 || ws.puzzle.grid.empty()) {
-                continue;
-            }
-            SavedPuzzle saved;
-            saved.type = SavedPuzzle::Type::WordSearch;
-            saved.wordSearch = ws;
-            savedPuzzles_.push_back(saved);
-            savedList_->addItem(QString::fromStdString(ws.name));
-        } else if (type == "sudoku") {
-            SavedSudoku sdk;
-            sdk.name = obj.value("name").toString("Sudoku").toStdString();
-            sdk.difficulty = obj.value("difficulty").toInt(0);
-            sdk.puzzle.grid = intGridFromJson(obj.value("grid").toArray());
-            sdk.puzzle.solution = intGridFromJson(obj.value("solution").toArray());
-            if (sdk.puzzle.grid.empty()) {
-                continue;
-            }
-            SavedPuzzle saved;
-            saved.type = SavedPuzzle::Type::Sudoku;
-            saved.sudoku = sdk;
-            savedPuzzles_.push_back(saved);
-            savedList_->addItem(QString::fromStdString(sdk.name));
-        } else if (type == "cryptogram") {
-            SavedCryptogram crypto;
-            crypto.name = obj.value("name").toString("Cryptogram").toStdString();
-            crypto.puzzle.plainText = obj.value("plainText").toString().toStdString();
-            crypto.puzzle.cipherText = obj.value("cipherText").toString().toStdString();
-            const auto mapping = obj.value("cipherToPlain").toObject();
-            for (auto it = mapping.begin(); it != mapping.end(); ++it) {
-                if (!it.key().isEmpty() && !it.value().toString().isEmpty()) {
-                    crypto.puzzle.cipherToPlain[it.key().at(0).toLatin1()] = it.value().toString().at(0).toLatin1();
-                }
-            }
-            for (const auto& val : obj.value("revealed").toArray()) {
-                const auto str = val.toString();
-                if (!str.isEmpty()) {
-                    crypto.puzzle.revealed.insert(str.at(0).toLatin1());
-                }
-            }
-            crypto.avoidSelfMapping = obj.value("avoidSelfMapping").toBool(true);
-            crypto.hintCount = obj.value("hintCount").toInt(0);
-            SavedPuzzle saved;
-            saved.type = SavedPuzzle::Type::Cryptogram;
-            saved.cryptogram = crypto;
-            savedPuzzles_.push_back(saved);
-            savedCryptograms_.push_back(crypto);
-            savedList_->addItem(QString::fromStdString(crypto.name));
-        }
+    const auto session = library_->restore();
+    if (!session) {
+        isRestoring_ = false;
+        return;
     }
 
-    const int selectedIndex = root.value("selectedIndex").toInt(-1);
-    const int loadedIndex = root.value("loadedIndex").toInt(-1);
-    const bool wasTesting = root.value("inTestMode").toBool(false);
-    const auto priorMode = static_cast<ActiveMode>(root.value("activeType").toInt(0));
+    const int selectedIndex = session->selectedIndex;
+    const int loadedIndex = session->loadedIndex;
+    const bool wasTesting = session->inTestMode;
+    const auto priorMode = static_cast<ActiveMode>(session->activeType);
 
-    if (savedList_->count() == 0) {
+    if (library_->isEmpty()) {
         isRestoring_ = false;
         updateStatus();
         refreshActions();
         return;
     }
 
-    const int clampedSelected = (selectedIndex >= 0 && selectedIndex < savedList_->count())
+    const int clampedSelected = (selectedIndex >= 0 && selectedIndex < library_->count())
         ? selectedIndex
         : -1;
-    const int clampedLoaded = (loadedIndex >= 0 && loadedIndex < savedList_->count())
+    const int clampedLoaded = (loadedIndex >= 0 && loadedIndex < library_->count())
         ? loadedIndex
         : -1;
 
     if (wasTesting && clampedLoaded >= 0) {
-        savedList_->setCurrentRow(clampedLoaded);
+        setCurrentSavedRow(clampedLoaded);
         switch (priorMode) {
             case ActiveMode::Maze: loadMaze(clampedLoaded); break;
             case ActiveMode::Crossword: loadCrossword(clampedLoaded); break;
@@ -2775,10 +2763,10 @@ void MazeWindow::restoreState() {
             case ActiveMode::None: handleSelectionChanged(clampedLoaded); break;
         }
     } else if (clampedSelected >= 0) {
-        savedList_->setCurrentRow(clampedSelected);
+        setCurrentSavedRow(clampedSelected);
         handleSelectionChanged(clampedSelected);
     } else {
-        savedList_->setCurrentRow(0);
+        setCurrentSavedRow(0);
         handleSelectionChanged(0);
     }
 
@@ -2833,47 +2821,46 @@ void MazeWindow::saveCrosswordImage() {
     const int imageWidth = std::max(gridWidth, clueWidth + padding * 2);
     const int imageHeight = gridHeight + cluesHeight + padding * 3;
 
-    QImage image(imageWidth, imageHeight, QImage::Format_ARGB32);
-    image.fill(mazeBackgroundColor_);
+    const QString suggested = QString("crossword.png");
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this, "Save Crossword Image", suggested, kPictureFilters, &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
 
-    QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing, false);
-
-    const int offsetX = (imageWidth - gridWidth) / 2;
-    const int offsetY = padding;
-    painter.setFont(gridFont);
-    painter.setPen(mazeWallColor_);
-    for (int r = 0; r < rows; ++r) {
-        for (int c = 0; c < cols; ++c) {
-            const QRect tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
-            const char ch = puzzle.grid[r][c];
-            if (ch == '#') {
-                painter.fillRect(tile, mazeWallColor_);
-            } else {
-                painter.fillRect(tile, mazeBackgroundColor_);
-                const int num = puzzle.numbers.empty() ? 0 : puzzle.numbers[r][c];
-                if (num > 0) {
-                    painter.setFont(numberFont);
-                    painter.drawText(tile.adjusted(3, 1, -1, -cell / 2), Qt::AlignLeft | Qt::AlignTop, QString::number(num));
+    auto paint = [&](QPainter& painter) {
+        painter.setRenderHint(QPainter::Antialiasing, false);
+
+        const int offsetX = (imageWidth - gridWidth) / 2;
+        const int offsetY = padding;
+        painter.setFont(gridFont);
+        painter.setPen(mazeWallColor_);
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const QRect tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
+                const char ch = puzzle.grid[r][c];
+                if (ch == '#') {
+                    painter.fillRect(tile, mazeWallColor_);
+                } else {
+                    painter.fillRect(tile, mazeBackgroundColor_);
+                    const int num = puzzle.numbers.empty() ? 0 : puzzle.numbers[r][c];
+                    if (num > 0) {
+                        painter.setFont(numberFont);
+                        painter.drawText(tile.adjusted(3, 1, -1, -cell / 2), Qt::AlignLeft | Qt::AlignTop, QString::number(num));
+                    }
                 }
+                painter.setPen(QPen(mazeWallColor_, 1));
+                painter.drawRect(tile);
             }
-            painter.setPen(QPen(mazeWallColor_, 1));
-            painter.drawRect(tile);
         }
-    }
 
-    painter.setFont(clueFont);
-    painter.setPen(mazeWallColor_);
-    const int clueTop = offsetY + gridHeight + padding;
-    painter.drawText(QRect(padding, clueTop, imageWidth - padding * 2, cluesHeight / 2), Qt::AlignLeft | Qt::AlignTop, acrossText);
-    painter.drawText(QRect(padding, clueTop + cluesHeight / 2, imageWidth - padding * 2, cluesHeight / 2), Qt::AlignLeft | Qt::AlignTop, downText);
-
-    const QString suggested = QString("crossword.png");
-    const QString path = QFileDialog::getSaveFileName(this, "Save Crossword Image", suggested, "PNG Images (*.png)");
-    if (path.isEmpty()) {
-        return;
-    }
-    if (!image.save(path, "PNG")) {
+        painter.setFont(clueFont);
+        painter.setPen(mazeWallColor_);
+        const int clueTop = offsetY + gridHeight + padding;
+        painter.drawText(QRect(padding, clueTop, imageWidth - padding * 2, cluesHeight / 2), Qt::AlignLeft | Qt::AlignTop, acrossText);
+        painter.drawText(QRect(padding, clueTop + cluesHeight / 2, imageWidth - padding * 2, cluesHeight / 2), Qt::AlignLeft | Qt::AlignTop, downText);
+    };
+    if (!savePicture(path, selectedFilter, QSize(imageWidth, imageHeight), mazeBackgroundColor_, paint)) {
         showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not save the crossword image.");
     }
 }
@@ -2912,65 +2899,59 @@ void MazeWindow::saveWordSearchImage() {
     const int imageWidth = gridWidth + wordListWidth + padding * 3;
     const int imageHeight = std::max(gridHeight, wordListHeight) + padding * 2;
 
-    QImage image(imageWidth, imageHeight, QImage::Format_ARGB32);
-    image.fill(mazeBackgroundColor_);
+    const QString suggested = QString("wordsearch.png");
+    QString selectedFilter;
+    const QString path = QFileDialog::getSaveFileName(this, "Save Word Search Image", suggested, kPictureFilters, &selectedFilter);
+    if (path.isEmpty()) {
+        return;
+    }
 
-    QPainter painter(&image);
-    painter.setRenderHint(QPainter::Antialiasing, true);
+    auto paint = [&](QPainter& painter) {
+        painter.setRenderHint(QPainter::Antialiasing, true);
 
-    const int offsetX = padding;
-    const int offsetY = padding;
-    painter.setFont(gridFont);
-    painter.setPen(mazeWallColor_);
-    for (int r = 0; r < size; ++r) {
-        for (int c = 0; c < size; ++c) {
-            const QRect tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
-            painter.fillRect(tile, mazeBackgroundColor_);
-            painter.setPen(QPen(mazeWallColor_, 1));
-            painter.drawRect(tile);
+        const int offsetX = padding;
+        const int offsetY = padding;
+        painter.setFont(gridFont);
+        painter.setPen(mazeWallColor_);
+        for (int r = 0; r < size; ++r) {
+            for (int c = 0; c < size; ++c) {
+                const QRect tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
+                painter.fillRect(tile, mazeBackgroundColor_);
+                painter.setPen(QPen(mazeWallColor_, 1));
+                painter.drawRect(tile);
             
-            const char ch = puzzle.grid[r][c];
-            painter.setPen(mazeWallColor_);
-            painter.drawText(tile, Qt::AlignCenter, QString(QChar(ch)).toUpper());
+                const char ch = puzzle.grid[r][c];
+                painter.setPen(mazeWallColor_);
+                painter.drawText(tile, Qt::AlignCenter, QString(QChar(ch)).toUpper());
+            }
         }
-    }
-
-    painter.setFont(wordFont);
-    painter.setPen(mazeWallColor_);
-    const int wordListX = offsetX + gridWidth + padding;
-    painter.drawText(QRect(wordListX, offsetY, wordListWidth, wordListHeight), Qt::AlignLeft | Qt::AlignTop, wordsText);
 
-    const QString suggested = QString("wordsearch.png");
-    const QString path = QFileDialog::getSaveFileName(this, "Save Word Search Image", suggested, "PNG Images (*.png)");
-    if (path.isEmpty()) {
-        return;
-    }
-    if (!image.save(path, "PNG")) {
+        painter.setFont(wordFont);
+        painter.setPen(mazeWallColor_);
+        const int wordListX = offsetX + gridWidth + padding;
+        painter.drawText(QRect(wordListX, offsetY, wordListWidth, wordListHeight), Qt::AlignLeft | Qt::AlignTop, wordsText);
+    };
+    if (!savePicture(path, selectedFilter, QSize(imageWidth, imageHeight), mazeBackgroundColor_, paint)) {
         showSizedMessage(this, QMessageBox::Warning, "Save Failed", "Could not save the word search image.");
     }
 }
 void MazeWindow::saveActiveProgress() {
-    if (!inTestMode_ || loadedIndex_ < 0 || loadedIndex_ >= static_cast<int>(savedPuzzles_.size())) {
-        return;
-    }
-    auto& puzzle = savedPuzzles_[loadedIndex_];
-    if (puzzle.type == SavedPuzzle::Type::Maze && puzzle.maze) {
-        puzzle.maze->graph = game_.graph();
-        puzzle.maze->entranceNode = game_.entranceNode();
-        puzzle.maze->exitNode = game_.exitNode();
-        puzzle.maze->playerNode = game_.playerNode();
-        auto it = std::find_if(savedMazes_.begin(), savedMazes_.end(),
-            [&](const SavedMaze& m) { return m.name == puzzle.maze->name; });
-        if (it != savedMazes_.end()) {
-            *it = *puzzle.maze;
-        }
-    } else if (puzzle.type == SavedPuzzle::Type::Crossword && puzzle.crossword) {
-        
-    } else if (puzzle.type == SavedPuzzle::Type::WordSearch && puzzle.wordSearch) {
-        
-    } else if (puzzle.type == SavedPuzzle::Type::Sudoku && puzzle.sudoku) {
-        
-    } else if (puzzle.type == SavedPuzzle::Type::Cryptogram && puzzle.cryptogram) {
-        
+    if (!inTestMode_) {
+        return;
     }
+    const SavedPuzzle* puzzle = library_->puzzleAt(loadedIndex_);
+    const SavedMaze* maze = puzzle ? puzzle->maze() : nullptr;
+    if (!maze
+        || (maze->playerNode == game_.playerNode()
+            && maze->entranceNode == game_.entranceNode()
+            && maze->exitNode == game_.exitNode())) {
+        return;
+    }
+    library_->modify(loadedIndex_, [this](SavedPuzzle& saved) {
+        auto* edited = saved.maze();
+        edited->graph = game_.graph();
+        edited->entranceNode = game_.entranceNode();
+        edited->exitNode = game_.exitNode();
+        edited->playerNode = game_.playerNode();
+    });
 }
@@ -22,6 +22,9 @@
 #include "SudokuGenerator.h"
 #include "CryptogramWidget.h"
 #include "CryptogramGenerator.h"
+#include "SavedPuzzle.h"
+#include "PersistenceService.h"
+#include "PuzzleLibrary.h"
 
 class QComboBox;
 class QLabel;
@@ -31,13 +34,19 @@ class QCheckBox;
 class QSpinBox;
 class QToolBar;
 class QAction;
-class QListWidget;
+class QListView;
 class QPushButton;
 class QStackedWidget;
 class QScrollArea;
 class QSlider;
 class QVBoxLayout;
 class QDialog;
+class CrosswordSearcher;
+class DictionaryLoader;
+class PuzzleThumbnailer;
+class SavedPuzzleListModel;
+class SudokuBatchGenerator;
+class SudokuImporter;
 
 class MazeWindow : public QMainWindow {
     Q_OBJECT
@@ -75,8 +84,12 @@ private:
     void loadSudoku(int index);
     void clearActivePuzzle();
     void refreshActions();
+    // Selection in the saved list, in library rows. Selecting a row hidden by the search clears it.
+    [[nodiscard]] int currentSavedRow() const;
+    void setCurrentSavedRow(int row, bool notify = true);
     QString algorithmLabel(GenerationAlgorithm algorithm) const;
     void generateCrossword();
+    void crosswordSearched(const std::optional<CrosswordPuzzle>& puzzle, const std::vector<std::string>& words);
     void generateWordSearch();
     void generateSudoku();
     void showCrossword(const CrosswordPuzzle& puzzle);
@@ -86,7 +99,7 @@ private:
     void printPreviewActivePuzzle();
     void renderActivePuzzle(QPrinter& printer);
     bool renderActivePuzzleIfAvailable();
-    std::unique_ptr<QWidget> makeRenderWidgetForSelection(int row) const;
+    std::unique_ptr<QWidget> makeRenderWidgetForSelection(int row);
     std::vector<std::pair<std::string, std::string>> collectWords() const;
     static std::string cleanWord(const QString& raw);
     void saveCrosswordImage();
@@ -94,8 +107,15 @@ private:
     void saveSudokuImage();
     QString sudokuDifficultyLabel(int difficulty) const;
     void persistState() const;
+    void submitState();
     void restoreState();
     QString stateFilePath() const;
+    QString libraryDirectoryPath() const;
+    QString thumbnailDirectoryPath() const;
+    void exportLibrary();
+    void importLibrary();
+    void generateSudokuBatch();
+    void importSudokuList();
     void createMenusAndToolbars();
     void updateActionStates();
     void updateStatusBarText(const QString& message);
@@ -117,6 +137,8 @@ private:
     SudokuWidget* sudokuWidget_ = nullptr;
     CryptogramWidget* cryptogramWidget_ = nullptr;
     WordSearchGenerator wordSearchGen_;
+    // The loaded dictionary, shared by word search and the dense crossword fill.
+    std::shared_ptr<const WordPatternIndex> dictionaryWords_;
     CryptogramGenerator cryptogramGen_;
     QStackedWidget* puzzleViewStack_ = nullptr;
     QWidget* mazeView_ = nullptr;
@@ -131,7 +153,10 @@ private:
     QScrollArea* cryptogramScroll_ = nullptr;
     QLabel* statusLabel_ = nullptr;
     QLabel* coordStatusLabel_ = nullptr;
-    QListWidget* savedList_ = nullptr;
+    QLineEdit* savedSearch_ = nullptr;
+    QListView* savedList_ = nullptr;
+    SavedPuzzleListModel* savedModel_ = nullptr;
+    bool quietSelection_ = false;
     QStackedWidget* rightStack_ = nullptr;
     QWidget* playPage_ = nullptr;
     QWidget* generatePage_ = nullptr;
@@ -155,6 +180,9 @@ private:
     QWidget* wordListContainer_ = nullptr;
     QVBoxLayout* wordListLayout_ = nullptr;
     QPushButton* addWordButton_ = nullptr;
+    QCheckBox* crosswordDenseCheck_ = nullptr;
+    QSpinBox* crosswordSideSpin_ = nullptr;
+    QPushButton* createButton_ = nullptr;
     struct WordRow {
         QWidget* widget = nullptr;
         QLineEdit* word = nullptr;
@@ -179,6 +207,7 @@ private:
     QSpinBox* wordSearchSizeSpin_ = nullptr;
     QSpinBox* wordCountSpin_ = nullptr;
     QLineEdit* sudokuNameEdit_ = nullptr;
+    QComboBox* sudokuSizeCombo_ = nullptr;
     QComboBox* sudokuDifficultyCombo_ = nullptr;
     QLineEdit* cryptogramNameEdit_ = nullptr;
     QTextEdit* cryptogramPlaintextEdit_ = nullptr;
@@ -191,54 +220,13 @@ private:
     std::unordered_map<std::string, std::string> lastCrosswordHints_;
     int loadedIndex_ = -1;
 
-    struct SavedMaze {
-        std::string name;
-        GenerationAlgorithm algorithm;
-        int width = 0;
-        int height = 0;
-        MazeGraph graph;
-        int entranceNode = -1;
-        int exitNode = -1;
-        int playerNode = -1;
-    };
-    
-    struct SavedCrossword {
-        std::string name;
-        CrosswordPuzzle puzzle;
-        std::unordered_map<std::string, std::string> hints;
-    };
-    
-    struct SavedWordSearch {
-        std::string name;
-        WordSearchPuzzle puzzle;
-    };
-
-    struct SavedSudoku {
-        std::string name;
-        SudokuPuzzle puzzle;
-        int difficulty = 0;
-    };
-    
-    struct SavedCryptogram {
-        std::string name;
-        CryptogramPuzzle puzzle;
-        bool avoidSelfMapping = true;
-        int hintCount = 0;
-    };
-    
-    struct SavedPuzzle {
-        enum class Type { Maze, Crossword, WordSearch, Sudoku, Cryptogram };
-        Type type;
-        std::optional<SavedMaze> maze;
-        std::optional<SavedCrossword> crossword;
-        std::optional<SavedWordSearch> wordSearch;
-        std::optional<SavedSudoku> sudoku;
-        std::optional<SavedCryptogram> cryptogram;
-    };
-    
-    std::vector<SavedPuzzle> savedPuzzles_;
-    std::vector<SavedMaze> savedMazes_;
-    std::vector<SavedCryptogram> savedCryptograms_;
+    PersistenceService* persistence_ = nullptr;
+    PuzzleLibrary* library_ = nullptr;
+    PuzzleThumbnailer* thumbnailer_ = nullptr;
+    SudokuBatchGenerator* sudokuBatch_ = nullptr;
+    SudokuImporter* sudokuImporter_ = nullptr;
+    DictionaryLoader* dictionaryLoader_ = nullptr;
+    CrosswordSearcher* crosswordSearcher_ = nullptr;
     QAction* newAction_ = nullptr;
     QAction* playAction_ = nullptr;
     QAction* endTestAction_ = nullptr;
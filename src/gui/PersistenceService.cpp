@@ -0,0 +1,178 @@
+#include "PersistenceService.h"
+
+#include <QMetaObject>
+#include <QTimer>
+#include <iterator>
+#include <utility>
+
+namespace {
+constexpr int kDebounceMs = 400;
+}
+
+PersistenceService::PersistenceService(QString directory, QString legacyStateFile, QObject* parent)
+    : QObject(parent), store_(std::move(directory), std::move(legacyStateFile)) {
+    debounce_ = new QTimer(this);
+    debounce_->setSingleShot(true);
+    debounce_->setInterval(kDebounceMs);
+    connect(debounce_, &QTimer::timeout, this, &PersistenceService::saveDue);
+    worker_ = std::thread([this]() { run(); });
+}
+
+PersistenceService::~PersistenceService() {
+    flush();
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+}
+
+std::optional<PuzzleStoreContents> PersistenceService::load() {
+    flush();
+    auto contents = store_.load();
+    nextId_ = store_.nextId();
+    submittedIds_.clear();
+    submitted_.clear();
+    dirty_.clear();
+    persisted_.clear();
+    inFlight_.clear();
+    pendingBatches_.clear();
+    if (contents) {
+        for (const auto& entry : contents->entries) {
+            submittedIds_.push_back(entry.id);
+            submitted_.insert(entry.id);
+            persisted_.insert(entry.id);
+        }
+        submittedSession_ = contents->session;
+    }
+    return contents;
+}
+
+void PersistenceService::markDirty(const quint64 id) {
+    dirty_.insert(id);
+    persisted_.erase(id);
+}
+
+void PersistenceService::addBatch(const quint64 batch, std::vector<quint64> ids, std::vector<SavedPuzzle> puzzles) {
+    for (const quint64 id : ids) {
+        submitted_.insert(id);
+    }
+    pendingBatches_.push_back(PuzzleStoreBatch{batch, std::move(ids), std::move(puzzles)});
+}
+
+void PersistenceService::schedule() {
+    debounce_->start();
+}
+
+void PersistenceService::submit(const std::vector<quint64>& ids,
+                                std::vector<std::pair<quint64, SavedPuzzle>> changed,
+                                const PuzzleStoreSession& session) {
+    debounce_->stop();
+
+    Snapshot snapshot;
+    snapshot.changed = std::move(changed);
+    snapshot.batches = std::move(pendingBatches_);
+    pendingBatches_.clear();
+    for (const auto& change : snapshot.changed) {
+        submitted_.insert(change.first);
+    }
+    dirty_.clear();
+    if (snapshot.changed.empty() && snapshot.batches.empty() && ids == submittedIds_ && session == submittedSession_) {
+        return;
+    }
+    submittedIds_ = ids;
+    submittedSession_ = session;
+
+    snapshot.serial = ++serial_;
+    snapshot.ids = ids;
+    snapshot.session = session;
+    for (const auto& change : snapshot.changed) {
+        inFlight_[change.first] = snapshot.serial;
+    }
+    for (const auto& batch : snapshot.batches) {
+        for (const quint64 id : batch.ids) {
+            inFlight_[id] = snapshot.serial;
+        }
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        if (queued_) {
+            std::unordered_set<quint64> replaced;
+            for (const auto& change : snapshot.changed) {
+                replaced.insert(change.first);
+            }
+            for (auto& change : queued_->changed) {
+                if (!replaced.count(change.first)) {
+                    inFlight_[change.first] = snapshot.serial;
+                    snapshot.changed.push_back(std::move(change));
+                }
+            }
+            // Older batches go first, as they were added first.
+            for (const auto& batch : queued_->batches) {
+                for (const quint64 id : batch.ids) {
+                    if (!replaced.count(id)) {
+                        inFlight_[id] = snapshot.serial;
+                    }
+                }
+            }
+            snapshot.batches.insert(snapshot.batches.begin(), std::make_move_iterator(queued_->batches.begin()),
+                                    std::make_move_iterator(queued_->batches.end()));
+        }
+        queued_ = std::move(snapshot);
+    }
+    wake_.notify_one();
+}
+
+void PersistenceService::flush() {
+    debounce_->stop();
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this]() { return !queued_ && !writing_; });
+}
+
+void PersistenceService::run() {
+    std::unique_lock lock(mutex_);
+    while (true) {
+        wake_.wait(lock, [this]() { return queued_ || stopping_; });
+        if (!queued_) {
+            return;
+        }
+        Snapshot snapshot = std::move(*queued_);
+        queued_.reset();
+        writing_ = true;
+        lock.unlock();
+
+        auto written = store_.sync(snapshot.ids, snapshot.batches, snapshot.changed, snapshot.session);
+        QMetaObject::invokeMethod(this, [this, serial = snapshot.serial, written = std::move(written)]() {
+            recordsWritten(serial, written);
+        }, Qt::QueuedConnection);
+
+        lock.lock();
+        writing_ = false;
+        idle_.notify_all();
+    }
+}
+
+void PersistenceService::recordsWritten(const std::uint64_t serial, const std::vector<quint64>& ids) {
+    bool persisted = false;
+    for (const quint64 id : ids) {
+        const auto it = inFlight_.find(id);
+        if (it != inFlight_.end() && it->second == serial) {
+            inFlight_.erase(it);
+            persisted_.insert(id);
+            persisted = true;
+        }
+    }
+    for (auto it = inFlight_.begin(); it != inFlight_.end();) {
+        if (it->second == serial) {
+            dirty_.insert(it->first);
+            it = inFlight_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    if (persisted) {
+        emit recordsPersisted();
+    }
+}
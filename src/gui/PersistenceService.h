@@ -0,0 +1,89 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "PuzzleStore.h"
+#include "SavedPuzzle.h"
+
+class QTimer;
+
+// Owns the PuzzleStore and writes it from a background thread. schedule() restarts a short
+// debounce window and emits saveDue() when it expires; submit() then hands the id order, the
+// new and dirty bodies (see needsWrite) and the session to the writer, merging with any
+// snapshot still waiting. Bulk imports hand their bodies over with addBatch() instead, so each
+// batch goes out with the next snapshot as one archive. flush() blocks until everything submitted
+// so far is on disk; recordsPersisted() reports each completed write on the GUI thread.
+class PersistenceService : public QObject {
+    Q_OBJECT
+public:
+    PersistenceService(QString directory, QString legacyStateFile, QObject* parent = nullptr);
+    ~PersistenceService() override;
+
+    [[nodiscard]] std::optional<PuzzleStoreContents> load();
+    [[nodiscard]] std::optional<SavedPuzzle> loadPuzzle(quint64 id, const PuzzleRecordLocation& location) const {
+        return store_.loadPuzzle(id, location);
+    }
+    [[nodiscard]] PuzzleRecordRef recordRef(quint64 id, const PuzzleRecordLocation& location) const {
+        return store_.recordRef(id, location);
+    }
+    [[nodiscard]] quint64 allocateId() { return nextId_++; }
+    void markDirty(quint64 id);
+    // puzzles[i] is ids[i], stored at slot i of batch.
+    void addBatch(quint64 batch, std::vector<quint64> ids, std::vector<SavedPuzzle> puzzles);
+    [[nodiscard]] bool isPersisted(quint64 id) const { return persisted_.count(id) != 0; }
+
+    void schedule();
+    [[nodiscard]] bool needsWrite(quint64 id) const { return !submitted_.count(id) || dirty_.count(id); }
+    void submit(const std::vector<quint64>& ids,
+                std::vector<std::pair<quint64, SavedPuzzle>> changed,
+                const PuzzleStoreSession& session);
+    void flush();
+
+signals:
+    void saveDue();
+    // Some bodies were written and isPersisted() now holds for them.
+    void recordsPersisted();
+
+private:
+    struct Snapshot {
+        std::uint64_t serial = 0;
+        std::vector<quint64> ids;
+        std::vector<PuzzleStoreBatch> batches;
+        std::vector<std::pair<quint64, SavedPuzzle>> changed;
+        PuzzleStoreSession session;
+    };
+
+    PuzzleStore store_;
+    QTimer* debounce_ = nullptr;
+
+    quint64 nextId_ = 1;
+    std::uint64_t serial_ = 0;
+    std::vector<quint64> submittedIds_;
+    PuzzleStoreSession submittedSession_;
+    std::unordered_set<quint64> submitted_;
+    std::unordered_set<quint64> dirty_;
+    std::unordered_set<quint64> persisted_;
+    std::unordered_map<quint64, std::uint64_t> inFlight_;
+    std::vector<PuzzleStoreBatch> pendingBatches_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::optional<Snapshot> queued_;
+    bool writing_ = false;
+    bool stopping_ = false;
+    std::thread worker_;
+
+    void run();
+    void recordsWritten(std::uint64_t serial, const std::vector<quint64>& ids);
+};
@@ -0,0 +1,531 @@
+#include "PuzzleArchive.h"
+
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QtEndian>
+#include <cstring>
+
+#include "Crc32.h"
+#include "PuzzleSerialization.h"
+#include "maze_walls.h"
+
+namespace {
+constexpr char kMagic[4] = {'P', 'Z', 'L', 'B'};
+constexpr std::uint16_t kVersion = 1;
+constexpr std::size_t kHeaderSize = 32;
+constexpr std::size_t kEntrySize = 32;
+constexpr std::size_t kRecordAlign = 8;
+constexpr std::uint8_t kEncodingNative = 0;
+constexpr std::uint8_t kEncodingJson = 1;
+
+class ByteWriter {
+public:
+    explicit ByteWriter(QByteArray& out) : out_(out) {}
+
+    template <typename T>
+    void put(const T value) {
+        const T le = qToLittleEndian(value);
+        out_.append(reinterpret_cast<const char*>(&le), sizeof(T));
+    }
+    void putBytes(const void* data, const std::size_t size) {
+        out_.append(static_cast<const char*>(data), static_cast<qsizetype>(size));
+    }
+    void putString(const std::string& text) {
+        put<std::uint16_t>(static_cast<std::uint16_t>(text.size()));
+        putBytes(text.data(), text.size());
+    }
+    void align(const std::size_t alignment) {
+        while (static_cast<std::size_t>(out_.size()) % alignment != 0) {
+            out_.append('\0');
+        }
+    }
+
+private:
+    QByteArray& out_;
+};
+
+class ByteReader {
+public:
+    ByteReader(const uchar* data, const std::size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    bool get(T& value) {
+        if (size_ - pos_ < sizeof(T)) return false;
+        value = qFromLittleEndian<T>(data_ + pos_);
+        pos_ += sizeof(T);
+        return true;
+    }
+    const uchar* take(const std::size_t size) {
+        if (size_ - pos_ < size) return nullptr;
+        const uchar* at = data_ + pos_;
+        pos_ += size;
+        return at;
+    }
+    bool getString(std::string& text) {
+        std::uint16_t length = 0;
+        if (!get(length)) return false;
+        const uchar* bytes = take(length);
+        if (!bytes) return false;
+        text.assign(reinterpret_cast<const char*>(bytes), length);
+        return true;
+    }
+    bool align(const std::size_t alignment) {
+        const std::size_t padded = (pos_ + alignment - 1) / alignment * alignment;
+        if (padded > size_) return false;
+        pos_ = padded;
+        return true;
+    }
+
+private:
+    const uchar* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+};
+
+bool isCanonicalGrid(const MazeGraph& graph) {
+    const int rows = graph.rows;
+    const int cols = graph.cols;
+    if (rows <= 0 || cols <= 0 || graph.nodes.size() != static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols)) {
+        return false;
+    }
+    for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+        const auto& n = graph.nodes[i];
+        if (n.id != static_cast<int>(i) || n.row != n.id / cols || n.col != n.id % cols) {
+            return false;
+        }
+    }
+    std::size_t index = 0;
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const int id = r * cols + c;
+            if (c + 1 < cols) {
+                if (index >= graph.edges.size() || graph.edges[index].from != id || graph.edges[index].to != id + 1) return false;
+                ++index;
+            }
+            if (r + 1 < rows) {
+                if (index >= graph.edges.size() || graph.edges[index].from != id || graph.edges[index].to != id + cols) return false;
+                ++index;
+            }
+        }
+    }
+    return index == graph.edges.size();
+}
+
+bool encodeMaze(const SavedMaze& maze, QByteArray& out) {
+    if (!isCanonicalGrid(maze.graph)) {
+        return false;
+    }
+    ByteWriter writer(out);
+    writer.put<std::int32_t>(algorithmToInt(maze.algorithm));
+    writer.put<std::int32_t>(maze.width);
+    writer.put<std::int32_t>(maze.height);
+    writer.put<std::int32_t>(maze.graph.rows);
+    writer.put<std::int32_t>(maze.graph.cols);
+    writer.put<std::int32_t>(maze.graph.entranceNode);
+    writer.put<std::int32_t>(maze.graph.exitNode);
+    writer.put<std::int32_t>(maze.entranceNode);
+    writer.put<std::int32_t>(maze.exitNode);
+    writer.put<std::int32_t>(maze.playerNode);
+    const MazeWalls walls = make_maze_walls(maze.graph);
+    for (const std::uint64_t word : walls.east) writer.put(word);
+    for (const std::uint64_t word : walls.south) writer.put(word);
+    return true;
+}
+
+std::optional<SavedMaze> decodeMaze(const std::string& name, const uchar* data, const std::size_t size) {
+    ByteReader reader(data, size);
+    std::int32_t fields[10] = {};
+    for (auto& field : fields) {
+        if (!reader.get(field)) return std::nullopt;
+    }
+    const int rows = fields[3];
+    const int cols = fields[4];
+    if (rows <= 0 || cols <= 0 || static_cast<long long>(rows) * cols > (1LL << 30)) {
+        return std::nullopt;
+    }
+    const std::size_t cells = static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols);
+    const std::size_t words = (cells + 63) / 64;
+    const uchar* east = reader.take(words * 8);
+    const uchar* south = reader.take(words * 8);
+    if (!east || !south) {
+        return std::nullopt;
+    }
+    auto closed = [](const uchar* bits, const std::size_t bit) {
+        return ((bits[bit >> 3] >> (bit & 7)) & 1u) != 0;
+    };
+
+    SavedMaze maze;
+    maze.name = name;
+    maze.algorithm = algorithmFromInt(fields[0]);
+    maze.width = fields[1];
+    maze.height = fields[2];
+    maze.graph = make_grid_graph(rows, cols);
+    maze.graph.entranceNode = fields[5];
+    maze.graph.exitNode = fields[6];
+    maze.entranceNode = fields[7];
+    maze.exitNode = fields[8];
+    maze.playerNode = fields[9];
+    for (auto& edge : maze.graph.edges) {
+        const auto bit = static_cast<std::size_t>(edge.from);
+        edge.open = edge.to == edge.from + 1 ? !closed(east, bit) : !closed(south, bit);
+    }
+    return maze;
+}
+
+void encodeSudoku(const SavedSudoku& sudoku, QByteArray& out) {
+    const auto& grid = sudoku.puzzle.grid;
+    const auto rows = static_cast<std::uint16_t>(grid.size());
+    const auto cols = static_cast<std::uint16_t>(grid.empty() ? 0 : grid.front().size());
+    const bool hasSolution = sudoku.puzzle.solution.size() == rows;
+    ByteWriter writer(out);
+    writer.put<std::uint16_t>(rows);
+    writer.put<std::uint16_t>(cols);
+    writer.put<std::int32_t>(sudoku.difficulty);
+    writer.put<std::uint8_t>(hasSolution ? 1 : 0);
+    writer.align(4);
+    auto putGrid = [&](const std::vector<std::vector<int>>& cells) {
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                const int value = c < static_cast<int>(cells[r].size()) ? cells[r][c] : 0;
+                writer.put<std::uint8_t>(static_cast<std::uint8_t>(value));
+            }
+        }
+    };
+    putGrid(grid);
+    if (hasSolution) {
+        putGrid(sudoku.puzzle.solution);
+    }
+}
+
+std::optional<SavedSudoku> decodeSudoku(const std::string& name, const uchar* data, const std::size_t size) {
+    ByteReader reader(data, size);
+    std::uint16_t rows = 0;
+    std::uint16_t cols = 0;
+    std::int32_t difficulty = 0;
+    std::uint8_t hasSolution = 0;
+    if (!reader.get(rows) || !reader.get(cols) || !reader.get(difficulty) || !reader.get(hasSolution) || !reader.align(4)) {
+        return std::nullopt;
+    }
+    if (rows == 0 || cols == 0) {
+        return std::nullopt;
+    }
+    auto readGrid = [&](std::vector<std::vector<int>>& cells) {
+        const uchar* bytes = reader.take(static_cast<std::size_t>(rows) * cols);
+        if (!bytes) return false;
+        cells.assign(rows, std::vector<int>(cols, 0));
+        for (int r = 0; r < rows; ++r) {
+            for (int c = 0; c < cols; ++c) {
+                cells[r][c] = bytes[r * cols + c];
+            }
+        }
+        return true;
+    };
+    SavedSudoku sudoku;
+    sudoku.name = name;
+    sudoku.difficulty = difficulty;
+    if (!readGrid(sudoku.puzzle.grid) || (hasSolution && !readGrid(sudoku.puzzle.solution))) {
+        return std::nullopt;
+    }
+    return sudoku;
+}
+
+bool encodeWordSearch(const SavedWordSearch& wordSearch, QByteArray& out) {
+    const auto& puzzle = wordSearch.puzzle;
+    if (puzzle.size <= 0 || puzzle.size > 0xffff || puzzle.grid.size() != static_cast<std::size_t>(puzzle.size)
+        || puzzle.words.size() > 0xffff) {
+        return false;
+    }
+    for (const auto& row : puzzle.grid) {
+        if (row.size() != static_cast<std::size_t>(puzzle.size)) return false;
+    }
+    for (const auto& word : puzzle.words) {
+        if (word.size() > 0xffff) return false;
+    }
+    ByteWriter writer(out);
+    writer.put<std::uint16_t>(static_cast<std::uint16_t>(puzzle.size));
+    writer.put<std::uint16_t>(static_cast<std::uint16_t>(puzzle.words.size()));
+    for (const auto& row : puzzle.grid) {
+        writer.putBytes(row.data(), row.size());
+    }
+    for (const auto& word : puzzle.words) {
+        writer.putString(word);
+    }
+    return true;
+}
+
+std::optional<SavedWordSearch> decodeWordSearch(const std::string& name, const uchar* data, const std::size_t size) {
+    ByteReader reader(data, size);
+    std::uint16_t gridSize = 0;
+    std::uint16_t wordCount = 0;
+    if (!reader.get(gridSize) || !reader.get(wordCount) || gridSize == 0) {
+        return std::nullopt;
+    }
+    SavedWordSearch wordSearch;
+    wordSearch.name = name;
+    wordSearch.puzzle.size = gridSize;
+    wordSearch.puzzle.grid.reserve(gridSize);
+    for (int r = 0; r < gridSize; ++r) {
+        const uchar* row = reader.take(gridSize);
+        if (!row) return std::nullopt;
+        wordSearch.puzzle.grid.emplace_back(row, row + gridSize);
+    }
+    wordSearch.puzzle.words.resize(wordCount);
+    for (auto& word : wordSearch.puzzle.words) {
+        if (!reader.getString(word)) return std::nullopt;
+    }
+    return wordSearch;
+}
+
+void putHeaderField32(QByteArray& header, const int offset, const std::uint32_t value) {
+    qToLittleEndian(value, header.data() + offset);
+}
+}
+
+bool isPuzzleArchive(const QByteArray& head) {
+    return head.size() >= 4 && std::memcmp(head.constData(), kMagic, 4) == 0;
+}
+
+PuzzleRecord encodePuzzleRecord(const SavedPuzzle& puzzle) {
+    PuzzleRecord record;
+    bool native = false;
+    switch (puzzle.type) {
+        case SavedPuzzle::Type::Maze:
+            native = puzzle.maze() && encodeMaze(*puzzle.maze(), record.bytes);
+            break;
+        case SavedPuzzle::Type::Sudoku:
+            if (puzzle.sudoku() && !puzzle.sudoku()->puzzle.grid.empty()) {
+                encodeSudoku(*puzzle.sudoku(), record.bytes);
+                native = true;
+            }
+            break;
+        case SavedPuzzle::Type::WordSearch:
+            native = puzzle.wordSearch() && encodeWordSearch(*puzzle.wordSearch(), record.bytes);
+            break;
+        case SavedPuzzle::Type::Crossword:
+        case SavedPuzzle::Type::Cryptogram:
+            break;
+    }
+    if (native) {
+        record.encoding = kEncodingNative;
+        return record;
+    }
+    record.encoding = kEncodingJson;
+    record.bytes = QJsonDocument(savedPuzzleToJson(puzzle)).toJson(QJsonDocument::Compact);
+    return record;
+}
+
+std::uint64_t puzzleContentHash(const SavedPuzzle& puzzle) {
+    const PuzzleRecord record = encodePuzzleRecord(puzzle);
+    const std::uint32_t crc = crc32Update(0, record.bytes.constData(), static_cast<std::size_t>(record.bytes.size()));
+    const auto low = (static_cast<std::uint32_t>(record.bytes.size()) << 8)
+        | (static_cast<std::uint32_t>(puzzle.type) << 4) | record.encoding;
+    return (static_cast<std::uint64_t>(crc) << 32) | low;
+}
+
+std::optional<SavedPuzzle> decodePuzzleRecord(const SavedPuzzle::Type type,
+                                              const std::uint8_t encoding,
+                                              const std::string& name,
+                                              const uchar* data,
+                                              const std::size_t size) {
+    if (encoding == kEncodingJson) {
+        const auto doc = QJsonDocument::fromJson(QByteArray::fromRawData(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size)));
+        auto saved = savedPuzzleFromJson(doc.object());
+        if (!saved || saved->type != type) {
+            return std::nullopt;
+        }
+        return saved;
+    }
+    if (encoding != kEncodingNative) {
+        return std::nullopt;
+    }
+
+    switch (type) {
+        case SavedPuzzle::Type::Maze:
+            if (auto maze = decodeMaze(name, data, size)) return SavedPuzzle(std::move(*maze));
+            break;
+        case SavedPuzzle::Type::Sudoku:
+            if (auto sudoku = decodeSudoku(name, data, size)) return SavedPuzzle(std::move(*sudoku));
+            break;
+        case SavedPuzzle::Type::WordSearch:
+            if (auto wordSearch = decodeWordSearch(name, data, size)) return SavedPuzzle(std::move(*wordSearch));
+            break;
+        case SavedPuzzle::Type::Crossword:
+        case SavedPuzzle::Type::Cryptogram:
+            break;
+    }
+    return std::nullopt;
+}
+
+bool writePuzzleArchive(const QString& path, const std::span<const SavedPuzzle> puzzles) {
+    std::vector<PuzzleRecord> records;
+    records.reserve(puzzles.size());
+    for (const auto& puzzle : puzzles) {
+        records.push_back(encodePuzzleRecord(puzzle));
+    }
+
+    QByteArray names;
+    QByteArray index;
+    ByteWriter indexWriter(index);
+    std::vector<std::string> puzzleNames;
+    puzzleNames.reserve(puzzles.size());
+    for (const auto& puzzle : puzzles) {
+        puzzleNames.push_back(savedPuzzleName(puzzle));
+    }
+
+    std::uint64_t nameBytes = 0;
+    for (const auto& name : puzzleNames) nameBytes += name.size();
+    const std::uint64_t indexBytes = kEntrySize * puzzles.size() + nameBytes;
+    std::uint64_t offset = (kHeaderSize + indexBytes + kRecordAlign - 1) / kRecordAlign * kRecordAlign;
+
+    for (std::size_t i = 0; i < puzzles.size(); ++i) {
+        const auto& record = records[i];
+        indexWriter.put<std::uint8_t>(static_cast<std::uint8_t>(puzzles[i].type));
+        indexWriter.put<std::uint8_t>(record.encoding);
+        indexWriter.put<std::uint16_t>(0);
+        indexWriter.put<std::uint32_t>(static_cast<std::uint32_t>(names.size()));
+        indexWriter.put<std::uint32_t>(static_cast<std::uint32_t>(puzzleNames[i].size()));
+        indexWriter.put<std::uint32_t>(crc32Update(0, record.bytes.constData(), static_cast<std::size_t>(record.bytes.size())));
+        indexWriter.put<std::uint64_t>(offset);
+        indexWriter.put<std::uint64_t>(static_cast<std::uint64_t>(record.bytes.size()));
+        names.append(puzzleNames[i].data(), static_cast<qsizetype>(puzzleNames[i].size()));
+        offset = (offset + static_cast<std::uint64_t>(record.bytes.size()) + kRecordAlign - 1) / kRecordAlign * kRecordAlign;
+    }
+    index.append(names);
+    if (indexBytes > 0xffffffffu) {
+        return false;
+    }
+
+    QByteArray header(static_cast<int>(kHeaderSize), '\0');
+    std::memcpy(header.data(), kMagic, 4);
+    qToLittleEndian<std::uint16_t>(kVersion, header.data() + 4);
+    qToLittleEndian<std::uint16_t>(static_cast<std::uint16_t>(kHeaderSize), header.data() + 6);
+    putHeaderField32(header, 8, static_cast<std::uint32_t>(puzzles.size()));
+    putHeaderField32(header, 12, static_cast<std::uint32_t>(indexBytes));
+    putHeaderField32(header, 16, crc32Update(0, index.constData(), static_cast<std::size_t>(index.size())));
+    putHeaderField32(header, 24, crc32Update(0, header.constData(), 24));
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    QByteArray padding;
+    auto writeAligned = [&](const QByteArray& bytes) {
+        file.write(bytes);
+        const qint64 pad = (kRecordAlign - static_cast<std::size_t>(file.pos()) % kRecordAlign) % kRecordAlign;
+        padding.fill('\0', static_cast<int>(pad));
+        file.write(padding);
+    };
+    file.write(header);
+    writeAligned(index);
+    for (const auto& record : records) {
+        writeAligned(record.bytes);
+    }
+    return file.commit();
+}
+
+PuzzleArchiveReader::~PuzzleArchiveReader() {
+    close();
+}
+
+bool PuzzleArchiveReader::open(const QString& path) {
+    close();
+    file_.setFileName(path);
+    if (!file_.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    size_ = file_.size();
+    if (size_ < static_cast<qint64>(kHeaderSize)) {
+        close();
+        return false;
+    }
+    data_ = file_.map(0, size_);
+    if (!data_) {
+        close();
+        return false;
+    }
+
+    const uchar* header = data_;
+    std::uint32_t count = qFromLittleEndian<std::uint32_t>(header + 8);
+    std::uint32_t indexBytes = qFromLittleEndian<std::uint32_t>(header + 12);
+    const std::uint32_t indexCrc = qFromLittleEndian<std::uint32_t>(header + 16);
+    const std::uint32_t headerCrc = qFromLittleEndian<std::uint32_t>(header + 24);
+    const bool headerOk = std::memcmp(header, kMagic, 4) == 0
+        && qFromLittleEndian<std::uint16_t>(header + 4) == kVersion
+        && qFromLittleEndian<std::uint16_t>(header + 6) == kHeaderSize
+        && crc32Update(0, header, 24) == headerCrc
+        && static_cast<std::uint64_t>(count) * kEntrySize <= indexBytes
+        && kHeaderSize + static_cast<std::uint64_t>(indexBytes) <= static_cast<std::uint64_t>(size_)
+        && crc32Update(0, header + kHeaderSize, indexBytes) == indexCrc;
+    if (!headerOk) {
+        close();
+        return false;
+    }
+
+    const uchar* table = header + kHeaderSize;
+    const uchar* names = table + static_cast<std::size_t>(count) * kEntrySize;
+    const std::uint64_t namesSize = indexBytes - static_cast<std::uint64_t>(count) * kEntrySize;
+    entries_.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const uchar* raw = table + static_cast<std::size_t>(i) * kEntrySize;
+        PuzzleArchiveEntry entry;
+        const std::uint8_t type = raw[0];
+        entry.encoding = raw[1];
+        const std::uint32_t nameOffset = qFromLittleEndian<std::uint32_t>(raw + 4);
+        const std::uint32_t nameLength = qFromLittleEndian<std::uint32_t>(raw + 8);
+        entry.crc = qFromLittleEndian<std::uint32_t>(raw + 12);
+        entry.offset = qFromLittleEndian<std::uint64_t>(raw + 16);
+        entry.size = qFromLittleEndian<std::uint64_t>(raw + 24);
+        if (type > static_cast<std::uint8_t>(SavedPuzzle::Type::Cryptogram)
+            || static_cast<std::uint64_t>(nameOffset) + nameLength > namesSize
+            || entry.offset > static_cast<std::uint64_t>(size_)
+            || entry.size > static_cast<std::uint64_t>(size_) - entry.offset) {
+            close();
+            return false;
+        }
+        entry.type = static_cast<SavedPuzzle::Type>(type);
+        entry.name.assign(reinterpret_cast<const char*>(names + nameOffset), nameLength);
+        entries_.push_back(std::move(entry));
+    }
+    return true;
+}
+
+void PuzzleArchiveReader::close() {
+    if (data_) {
+        file_.unmap(data_);
+        data_ = nullptr;
+    }
+    if (file_.isOpen()) {
+        file_.close();
+    }
+    size_ = 0;
+    entries_.clear();
+}
+
+std::optional<SavedPuzzle> PuzzleArchiveReader::load(const std::size_t index) const {
+    if (!data_ || index >= entries_.size()) {
+        return std::nullopt;
+    }
+    const auto& entry = entries_[index];
+    const uchar* body = data_ + entry.offset;
+    if (crc32Update(0, body, entry.size) != entry.crc) {
+        return std::nullopt;
+    }
+    return decodePuzzleRecord(entry.type, entry.encoding, entry.name, body, entry.size);
+}
+
+std::optional<std::vector<SavedPuzzle>> readPuzzleArchive(const QString& path) {
+    PuzzleArchiveReader reader;
+    if (!reader.open(path)) {
+        return std::nullopt;
+    }
+    std::vector<SavedPuzzle> puzzles;
+    puzzles.reserve(reader.entries().size());
+    for (std::size_t i = 0; i < reader.entries().size(); ++i) {
+        auto puzzle = reader.load(i);
+        if (!puzzle) {
+            return std::nullopt;
+        }
+        puzzles.push_back(std::move(*puzzle));
+    }
+    return puzzles;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "SavedPuzzle.h"
+
+// Binary library layout (little-endian): a 32-byte header, a table of fixed 32-byte index
+// entries followed by their names, then one 8-byte aligned record per puzzle. The header, the
+// index and every record carry a CRC32. Mazes are stored as packed wall bitsets and Sudoku and
+// word-search grids as fixed-size byte records; crosswords and cryptograms keep their JSON form.
+struct PuzzleArchiveEntry {
+    SavedPuzzle::Type type = SavedPuzzle::Type::Maze;
+    std::string name;
+    std::uint64_t offset = 0;
+    std::uint64_t size = 0;
+    std::uint32_t crc = 0;
+    std::uint8_t encoding = 0;
+};
+
+[[nodiscard]] bool isPuzzleArchive(const QByteArray& head);
+bool writePuzzleArchive(const QString& path, std::span<const SavedPuzzle> puzzles);
+
+struct PuzzleRecord {
+    std::uint8_t encoding = 0;
+    QByteArray bytes;
+};
+
+[[nodiscard]] PuzzleRecord encodePuzzleRecord(const SavedPuzzle& puzzle);
+// Identifies a body by its encoded record: the record CRC32 in the high word, then its size,
+// type and encoding.
+[[nodiscard]] std::uint64_t puzzleContentHash(const SavedPuzzle& puzzle);
+[[nodiscard]] std::optional<SavedPuzzle> decodePuzzleRecord(SavedPuzzle::Type type,
+                                                            std::uint8_t encoding,
+                                                            const std::string& name,
+                                                            const uchar* data,
+                                                            std::size_t size);
+
+class PuzzleArchiveReader {
+public:
+    PuzzleArchiveReader() = default;
+    ~PuzzleArchiveReader();
+    PuzzleArchiveReader(const PuzzleArchiveReader&) = delete;
+    PuzzleArchiveReader& operator=(const PuzzleArchiveReader&) = delete;
+
+    bool open(const QString& path);
+    void close();
+
+    [[nodiscard]] bool isOpen() const { return data_ != nullptr; }
+    [[nodiscard]] const std::vector<PuzzleArchiveEntry>& entries() const { return entries_; }
+    [[nodiscard]] std::optional<SavedPuzzle> load(std::size_t index) const;
+
+private:
+    QFile file_;
+    uchar* data_ = nullptr;
+    qint64 size_ = 0;
+    std::vector<PuzzleArchiveEntry> entries_;
+};
+
+[[nodiscard]] std::optional<std::vector<SavedPuzzle>> readPuzzleArchive(const QString& path);
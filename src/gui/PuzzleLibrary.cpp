@@ -0,0 +1,217 @@
+#include "PuzzleLibrary.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "PersistenceService.h"
+
+PuzzleLibrary::PuzzleLibrary(PersistenceService& persistence, QObject* parent)
+    : QObject(parent), persistence_(persistence) {
+    connect(&persistence_, &PersistenceService::recordsPersisted, this, [this]() { evictColdBodies(-1); });
+}
+
+int PuzzleLibrary::rowOf(const Id id) const {
+    const auto it = rows_.find(id);
+    return it == rows_.end() ? -1 : it->second;
+}
+
+const SavedPuzzle* PuzzleLibrary::puzzleAt(const int row) {
+    if (!contains(row)) {
+        return nullptr;
+    }
+    auto& entry = entries_[row];
+    entry.lastUse = ++clock_;
+    if (savedPuzzleHasBody(entry.puzzle)) {
+        return &entry.puzzle;
+    }
+    if (auto loaded = persistence_.loadPuzzle(entry.id, entry.location); loaded && loaded->type == entry.puzzle.type) {
+        entry.puzzle = std::move(*loaded);
+        entry.residentBytes = savedPuzzleFootprint(entry.puzzle);
+        residentBytes_ += entry.residentBytes;
+        evictColdBodies(row);
+    }
+    return &entry.puzzle;
+}
+
+const SavedPuzzle* PuzzleLibrary::residentPuzzleAt(const int row) const {
+    if (!contains(row) || !savedPuzzleHasBody(entries_[row].puzzle)) {
+        return nullptr;
+    }
+    return &entries_[row].puzzle;
+}
+
+PuzzleRecordRef PuzzleLibrary::recordAt(const int row) const {
+    return persistence_.recordRef(idAt(row), entries_[row].location);
+}
+
+std::vector<SavedPuzzle> PuzzleLibrary::materializeAll() const {
+    std::vector<SavedPuzzle> puzzles;
+    puzzles.reserve(entries_.size());
+    for (const auto& entry : entries_) {
+        if (savedPuzzleHasBody(entry.puzzle)) {
+            puzzles.push_back(entry.puzzle);
+        } else if (auto loaded = persistence_.loadPuzzle(entry.id, entry.location)) {
+            puzzles.push_back(std::move(*loaded));
+        }
+    }
+    return puzzles;
+}
+
+std::vector<int> PuzzleLibrary::search(const std::string& query) const {
+    std::vector<int> rows;
+    for (const Id id : index_.search(query)) {
+        rows.push_back(rowOf(id));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
+
+bool PuzzleLibrary::matches(const int row, const std::string& query) const {
+    return contains(row) && index_.matches(idAt(row), query);
+}
+
+void PuzzleLibrary::append(Entry entry) {
+    entry.lastUse = ++clock_;
+    residentBytes_ += entry.residentBytes;
+    rows_[entry.id] = count();
+    ids_.push_back(entry.id);
+    entries_.push_back(std::move(entry));
+}
+
+PuzzleLibrary::Id PuzzleLibrary::add(SavedPuzzle puzzle) {
+    Entry entry;
+    entry.id = persistence_.allocateId();
+    entry.name = savedPuzzleName(puzzle);
+    entry.residentBytes = savedPuzzleFootprint(puzzle);
+    index_.insert(entry.id, puzzle.type, entry.name, savedPuzzleSearchTerms(puzzle));
+    entry.puzzle = std::move(puzzle);
+    const Id id = entry.id;
+    append(std::move(entry));
+    emit puzzleAdded(count() - 1);
+    persistence_.schedule();
+    return id;
+}
+
+void PuzzleLibrary::addBatch(std::vector<SavedPuzzle> puzzles) {
+    if (puzzles.empty()) {
+        return;
+    }
+    const int first = count();
+    const Id batch = persistence_.allocateId();
+    std::vector<Id> ids;
+    ids.reserve(puzzles.size());
+    entries_.reserve(entries_.size() + puzzles.size());
+    ids_.reserve(ids_.size() + puzzles.size());
+    for (std::size_t i = 0; i < puzzles.size(); ++i) {
+        Entry entry;
+        entry.id = persistence_.allocateId();
+        entry.name = savedPuzzleName(puzzles[i]);
+        entry.residentBytes = savedPuzzleFootprint(puzzles[i]);
+        entry.location = PuzzleRecordLocation{batch, static_cast<std::uint32_t>(i)};
+        index_.insert(entry.id, puzzles[i].type, entry.name, savedPuzzleSearchTerms(puzzles[i]));
+        entry.puzzle = puzzles[i];
+        ids.push_back(entry.id);
+        append(std::move(entry));
+    }
+    persistence_.addBatch(batch, std::move(ids), std::move(puzzles));
+    emit puzzlesAdded(first, count() - 1);
+    persistence_.schedule();
+}
+
+void PuzzleLibrary::remove(const int row) {
+    if (!contains(row)) {
+        return;
+    }
+    residentBytes_ -= entries_[row].residentBytes;
+    index_.erase(entries_[row].id);
+    rows_.erase(entries_[row].id);
+    entries_.erase(entries_.begin() + row);
+    ids_.erase(ids_.begin() + row);
+    for (int i = row; i < count(); ++i) {
+        rows_[entries_[i].id] = i;
+    }
+    emit puzzleRemoved(row);
+    persistence_.schedule();
+}
+
+void PuzzleLibrary::modify(const int row, const std::function<void(SavedPuzzle&)>& edit) {
+    if (!puzzleAt(row)) {
+        return;
+    }
+    auto& entry = entries_[row];
+    edit(entry.puzzle);
+    residentBytes_ -= entry.residentBytes;
+    entry.residentBytes = savedPuzzleFootprint(entry.puzzle);
+    residentBytes_ += entry.residentBytes;
+    entry.name = savedPuzzleName(entry.puzzle);
+    entry.contentHash = 0;
+    index_.insert(entry.id, entry.puzzle.type, entry.name, savedPuzzleSearchTerms(entry.puzzle));
+    persistence_.markDirty(entry.id);
+    emit puzzleChanged(row);
+    persistence_.schedule();
+}
+
+std::optional<PuzzleStoreSession> PuzzleLibrary::restore() {
+    auto contents = persistence_.load();
+    entries_.clear();
+    ids_.clear();
+    rows_.clear();
+    index_.clear();
+    residentBytes_ = 0;
+    if (contents) {
+        entries_.reserve(contents->entries.size());
+        ids_.reserve(contents->entries.size());
+        for (auto& stored : contents->entries) {
+            Entry entry;
+            entry.id = stored.id;
+            entry.name = std::move(stored.name);
+            entry.puzzle = SavedPuzzle(stored.type);
+            entry.contentHash = stored.contentHash;
+            entry.location = stored.location;
+            index_.insert(entry.id, stored.type, entry.name, stored.terms);
+            append(std::move(entry));
+        }
+    }
+    emit libraryReset();
+    if (!contents) {
+        return std::nullopt;
+    }
+    return contents->session;
+}
+
+void PuzzleLibrary::save(const PuzzleStoreSession& session) {
+    std::vector<std::pair<Id, SavedPuzzle>> changed;
+    for (auto& entry : entries_) {
+        if (persistence_.needsWrite(entry.id) && savedPuzzleHasBody(entry.puzzle)) {
+            // Bodies written one at a time get their own file, even ones that came in a batch.
+            entry.location = {};
+            changed.emplace_back(entry.id, entry.puzzle);
+        }
+    }
+    persistence_.submit(ids_, std::move(changed), session);
+}
+
+void PuzzleLibrary::evictColdBodies(const int keepRow) {
+    if (residentBytes_ <= kResidentBudget) {
+        return;
+    }
+    std::vector<int> candidates;
+    for (int i = 0; i < count(); ++i) {
+        const auto& entry = entries_[i];
+        if (i != keepRow && entry.residentBytes > 0 && persistence_.isPersisted(entry.id)) {
+            candidates.push_back(i);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [this](const int a, const int b) {
+        return entries_[a].lastUse < entries_[b].lastUse;
+    });
+    for (const int i : candidates) {
+        if (residentBytes_ <= kResidentBudget) {
+            break;
+        }
+        auto& entry = entries_[i];
+        entry.puzzle = SavedPuzzle(entry.puzzle.type);
+        residentBytes_ -= entry.residentBytes;
+        entry.residentBytes = 0;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QtGlobal>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PuzzleSearchIndex.h"
+#include "PuzzleStore.h"
+#include "SavedPuzzle.h"
+
+class PersistenceService;
+
+// The saved puzzles in list order. Each puzzle has a stable id, O(1) lookup from id to row and
+// exactly one body, which may be left on disk until puzzleAt() asks for it. Bodies that were
+// not used recently are dropped again once the resident set exceeds the memory budget, checked
+// whenever a body is loaded and whenever a write reaches disk, so bulk imports shed each batch
+// as soon as it is stored. The search index is kept alongside, so searching never needs the
+// bodies.
+class PuzzleLibrary : public QObject {
+    Q_OBJECT
+public:
+    using Id = quint64;
+
+    explicit PuzzleLibrary(PersistenceService& persistence, QObject* parent = nullptr);
+
+    [[nodiscard]] int count() const { return static_cast<int>(entries_.size()); }
+    [[nodiscard]] bool isEmpty() const { return entries_.empty(); }
+    [[nodiscard]] bool contains(int row) const { return row >= 0 && row < count(); }
+    [[nodiscard]] Id idAt(int row) const { return entries_[row].id; }
+    [[nodiscard]] int rowOf(Id id) const;
+    [[nodiscard]] SavedPuzzle::Type typeAt(int row) const { return entries_[row].puzzle.type; }
+    [[nodiscard]] const std::string& nameAt(int row) const { return entries_[row].name; }
+    [[nodiscard]] const std::vector<Id>& ids() const { return ids_; }
+
+    // Loads the body if needed; nullptr when row is out of range.
+    [[nodiscard]] const SavedPuzzle* puzzleAt(int row);
+    // The body only if it is already in memory.
+    [[nodiscard]] const SavedPuzzle* residentPuzzleAt(int row) const;
+    // Content hash recorded by the store, or 0 when unknown (new or edited since the last load).
+    [[nodiscard]] std::uint64_t contentHashAt(int row) const { return entries_[row].contentHash; }
+    [[nodiscard]] PuzzleRecordRef recordAt(int row) const;
+    [[nodiscard]] std::vector<SavedPuzzle> materializeAll() const;
+
+    // Rows, in list order, whose name, type, size or words match query (see PuzzleSearchIndex).
+    [[nodiscard]] std::vector<int> search(const std::string& query) const;
+    [[nodiscard]] bool matches(int row, const std::string& query) const;
+
+    Id add(SavedPuzzle puzzle);
+    // Appends puzzles in one go; the store writes them as one archive with one journal record.
+    void addBatch(std::vector<SavedPuzzle> puzzles);
+    void remove(int row);
+    void modify(int row, const std::function<void(SavedPuzzle&)>& edit);
+
+    [[nodiscard]] std::optional<PuzzleStoreSession> restore();
+    void save(const PuzzleStoreSession& session);
+
+signals:
+    void puzzleAdded(int row);
+    void puzzlesAdded(int first, int last);
+    void puzzleRemoved(int row);
+    void puzzleChanged(int row);
+    void libraryReset();
+
+private:
+    struct Entry {
+        Id id = 0;
+        std::string name;
+        SavedPuzzle puzzle;
+        std::size_t residentBytes = 0;
+        std::uint64_t lastUse = 0;
+        std::uint64_t contentHash = 0;
+        PuzzleRecordLocation location;
+    };
+
+    static constexpr std::size_t kResidentBudget = 64u << 20;
+
+    PersistenceService& persistence_;
+    std::vector<Entry> entries_;
+    std::vector<Id> ids_;
+    std::unordered_map<Id, int> rows_;
+    PuzzleSearchIndex index_;
+    std::size_t residentBytes_ = 0;
+    std::uint64_t clock_ = 0;
+
+    void append(Entry entry);
+    void evictColdBodies(int keepRow);
+};
@@ -0,0 +1,125 @@
+#include "PuzzleSearchIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+
+namespace {
+const char* typeLabel(const SavedPuzzle::Type type) {
+    switch (type) {
+        case SavedPuzzle::Type::Maze: return "maze";
+        case SavedPuzzle::Type::Crossword: return "crossword";
+        case SavedPuzzle::Type::WordSearch: return "word search wordsearch";
+        case SavedPuzzle::Type::Sudoku: return "sudoku";
+        case SavedPuzzle::Type::Cryptogram: return "cryptogram";
+    }
+    return "";
+}
+}
+
+std::vector<std::string> PuzzleSearchIndex::tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::string current;
+    for (const char ch : text) {
+        const auto c = static_cast<unsigned char>(ch);
+        if (std::isalnum(c)) {
+            current.push_back(static_cast<char>(std::tolower(c)));
+        } else if (!current.empty()) {
+            tokens.push_back(std::move(current));
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        tokens.push_back(std::move(current));
+    }
+    return tokens;
+}
+
+void PuzzleSearchIndex::insert(const Id id, const SavedPuzzle::Type type, const std::string& name,
+                               const std::vector<std::string>& terms) {
+    erase(id);
+    std::vector<std::string> tokens = tokenize(name);
+    for (auto& token : tokenize(typeLabel(type))) {
+        tokens.push_back(std::move(token));
+    }
+    for (const auto& term : terms) {
+        for (auto& token : tokenize(term)) {
+            tokens.push_back(std::move(token));
+        }
+    }
+    std::sort(tokens.begin(), tokens.end());
+    tokens.erase(std::unique(tokens.begin(), tokens.end()), tokens.end());
+    for (const auto& token : tokens) {
+        postings_[token].push_back(id);
+    }
+    tokens_[id] = std::move(tokens);
+}
+
+void PuzzleSearchIndex::erase(const Id id) {
+    const auto it = tokens_.find(id);
+    if (it == tokens_.end()) {
+        return;
+    }
+    for (const auto& token : it->second) {
+        const auto posting = postings_.find(token);
+        if (posting == postings_.end()) {
+            continue;
+        }
+        auto& ids = posting->second;
+        if (const auto pos = std::find(ids.begin(), ids.end(), id); pos != ids.end()) {
+            *pos = ids.back();
+            ids.pop_back();
+        }
+        if (ids.empty()) {
+            postings_.erase(posting);
+        }
+    }
+    tokens_.erase(it);
+}
+
+void PuzzleSearchIndex::clear() {
+    postings_.clear();
+    tokens_.clear();
+}
+
+std::vector<PuzzleSearchIndex::Id> PuzzleSearchIndex::prefixMatches(const std::string& prefix) const {
+    std::vector<Id> ids;
+    for (auto it = postings_.lower_bound(prefix); it != postings_.end() && it->first.starts_with(prefix); ++it) {
+        ids.insert(ids.end(), it->second.begin(), it->second.end());
+    }
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+std::vector<PuzzleSearchIndex::Id> PuzzleSearchIndex::search(const std::string& query) const {
+    std::vector<std::string> words = tokenize(query);
+    if (words.empty()) {
+        return {};
+    }
+    // Longer words tend to match fewer puzzles; start from those to keep the intersections small.
+    std::sort(words.begin(), words.end(), [](const std::string& a, const std::string& b) {
+        return a.size() > b.size();
+    });
+    std::vector<Id> result = prefixMatches(words.front());
+    for (std::size_t i = 1; i < words.size() && !result.empty(); ++i) {
+        const std::vector<Id> next = prefixMatches(words[i]);
+        std::vector<Id> narrowed;
+        std::set_intersection(result.begin(), result.end(), next.begin(), next.end(), std::back_inserter(narrowed));
+        result = std::move(narrowed);
+    }
+    return result;
+}
+
+bool PuzzleSearchIndex::matches(const Id id, const std::string& query) const {
+    const auto it = tokens_.find(id);
+    if (it == tokens_.end()) {
+        return false;
+    }
+    const auto& tokens = it->second;
+    const std::vector<std::string> words = tokenize(query);
+    return !words.empty() && std::all_of(words.begin(), words.end(), [&](const std::string& word) {
+        const auto pos = std::lower_bound(tokens.begin(), tokens.end(), word);
+        return pos != tokens.end() && pos->starts_with(word);
+    });
+}
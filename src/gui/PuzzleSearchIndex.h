@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QtGlobal>
+#include <functional>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SavedPuzzle.h"
+
+// Inverted index from lower-case tokens to puzzle ids. A puzzle is indexed by the words of its
+// name, its type and its search terms. A query matches a puzzle when every query word is a
+// prefix of one of its tokens, so results narrow as the user types.
+class PuzzleSearchIndex {
+public:
+    using Id = quint64;
+
+    void insert(Id id, SavedPuzzle::Type type, const std::string& name, const std::vector<std::string>& terms);
+    void erase(Id id);
+    void clear();
+
+    // Matching ids in ascending order; an empty query matches nothing.
+    [[nodiscard]] std::vector<Id> search(const std::string& query) const;
+    [[nodiscard]] bool matches(Id id, const std::string& query) const;
+
+    [[nodiscard]] static std::vector<std::string> tokenize(const std::string& text);
+
+private:
+    std::map<std::string, std::vector<Id>, std::less<>> postings_;
+    std::unordered_map<Id, std::vector<std::string>> tokens_;
+
+    [[nodiscard]] std::vector<Id> prefixMatches(const std::string& prefix) const;
+};
@@ -0,0 +1,364 @@
+#include "PuzzleSerialization.h"
+
+#include <QJsonDocument>
+#include <QString>
+
+namespace {
+QJsonObject graphToJson(const MazeGraph& graph) {
+    QJsonObject obj;
+    obj["rows"] = graph.rows;
+    obj["cols"] = graph.cols;
+    obj["entranceNode"] = graph.entranceNode;
+    obj["exitNode"] = graph.exitNode;
+
+    QJsonArray nodes;
+    for (const auto& n : graph.nodes) {
+        QJsonObject nodeObj;
+        nodeObj["id"] = n.id;
+        nodeObj["row"] = n.row;
+        nodeObj["col"] = n.col;
+        nodes.append(nodeObj);
+    }
+    obj["nodes"] = nodes;
+
+    QJsonArray edges;
+    for (const auto& e : graph.edges) {
+        QJsonObject edgeObj;
+        edgeObj["from"] = e.from;
+        edgeObj["to"] = e.to;
+        edgeObj["open"] = e.open;
+        edges.append(edgeObj);
+    }
+    obj["edges"] = edges;
+    return obj;
+}
+
+std::optional<MazeGraph> graphFromJson(const QJsonObject& obj) {
+    MazeGraph graph;
+    graph.rows = obj.value("rows").toInt();
+    graph.cols = obj.value("cols").toInt();
+    graph.entranceNode = obj.value("entranceNode").toInt(-1);
+    graph.exitNode = obj.value("exitNode").toInt(-1);
+
+    const auto nodesArr = obj.value("nodes").toArray();
+    const auto edgesArr = obj.value("edges").toArray();
+    if (graph.rows <= 0 || graph.cols <= 0 || nodesArr.isEmpty() || edgesArr.isEmpty()) {
+        return std::nullopt;
+    }
+
+    graph.nodes.reserve(nodesArr.size());
+    for (const auto& val : nodesArr) {
+        const auto nodeObj = val.toObject();
+        MazeNode node;
+        node.id = nodeObj.value("id").toInt();
+        node.row = nodeObj.value("row").toInt();
+        node.col = nodeObj.value("col").toInt();
+        graph.nodes.push_back(node);
+    }
+
+    graph.edges.reserve(edgesArr.size());
+    for (const auto& val : edgesArr) {
+        const auto edgeObj = val.toObject();
+        MazeEdge edge;
+        edge.from = edgeObj.value("from").toInt();
+        edge.to = edgeObj.value("to").toInt();
+        edge.open = edgeObj.value("open").toBool();
+        graph.edges.push_back(edge);
+    }
+
+    return graph;
+}
+
+QJsonArray intGridToJson(const std::vector<std::vector<int>>& grid) {
+    QJsonArray rows;
+    for (const auto& row : grid) {
+        QJsonArray jsonRow;
+        for (int cell : row) {
+            jsonRow.append(cell);
+        }
+        rows.append(jsonRow);
+    }
+    return rows;
+}
+
+std::vector<std::vector<int>> intGridFromJson(const QJsonArray& arr) {
+    std::vector<std::vector<int>> grid;
+    grid.reserve(arr.size());
+    for (const auto& rowVal : arr) {
+        if (!rowVal.isArray()) {
+            grid.clear();
+            return {};
+        }
+        const auto rowArray = rowVal.toArray();
+        std::vector<int> row;
+        row.reserve(rowArray.size());
+        for (const auto& cellVal : rowArray) {
+            row.push_back(cellVal.toInt());
+        }
+        grid.push_back(std::move(row));
+    }
+    return grid;
+}
+}
+
+int algorithmToInt(const GenerationAlgorithm algorithm) {
+    return static_cast<int>(algorithm);
+}
+
+GenerationAlgorithm algorithmFromInt(const int value) {
+    switch (value) {
+        case static_cast<int>(GenerationAlgorithm::DFS): return GenerationAlgorithm::DFS;
+        case static_cast<int>(GenerationAlgorithm::BFS): return GenerationAlgorithm::BFS;
+        case static_cast<int>(GenerationAlgorithm::Wilson): return GenerationAlgorithm::Wilson;
+        case static_cast<int>(GenerationAlgorithm::Kruskal): return GenerationAlgorithm::Kruskal;
+        case static_cast<int>(GenerationAlgorithm::Prim): return GenerationAlgorithm::Prim;
+        case static_cast<int>(GenerationAlgorithm::Tessellation): return GenerationAlgorithm::Tessellation;
+        default: return GenerationAlgorithm::DFS;
+    }
+}
+
+QJsonObject savedPuzzleToJson(const SavedPuzzle& saved) {
+    QJsonObject obj;
+    switch (saved.type) {
+        case SavedPuzzle::Type::Maze:
+            if (saved.maze()) {
+                const auto& maze = *saved.maze();
+                obj["type"] = "maze";
+                obj["name"] = QString::fromStdString(maze.name);
+                obj["algorithm"] = algorithmToInt(maze.algorithm);
+                obj["width"] = maze.width;
+                obj["height"] = maze.height;
+                obj["graph"] = graphToJson(maze.graph);
+                obj["entranceNode"] = maze.entranceNode;
+                obj["exitNode"] = maze.exitNode;
+                obj["playerNode"] = maze.playerNode;
+            }
+            break;
+        case SavedPuzzle::Type::Crossword:
+            if (saved.crossword()) {
+                const auto& cw = *saved.crossword();
+                obj["type"] = "crossword";
+                obj["name"] = QString::fromStdString(cw.name);
+                QJsonArray grid;
+                for (const auto& row : cw.puzzle.grid) {
+                    grid.append(QString::fromStdString(row));
+                }
+                obj["grid"] = grid;
+                obj["numbers"] = intGridToJson(cw.puzzle.numbers);
+                QJsonArray across;
+                for (const auto& entry : cw.puzzle.across) {
+                    QJsonObject e;
+                    e["number"] = entry.number;
+                    e["word"] = QString::fromStdString(entry.word);
+                    across.append(e);
+                }
+                obj["across"] = across;
+                QJsonArray down;
+                for (const auto& entry : cw.puzzle.down) {
+                    QJsonObject e;
+                    e["number"] = entry.number;
+                    e["word"] = QString::fromStdString(entry.word);
+                    down.append(e);
+                }
+                obj["down"] = down;
+                QJsonObject hints;
+                for (const auto& [word, hint] : cw.hints) {
+                    hints[QString::fromStdString(word)] = QString::fromStdString(hint);
+                }
+                obj["hints"] = hints;
+            }
+            break;
+        case SavedPuzzle::Type::WordSearch:
+            if (saved.wordSearch()) {
+                const auto& ws = *saved.wordSearch();
+                obj["type"] = "wordsearch";
+                obj["name"] = QString::fromStdString(ws.name);
+                obj["size"] = ws.puzzle.size;
+                QJsonArray grid;
+                for (const auto& row : ws.puzzle.grid) {
+                    std::string rowStr(row.begin(), row.end());
+                    grid.append(QString::fromStdString(rowStr));
+                }
+                obj["grid"] = grid;
+                QJsonArray words;
+                for (const auto& word : ws.puzzle.words) {
+                    words.append(QString::fromStdString(word));
+                }
+                obj["words"] = words;
+            }
+            break;
+        case SavedPuzzle::Type::Sudoku:
+            if (saved.sudoku()) {
+                const auto& sdk = *saved.sudoku();
+                obj["type"] = "sudoku";
+                obj["name"] = QString::fromStdString(sdk.name);
+                obj["difficulty"] = sdk.difficulty;
+                obj["grid"] = intGridToJson(sdk.puzzle.grid);
+                obj["solution"] = intGridToJson(sdk.puzzle.solution);
+            }
+            break;
+        case SavedPuzzle::Type::Cryptogram:
+            if (saved.cryptogram()) {
+                const auto& crypto = *saved.cryptogram();
+                obj["type"] = "cryptogram";
+                obj["name"] = QString::fromStdString(crypto.name);
+                obj["plainText"] = QString::fromStdString(crypto.puzzle.plainText);
+                obj["cipherText"] = QString::fromStdString(crypto.puzzle.cipherText);
+                QJsonObject mapping;
+                for (const auto& [cipher, plain] : crypto.puzzle.cipherToPlain) {
+                    mapping[QString(QChar(cipher))] = QString(QChar(plain));
+                }
+                obj["cipherToPlain"] = mapping;
+                QJsonArray revealed;
+                for (char r : crypto.puzzle.revealed) {
+                    revealed.append(QString(QChar(r)));
+                }
+                obj["revealed"] = revealed;
+                obj["avoidSelfMapping"] = crypto.avoidSelfMapping;
+                obj["hintCount"] = crypto.hintCount;
+            }
+            break;
+    }
+    return obj;
+}
+
+std::optional<SavedPuzzle> savedPuzzleFromJson(const QJsonObject& obj) {
+    const QString type = obj.value("type").toString();
+    if (type == "maze") {
+        const auto graph = graphFromJson(obj.value("graph").toObject());
+        if (!graph) {
+            return std::nullopt;
+        }
+        return SavedPuzzle(SavedMaze {
+            obj.value("name").toString("Maze").toStdString(),
+            algorithmFromInt(obj.value("algorithm").toInt(static_cast<int>(GenerationAlgorithm::DFS))),
+            obj.value("width").toInt(graph->cols),
+            obj.value("height").toInt(graph->rows),
+            *graph,
+            obj.value("entranceNode").toInt(graph->entranceNode),
+            obj.value("exitNode").toInt(graph->exitNode),
+            obj.value("playerNode").toInt(graph->entranceNode)
+        });
+    }
+    if (type == "crossword") {
+        SavedCrossword cw;
+        cw.name = obj.value("name").toString("Crossword").toStdString();
+        for (const auto& rowVal : obj.value("grid").toArray()) {
+            cw.puzzle.grid.push_back(rowVal.toString().toStdString());
+        }
+        cw.puzzle.numbers = intGridFromJson(obj.value("numbers").toArray());
+        for (const auto& entryValAcross : obj.value("across").toArray()) {
+            const auto eObj = entryValAcross.toObject();
+            CrosswordEntry cwEntry;
+            cwEntry.number = eObj.value("number").toInt();
+            cwEntry.word = eObj.value("word").toString().toStdString();
+            cw.puzzle.across.push_back(cwEntry);
+        }
+        for (const auto& entryValDown : obj.value("down").toArray()) {
+            const auto eObj = entryValDown.toObject();
+            CrosswordEntry cwEntry;
+            cwEntry.number = eObj.value("number").toInt();
+            cwEntry.word = eObj.value("word").toString().toStdString();
+            cw.puzzle.down.push_back(cwEntry);
+        }
+        const auto hints = obj.value("hints").toObject();
+        for (auto it = hints.begin(); it != hints.end(); ++it) {
+            cw.hints[it.key().toStdString()] = it.value().toString().toStdString();
+        }
+        if (cw.puzzle.grid.empty()) {
+            return std::nullopt;
+        }
+        return SavedPuzzle(std::move(cw));
+    }
+    if (type == "wordsearch") {
+        SavedWordSearch ws;
+        ws.name = obj.value("name").toString("Word Search").toStdString();
+        ws.puzzle.size = obj.value("size").toInt();
+        for (const auto& rowVal : obj.value("grid").toArray()) {
+            const auto rowStr = rowVal.toString().toStdString();
+            std::vector<char> row(rowStr.begin(), rowStr.end());
+            ws.puzzle.grid.push_back(row);
+        }
+        for (const auto& wordVal : obj.value("words").toArray()) {
+            ws.puzzle.words.push_back(wordVal.toString().toStdString());
+        }
+        if (ws.puzzle.size <= 0 || ws.puzzle.grid.empty()) {
+            return std::nullopt;
+        }
+        return SavedPuzzle(std::move(ws));
+    }
+    if (type == "sudoku") {
+        SavedSudoku sdk;
+        sdk.name = obj.value("name").toString("Sudoku").toStdString();
+        sdk.difficulty = obj.value("difficulty").toInt(0);
+        sdk.puzzle.grid = intGridFromJson(obj.value("grid").toArray());
+        sdk.puzzle.solution = intGridFromJson(obj.value("solution").toArray());
+        if (sdk.puzzle.grid.empty()) {
+            return std::nullopt;
+        }
+        return SavedPuzzle(std::move(sdk));
+    }
+    if (type == "cryptogram") {
+        SavedCryptogram crypto;
+        crypto.name = obj.value("name").toString("Cryptogram").toStdString();
+        crypto.puzzle.plainText = obj.value("plainText").toString().toStdString();
+        crypto.puzzle.cipherText = obj.value("cipherText").toString().toStdString();
+        const auto mapping = obj.value("cipherToPlain").toObject();
+        for (auto it = mapping.begin(); it != mapping.end(); ++it) {
+            if (!it.key().isEmpty() && !it.value().toString().isEmpty()) {
+                crypto.puzzle.cipherToPlain[it.key().at(0).toLatin1()] = it.value().toString().at(0).toLatin1();
+            }
+        }
+        for (const auto& val : obj.value("revealed").toArray()) {
+            const auto str = val.toString();
+            if (!str.isEmpty()) {
+                crypto.puzzle.revealed.insert(str.at(0).toLatin1());
+            }
+        }
+        crypto.avoidSelfMapping = obj.value("avoidSelfMapping").toBool(true);
+        crypto.hintCount = obj.value("hintCount").toInt(0);
+        return SavedPuzzle(std::move(crypto));
+    }
+    return std::nullopt;
+}
+
+QJsonArray savedPuzzlesToJson(const std::vector<SavedPuzzle>& puzzles) {
+    QJsonArray array;
+    for (const auto& saved : puzzles) {
+        const QJsonObject obj = savedPuzzleToJson(saved);
+        if (!obj.isEmpty()) {
+            array.append(obj);
+        }
+    }
+    return array;
+}
+
+std::vector<SavedPuzzle> savedPuzzlesFromJson(const QJsonArray& puzzles) {
+    std::vector<SavedPuzzle> result;
+    result.reserve(static_cast<std::size_t>(puzzles.size()));
+    for (const auto& entryVal : puzzles) {
+        if (auto saved = savedPuzzleFromJson(entryVal.toObject())) {
+            result.push_back(std::move(*saved));
+        }
+    }
+    return result;
+}
+
+QByteArray libraryToJsonDocument(const std::vector<SavedPuzzle>& puzzles) {
+    QJsonObject root;
+    root["version"] = 1;
+    root["puzzles"] = savedPuzzlesToJson(puzzles);
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+std::optional<std::vector<SavedPuzzle>> libraryFromJsonDocument(const QByteArray& data) {
+    const auto doc = QJsonDocument::fromJson(data);
+    if (!doc.isObject()) {
+        return std::nullopt;
+    }
+    const auto root = doc.object();
+    if (root.value("version").toInt(0) != 1) {
+        return std::nullopt;
+    }
+    return savedPuzzlesFromJson(root.value("puzzles").toArray());
+}
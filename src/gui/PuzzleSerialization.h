@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <optional>
+#include <vector>
+
+#include "SavedPuzzle.h"
+
+[[nodiscard]] int algorithmToInt(GenerationAlgorithm algorithm);
+[[nodiscard]] GenerationAlgorithm algorithmFromInt(int value);
+
+[[nodiscard]] QJsonObject savedPuzzleToJson(const SavedPuzzle& puzzle);
+[[nodiscard]] std::optional<SavedPuzzle> savedPuzzleFromJson(const QJsonObject& obj);
+
+// Reads and writes the `version: 1` document used by the state file and library export.
+[[nodiscard]] QJsonArray savedPuzzlesToJson(const std::vector<SavedPuzzle>& puzzles);
+[[nodiscard]] std::vector<SavedPuzzle> savedPuzzlesFromJson(const QJsonArray& puzzles);
+[[nodiscard]] QByteArray libraryToJsonDocument(const std::vector<SavedPuzzle>& puzzles);
+[[nodiscard]] std::optional<std::vector<SavedPuzzle>> libraryFromJsonDocument(const QByteArray& data);
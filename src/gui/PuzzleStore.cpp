@@ -0,0 +1,493 @@
+#include "PuzzleStore.h"
+
+#include <QDir>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <span>
+#include <unordered_set>
+#include <utility>
+
+#include "Crc32.h"
+#include "PuzzleArchive.h"
+#include "PuzzleSerialization.h"
+
+namespace {
+constexpr int kCompactMinRecords = 256;
+// Large enough for the record of a whole import batch.
+constexpr qint64 kMaxJournalRecord = 1 << 26;
+const QString kBatchPrefix = "batch-";
+
+QByteArray frameRecord(const QByteArray& payload) {
+    QByteArray framed(8, '\0');
+    qToLittleEndian<quint32>(static_cast<quint32>(payload.size()), framed.data());
+    qToLittleEndian<quint32>(crc32Update(0, payload.constData(), static_cast<std::size_t>(payload.size())), framed.data() + 4);
+    framed.append(payload);
+    return framed;
+}
+
+QJsonObject metaObject(const quint64 id, const SavedPuzzle::Type type, const std::string& name,
+                       const std::vector<std::string>& terms, const std::uint64_t contentHash,
+                       const PuzzleRecordLocation& location) {
+    QJsonArray termArray;
+    for (const auto& term : terms) {
+        termArray.append(QString::fromStdString(term));
+    }
+    QJsonObject obj;
+    obj["id"] = static_cast<qint64>(id);
+    obj["type"] = static_cast<int>(type);
+    obj["name"] = QString::fromStdString(name);
+    obj["terms"] = termArray;
+    obj["hash"] = QString::number(contentHash, 16);
+    if (location.batch != 0) {
+        obj["batch"] = static_cast<qint64>(location.batch);
+        obj["slot"] = static_cast<qint64>(location.slot);
+    }
+    return obj;
+}
+
+QByteArray metaRecord(const char* op, const quint64 id, const SavedPuzzle::Type type, const std::string& name,
+                      const std::vector<std::string>& terms, const std::uint64_t contentHash,
+                      const PuzzleRecordLocation& location) {
+    QJsonObject obj = metaObject(id, type, name, terms, contentHash, location);
+    obj["op"] = op;
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+// Records written before batches existed have no location, which is the puzzle's own file.
+PuzzleRecordLocation locationFromJson(const QJsonObject& obj) {
+    return PuzzleRecordLocation{static_cast<quint64>(obj.value("batch").toDouble()),
+                                static_cast<std::uint32_t>(obj.value("slot").toDouble())};
+}
+
+std::vector<std::string> termsFromJson(const QJsonArray& array) {
+    std::vector<std::string> terms;
+    terms.reserve(static_cast<std::size_t>(array.size()));
+    for (const auto& value : array) {
+        terms.push_back(value.toString().toStdString());
+    }
+    return terms;
+}
+
+QByteArray idRecord(const char* op, const quint64 id) {
+    QJsonObject obj;
+    obj["op"] = op;
+    obj["id"] = static_cast<qint64>(id);
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+QByteArray orderRecord(const std::vector<quint64>& ids) {
+    QJsonArray array;
+    for (const quint64 id : ids) {
+        array.append(static_cast<qint64>(id));
+    }
+    QJsonObject obj;
+    obj["op"] = "order";
+    obj["ids"] = array;
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+QByteArray sessionRecord(const PuzzleStoreSession& session) {
+    QJsonObject obj;
+    obj["op"] = "session";
+    obj["selectedIndex"] = session.selectedIndex;
+    obj["loadedIndex"] = session.loadedIndex;
+    obj["inTestMode"] = session.inTestMode;
+    obj["activeType"] = session.activeType;
+    return QJsonDocument(obj).toJson(QJsonDocument::Compact);
+}
+
+PuzzleStoreSession sessionFromJson(const QJsonObject& obj) {
+    PuzzleStoreSession session;
+    session.selectedIndex = obj.value("selectedIndex").toInt(-1);
+    session.loadedIndex = obj.value("loadedIndex").toInt(-1);
+    session.inTestMode = obj.value("inTestMode").toBool(false);
+    session.activeType = obj.value("activeType").toInt(0);
+    return session;
+}
+}
+
+PuzzleStore::PuzzleStore(QString directory, QString legacyStateFile)
+    : directory_(std::move(directory)), legacyStateFile_(std::move(legacyStateFile)) {
+    QDir().mkpath(directory_);
+}
+
+QString PuzzleStore::journalPath() const {
+    return directory_ + "/journal.log";
+}
+
+QString PuzzleStore::recordPath(const quint64 id) const {
+    return directory_ + QString("/%1.puzzles").arg(id);
+}
+
+QString PuzzleStore::batchPath(const quint64 batch) const {
+    return directory_ + "/" + kBatchPrefix + QString("%1.puzzles").arg(batch);
+}
+
+PuzzleRecordRef PuzzleStore::recordRef(const quint64 id, const PuzzleRecordLocation& location) const {
+    if (location.batch != 0) {
+        return PuzzleRecordRef{batchPath(location.batch), location.slot};
+    }
+    return PuzzleRecordRef{recordPath(id), 0};
+}
+
+bool PuzzleStore::writeRecord(const quint64 id, const SavedPuzzle& puzzle) {
+    return writePuzzleArchive(recordPath(id), std::span<const SavedPuzzle>(&puzzle, 1));
+}
+
+void PuzzleStore::addMeta(const quint64 id, Meta meta) {
+    if (!meta_.count(id)) {
+        order_.push_back(id);
+    }
+    nextId_ = std::max({nextId_, id + 1, meta.location.batch + 1});
+    meta_[id] = std::move(meta);
+}
+
+void PuzzleStore::releaseRecord(const quint64 id, const PuzzleRecordLocation& location) {
+    if (location.batch == 0) {
+        QFile::remove(recordPath(id));
+        return;
+    }
+    const auto it = batchRefs_.find(location.batch);
+    if (it != batchRefs_.end() && --it->second <= 0) {
+        batchRefs_.erase(it);
+        QFile::remove(batchPath(location.batch));
+    }
+}
+
+void PuzzleStore::countBatchRefs() {
+    batchRefs_.clear();
+    for (const auto& [id, meta] : meta_) {
+        if (meta.location.batch != 0) {
+            ++batchRefs_[meta.location.batch];
+        }
+    }
+}
+
+bool PuzzleStore::appendJournal(const QByteArray& payload) {
+    QFile file(journalPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+    const QByteArray framed = frameRecord(payload);
+    const bool ok = file.write(framed) == framed.size() && file.flush();
+    ++journalRecords_;
+    return ok;
+}
+
+bool PuzzleStore::replayJournal() {
+    QFile file(journalPath());
+    if (!file.open(QIODevice::ReadWrite)) {
+        return false;
+    }
+    const qint64 size = file.size();
+    uchar* data = size > 0 ? file.map(0, size) : nullptr;
+    if (size > 0 && !data) {
+        return false;
+    }
+
+    qint64 pos = 0;
+    while (size - pos >= 8) {
+        const quint32 length = qFromLittleEndian<quint32>(data + pos);
+        const quint32 crc = qFromLittleEndian<quint32>(data + pos + 4);
+        if (length > kMaxJournalRecord || length > size - pos - 8
+            || crc32Update(0, data + pos + 8, length) != crc) {
+            break;
+        }
+        const QJsonObject obj = QJsonDocument::fromJson(
+            QByteArray::fromRawData(reinterpret_cast<const char*>(data + pos + 8), static_cast<int>(length))).object();
+        pos += 8 + length;
+        ++journalRecords_;
+
+        const QString op = obj.value("op").toString();
+        const auto id = static_cast<quint64>(obj.value("id").toDouble());
+        const auto metaFromJson = [](const QJsonObject& fields) {
+            return Meta{static_cast<SavedPuzzle::Type>(fields.value("type").toInt()),
+                        fields.value("name").toString().toStdString(),
+                        termsFromJson(fields.value("terms").toArray()),
+                        fields.value("hash").toString().toULongLong(nullptr, 16),
+                        locationFromJson(fields)};
+        };
+        if (op == "add") {
+            addMeta(id, metaFromJson(obj));
+        } else if (op == "batch") {
+            const auto batch = static_cast<quint64>(obj.value("batch").toDouble());
+            for (const auto& value : obj.value("puzzles").toArray()) {
+                QJsonObject fields = value.toObject();
+                fields["batch"] = static_cast<qint64>(batch);
+                addMeta(static_cast<quint64>(fields.value("id").toDouble()), metaFromJson(fields));
+            }
+        } else if (op == "update") {
+            // Records written before update carried metadata have no name; keep the old one. An
+            // update always rewrites the puzzle's own file, so it no longer lives in a batch.
+            if (const auto it = meta_.find(id); it != meta_.end()) {
+                if (obj.contains("name")) {
+                    it->second.name = obj.value("name").toString().toStdString();
+                    it->second.terms = termsFromJson(obj.value("terms").toArray());
+                    it->second.contentHash = obj.value("hash").toString().toULongLong(nullptr, 16);
+                }
+                it->second.location = {};
+            }
+        } else if (op == "remove") {
+            meta_.erase(id);
+            order_.erase(std::remove(order_.begin(), order_.end(), id), order_.end());
+        } else if (op == "order") {
+            std::vector<quint64> order;
+            for (const auto& value : obj.value("ids").toArray()) {
+                const auto orderedId = static_cast<quint64>(value.toDouble());
+                if (meta_.count(orderedId)) {
+                    order.push_back(orderedId);
+                }
+            }
+            if (order.size() == order_.size()) {
+                order_ = std::move(order);
+            }
+        } else if (op == "session") {
+            session_ = sessionFromJson(obj);
+        }
+    }
+
+    if (data) {
+        file.unmap(data);
+    }
+    if (pos < size) {
+        file.resize(pos);
+    }
+    return true;
+}
+
+bool PuzzleStore::compact() {
+    QSaveFile file(journalPath());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    for (const quint64 id : order_) {
+        const auto& meta = meta_.at(id);
+        file.write(frameRecord(metaRecord("add", id, meta.type, meta.name, meta.terms, meta.contentHash, meta.location)));
+    }
+    file.write(frameRecord(sessionRecord(session_)));
+    if (!file.commit()) {
+        return false;
+    }
+    journalRecords_ = static_cast<int>(order_.size()) + 1;
+    return true;
+}
+
+void PuzzleStore::compactIfLarge() {
+    if (journalRecords_ > std::max(kCompactMinRecords, static_cast<int>(order_.size()) * 4)) {
+        compact();
+    }
+}
+
+void PuzzleStore::dropMissingRecords() {
+    const QDir dir(directory_);
+    std::unordered_set<quint64> present;
+    std::unordered_set<quint64> presentBatches;
+    for (const QString& entry : dir.entryList({"*.puzzles"}, QDir::Files)) {
+        const QString base = QFileInfo(entry).completeBaseName();
+        bool ok = false;
+        if (base.startsWith(kBatchPrefix)) {
+            const quint64 batch = base.mid(kBatchPrefix.size()).toULongLong(&ok);
+            if (ok && batchRefs_.count(batch)) {
+                presentBatches.insert(batch);
+            } else if (ok) {
+                QFile::remove(dir.filePath(entry));
+            }
+            continue;
+        }
+        const quint64 id = base.toULongLong(&ok);
+        if (!ok) {
+            continue;
+        }
+        if (const auto it = meta_.find(id); it != meta_.end() && it->second.location.batch == 0) {
+            present.insert(id);
+        } else {
+            QFile::remove(dir.filePath(entry));
+        }
+    }
+
+    const auto stored = [&](const quint64 id) {
+        const quint64 batch = meta_.at(id).location.batch;
+        return batch == 0 ? present.count(id) != 0 : presentBatches.count(batch) != 0;
+    };
+    if (std::all_of(order_.begin(), order_.end(), stored)) {
+        return;
+    }
+    std::vector<quint64> kept;
+    for (const quint64 id : order_) {
+        if (stored(id)) {
+            kept.push_back(id);
+        } else {
+            meta_.erase(id);
+        }
+    }
+    order_ = std::move(kept);
+    countBatchRefs();
+    compact();
+}
+
+PuzzleStoreContents PuzzleStore::contents() const {
+    PuzzleStoreContents contents;
+    contents.session = session_;
+    contents.entries.reserve(order_.size());
+    for (const quint64 id : order_) {
+        const auto& meta = meta_.at(id);
+        contents.entries.push_back(PuzzleStoreEntry{id, meta.type, meta.name, meta.terms, meta.contentHash, meta.location});
+    }
+    return contents;
+}
+
+bool PuzzleStore::migrateLegacyState() {
+    QFile legacy(legacyStateFile_);
+    if (!legacy.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray bytes = legacy.readAll();
+    legacy.close();
+    const auto puzzles = libraryFromJsonDocument(bytes);
+    if (!puzzles) {
+        return false;
+    }
+
+    for (const auto& puzzle : *puzzles) {
+        const quint64 id = allocateId();
+        if (!writeRecord(id, puzzle)) {
+            return false;
+        }
+        order_.push_back(id);
+        meta_[id] = Meta{puzzle.type, savedPuzzleName(puzzle), savedPuzzleSearchTerms(puzzle), puzzleContentHash(puzzle),
+                         PuzzleRecordLocation{}};
+    }
+    session_ = sessionFromJson(QJsonDocument::fromJson(bytes).object());
+    if (!compact()) {
+        return false;
+    }
+    QFile::remove(legacyStateFile_ + ".migrated");
+    QFile::rename(legacyStateFile_, legacyStateFile_ + ".migrated");
+    return true;
+}
+
+std::optional<PuzzleStoreContents> PuzzleStore::load() {
+    order_.clear();
+    meta_.clear();
+    batchRefs_.clear();
+    session_ = {};
+    journalRecords_ = 0;
+
+    if (!QFile::exists(journalPath())) {
+        if (QFile::exists(legacyStateFile_) && migrateLegacyState()) {
+            return contents();
+        }
+        return std::nullopt;
+    }
+    if (!replayJournal()) {
+        return std::nullopt;
+    }
+    countBatchRefs();
+    dropMissingRecords();
+    compactIfLarge();
+    return contents();
+}
+
+std::optional<SavedPuzzle> PuzzleStore::readRecord(const PuzzleRecordRef& record) {
+    PuzzleArchiveReader reader;
+    if (!reader.open(record.path) || record.slot >= reader.entries().size()) {
+        return std::nullopt;
+    }
+    return reader.load(record.slot);
+}
+
+std::vector<quint64> PuzzleStore::sync(const std::vector<quint64>& ids,
+                                       const std::vector<PuzzleStoreBatch>& batches,
+                                       const std::vector<std::pair<quint64, SavedPuzzle>>& changed,
+                                       const PuzzleStoreSession& session) {
+    const std::unordered_set<quint64> live(ids.begin(), ids.end());
+    for (auto it = order_.begin(); it != order_.end();) {
+        if (live.count(*it)) {
+            ++it;
+            continue;
+        }
+        const quint64 id = *it;
+        appendJournal(idRecord("remove", id));
+        releaseRecord(id, meta_.at(id).location);
+        meta_.erase(id);
+        it = order_.erase(it);
+    }
+
+    std::vector<quint64> written;
+    written.reserve(changed.size());
+    // The whole batch is written even if some of it was removed while queued; those slots are
+    // simply never referenced.
+    for (const auto& batch : batches) {
+        const bool anyLive = std::any_of(batch.ids.begin(), batch.ids.end(), [&](const quint64 id) {
+            return live.count(id) && !meta_.count(id);
+        });
+        if (!anyLive || !writePuzzleArchive(batchPath(batch.batch), batch.puzzles)) {
+            continue;
+        }
+        QJsonArray puzzles;
+        for (std::size_t i = 0; i < batch.ids.size() && i < batch.puzzles.size(); ++i) {
+            const quint64 id = batch.ids[i];
+            if (!live.count(id) || meta_.count(id)) {
+                continue;
+            }
+            const SavedPuzzle& puzzle = batch.puzzles[i];
+            const Meta meta{puzzle.type, savedPuzzleName(puzzle), savedPuzzleSearchTerms(puzzle), puzzleContentHash(puzzle),
+                            PuzzleRecordLocation{batch.batch, static_cast<std::uint32_t>(i)}};
+            QJsonObject fields = metaObject(id, meta.type, meta.name, meta.terms, meta.contentHash, meta.location);
+            fields.remove("batch");
+            puzzles.append(fields);
+            addMeta(id, meta);
+            ++batchRefs_[batch.batch];
+            written.push_back(id);
+        }
+        QJsonObject obj;
+        obj["op"] = "batch";
+        obj["batch"] = static_cast<qint64>(batch.batch);
+        obj["puzzles"] = puzzles;
+        appendJournal(QJsonDocument(obj).toJson(QJsonDocument::Compact));
+    }
+
+    for (const auto& [id, puzzle] : changed) {
+        if (!live.count(id) || !writeRecord(id, puzzle)) {
+            continue;
+        }
+        const bool known = meta_.count(id) != 0;
+        auto& meta = meta_[id];
+        const PuzzleRecordLocation previous = meta.location;
+        meta = Meta{puzzle.type, savedPuzzleName(puzzle), savedPuzzleSearchTerms(puzzle), puzzleContentHash(puzzle),
+                    PuzzleRecordLocation{}};
+        if (!known) {
+            order_.push_back(id);
+        }
+        appendJournal(metaRecord(known ? "update" : "add", id, meta.type, meta.name, meta.terms, meta.contentHash, meta.location));
+        if (previous.batch != 0) {
+            releaseRecord(id, previous);
+        }
+        written.push_back(id);
+    }
+
+    std::vector<quint64> stored;
+    stored.reserve(ids.size());
+    for (const quint64 id : ids) {
+        if (meta_.count(id)) {
+            stored.push_back(id);
+        }
+    }
+    if (stored != order_) {
+        order_ = std::move(stored);
+        appendJournal(orderRecord(order_));
+    }
+
+    if (session != session_) {
+        session_ = session;
+        appendJournal(sessionRecord(session_));
+    }
+
+    compactIfLarge();
+    return written;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "SavedPuzzle.h"
+
+struct PuzzleStoreSession {
+    int selectedIndex = -1;
+    int loadedIndex = -1;
+    bool inTestMode = false;
+    int activeType = 0;
+
+    bool operator==(const PuzzleStoreSession&) const = default;
+};
+
+// Where a body is stored: its own archive when batch is 0, otherwise entry slot of the archive
+// shared by one import batch.
+struct PuzzleRecordLocation {
+    quint64 batch = 0;
+    std::uint32_t slot = 0;
+};
+
+// A stored body as a file and an entry within it, for reading off the GUI thread.
+struct PuzzleRecordRef {
+    QString path;
+    std::uint32_t slot = 0;
+};
+
+struct PuzzleStoreEntry {
+    quint64 id = 0;
+    SavedPuzzle::Type type = SavedPuzzle::Type::Maze;
+    std::string name;
+    std::vector<std::string> terms;
+    // puzzleContentHash of the stored body, or 0 when the journal predates it.
+    std::uint64_t contentHash = 0;
+    PuzzleRecordLocation location;
+};
+
+// Puzzles added together in bulk, written as one archive with one journal record.
+struct PuzzleStoreBatch {
+    quint64 batch = 0;
+    std::vector<quint64> ids;
+    std::vector<SavedPuzzle> puzzles;
+};
+
+struct PuzzleStoreContents {
+    std::vector<PuzzleStoreEntry> entries;
+    PuzzleStoreSession session;
+};
+
+// Library directory with one archive file per puzzle and an append-only metadata journal.
+// Bodies are only rewritten when new or changed; list changes and selection cost a single
+// small journal record. Bulk imports instead share one archive and one journal record per batch;
+// a batch archive is deleted with the last of its puzzles, and a batched puzzle that is edited
+// moves to its own file. Each journal record is length- and CRC-framed so a torn tail from a
+// crash is dropped on load, and the journal is compacted into a fresh snapshot once it grows.
+// load() only replays the journal, which also carries each puzzle's search terms so the list
+// can be searched without reading bodies; those are read on demand with loadPuzzle().
+class PuzzleStore {
+public:
+    PuzzleStore(QString directory, QString legacyStateFile);
+
+    [[nodiscard]] std::optional<PuzzleStoreContents> load();
+    [[nodiscard]] std::optional<SavedPuzzle> loadPuzzle(quint64 id, const PuzzleRecordLocation& location) const {
+        return readRecord(recordRef(id, location));
+    }
+    [[nodiscard]] PuzzleRecordRef recordRef(quint64 id, const PuzzleRecordLocation& location) const;
+    // Reads one stored body; safe to call from any thread.
+    [[nodiscard]] static std::optional<SavedPuzzle> readRecord(const PuzzleRecordRef& record);
+    [[nodiscard]] quint64 nextId() const { return nextId_; }
+    // Brings the store in line with the library order in ids, writing only the bodies in batches
+    // and changed. Returns the ids whose records were written.
+    std::vector<quint64> sync(const std::vector<quint64>& ids,
+                              const std::vector<PuzzleStoreBatch>& batches,
+                              const std::vector<std::pair<quint64, SavedPuzzle>>& changed,
+                              const PuzzleStoreSession& session);
+
+private:
+    struct Meta {
+        SavedPuzzle::Type type = SavedPuzzle::Type::Maze;
+        std::string name;
+        std::vector<std::string> terms;
+        std::uint64_t contentHash = 0;
+        PuzzleRecordLocation location;
+    };
+
+    QString directory_;
+    QString legacyStateFile_;
+    quint64 nextId_ = 1;
+    std::vector<quint64> order_;
+    std::unordered_map<quint64, Meta> meta_;
+    // Live puzzles per batch archive.
+    std::unordered_map<quint64, int> batchRefs_;
+    PuzzleStoreSession session_;
+    int journalRecords_ = 0;
+
+    [[nodiscard]] quint64 allocateId() { return nextId_++; }
+    [[nodiscard]] QString journalPath() const;
+    [[nodiscard]] QString recordPath(quint64 id) const;
+    [[nodiscard]] QString batchPath(quint64 batch) const;
+    bool writeRecord(quint64 id, const SavedPuzzle& puzzle);
+    void addMeta(quint64 id, Meta meta);
+    // Deletes the body's own file, or drops its hold on its batch archive.
+    void releaseRecord(quint64 id, const PuzzleRecordLocation& location);
+    void countBatchRefs();
+    bool appendJournal(const QByteArray& payload);
+    bool replayJournal();
+    bool compact();
+    void compactIfLarge();
+    void dropMissingRecords();
+    [[nodiscard]] PuzzleStoreContents contents() const;
+    bool migrateLegacyState();
+};
@@ -0,0 +1,259 @@
+#include "PuzzleThumbnailer.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFont>
+#include <QMetaObject>
+#include <QPainter>
+#include <QPointer>
+#include <QSaveFile>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+#include "CryptogramWidget.h"
+#include "MazeMipmap.h"
+#include "PuzzleArchive.h"
+#include "PuzzleStore.h"
+#include "SudokuSolver.h"
+#include "maze_walls.h"
+
+namespace {
+constexpr int kCacheBytes = 16 << 20;
+constexpr int kCryptogramWidth = 480;
+
+std::pair<int, int> nodeRowCol(const MazeGraph& g, const int nodeId) {
+    if (nodeId < 0 || nodeId >= static_cast<int>(g.nodes.size())) return {-1, -1};
+    const auto& n = g.nodes[nodeId];
+    return {n.row, n.col};
+}
+
+QString thumbnailPath(const QString& directory, const std::uint64_t contentHash, const QColor& line, const QColor& background) {
+    return QString("%1/%2-%3-%4.png")
+        .arg(directory)
+        .arg(static_cast<qulonglong>(contentHash), 16, 16, QChar('0'))
+        .arg(line.rgb() & 0xffffffu, 6, 16, QChar('0'))
+        .arg(background.rgb() & 0xffffffu, 6, 16, QChar('0'));
+}
+
+// Scales image into the thumbnail square, centred on the background.
+QImage fitThumbnail(const QImage& image, const QColor& background) {
+    QImage thumbnail(PuzzleThumbnailer::kSize, PuzzleThumbnailer::kSize, QImage::Format_ARGB32_Premultiplied);
+    thumbnail.fill(background);
+    if (image.isNull()) {
+        return thumbnail;
+    }
+    const QImage scaled = image.scaled(thumbnail.size(), Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    QPainter painter(&thumbnail);
+    painter.drawImage((thumbnail.width() - scaled.width()) / 2, (thumbnail.height() - scaled.height()) / 2, scaled);
+    return thumbnail;
+}
+
+QImage renderMaze(const SavedMaze& maze, const QColor& line, const QColor& background) {
+    const MazeWalls walls = make_maze_walls(maze.graph);
+    QImage level = makeMazeMipmapBase(walls, nodeRowCol(maze.graph, maze.entranceNode), nodeRowCol(maze.graph, maze.exitNode));
+    while (!level.isNull() && std::max(level.width(), level.height()) > 2 * PuzzleThumbnailer::kSize) {
+        level = downsampleMazeMipmap(level);
+    }
+    if (level.isNull()) {
+        return fitThumbnail({}, background);
+    }
+    level.setColorTable(mazeMipmapColorTable(line, background));
+    return fitThumbnail(level.convertToFormat(QImage::Format_ARGB32), background);
+}
+
+// Draws a rows x cols grid filling the thumbnail. cell(r, c) returns the character to show (or 0)
+// and whether the cell is blocked; characters are only drawn once cells are big enough to read.
+template <typename CellFn>
+QImage renderGrid(const int rows, const int cols, const int box, const QColor& line, const QColor& background,
+                  CellFn cell) {
+    QImage thumbnail(PuzzleThumbnailer::kSize, PuzzleThumbnailer::kSize, QImage::Format_ARGB32_Premultiplied);
+    thumbnail.fill(background);
+    if (rows <= 0 || cols <= 0) {
+        return thumbnail;
+    }
+    const int cellPx = std::max(1, (PuzzleThumbnailer::kSize - 1) / std::max(rows, cols));
+    const int left = (PuzzleThumbnailer::kSize - cellPx * cols) / 2;
+    const int top = (PuzzleThumbnailer::kSize - cellPx * rows) / 2;
+
+    QPainter painter(&thumbnail);
+    QFont font;
+    font.setPixelSize(std::max(1, cellPx * 3 / 4));
+    painter.setFont(font);
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            const auto [ch, blocked] = cell(r, c);
+            const QRect rect(left + c * cellPx, top + r * cellPx, cellPx, cellPx);
+            if (blocked) {
+                painter.fillRect(rect, line);
+            } else if (ch != 0 && cellPx >= 6) {
+                painter.setPen(line);
+                painter.drawText(rect, Qt::AlignCenter, QString(QChar(ch)));
+            }
+        }
+    }
+    if (cellPx >= 3) {
+        painter.setPen(QPen(line, 1));
+        for (int r = 0; r <= rows; ++r) {
+            painter.drawLine(left, top + r * cellPx, left + cols * cellPx, top + r * cellPx);
+        }
+        for (int c = 0; c <= cols; ++c) {
+            painter.drawLine(left + c * cellPx, top, left + c * cellPx, top + rows * cellPx);
+        }
+    }
+    if (box > 1) {
+        painter.setPen(QPen(line, 2));
+        for (int r = 0; r <= rows; r += box) {
+            painter.drawLine(left, top + r * cellPx, left + cols * cellPx, top + r * cellPx);
+        }
+        for (int c = 0; c <= cols; c += box) {
+            painter.drawLine(left + c * cellPx, top, left + c * cellPx, top + rows * cellPx);
+        }
+    }
+    return thumbnail;
+}
+
+QImage renderCryptogram(const CryptogramPuzzle& puzzle, const QColor& line, const QColor& background) {
+    const int padding = 12;
+    const QSize measured = CryptogramWidget::renderPuzzle(nullptr, puzzle, nullptr, nullptr, nullptr, -1, false,
+                                                          kCryptogramWidth, padding, 32, nullptr, line, background);
+    if (measured.isEmpty()) {
+        return fitThumbnail({}, background);
+    }
+    QImage image(measured, QImage::Format_ARGB32_Premultiplied);
+    image.fill(background);
+    QPainter painter(&image);
+    CryptogramWidget::renderPuzzle(&painter, puzzle, nullptr, nullptr, nullptr, -1, false, kCryptogramWidth, padding, 32,
+                                   nullptr, line, background);
+    painter.end();
+    return fitThumbnail(image, background);
+}
+}
+
+QImage renderPuzzleThumbnail(const SavedPuzzle& puzzle, const QColor& line, const QColor& background) {
+    if (const auto* maze = puzzle.maze()) {
+        return renderMaze(*maze, line, background);
+    }
+    if (const auto* crossword = puzzle.crossword()) {
+        const auto& grid = crossword->puzzle.grid;
+        const int rows = static_cast<int>(grid.size());
+        const int cols = rows == 0 ? 0 : static_cast<int>(grid.front().size());
+        return renderGrid(rows, cols, 0, line, background, [&](const int r, const int c) {
+            return std::pair<char, bool>{0, grid[r][c] == '#'};
+        });
+    }
+    if (const auto* wordSearch = puzzle.wordSearch()) {
+        const auto& grid = wordSearch->puzzle.grid;
+        const int rows = static_cast<int>(grid.size());
+        const int cols = rows == 0 ? 0 : static_cast<int>(grid.front().size());
+        return renderGrid(rows, cols, 0, line, background, [&](const int r, const int c) {
+            return std::pair<char, bool>{grid[r][c], false};
+        });
+    }
+    if (const auto* sudoku = puzzle.sudoku()) {
+        const auto& grid = sudoku->puzzle.grid;
+        const int box = sudokuBoxSize(grid);
+        if (box == 0) {
+            return {};
+        }
+        return renderGrid(box * box, box * box, box, line, background, [&](const int r, const int c) {
+            return std::pair<char, bool>{sudokuSymbol(grid[r][c]), false};
+        });
+    }
+    if (const auto* cryptogram = puzzle.cryptogram()) {
+        return renderCryptogram(cryptogram->puzzle, line, background);
+    }
+    return {};
+}
+
+PuzzleThumbnailer::PuzzleThumbnailer(QString directory, QObject* parent)
+    : QObject(parent), directory_(std::move(directory)), cache_(kCacheBytes) {
+    QDir().mkpath(directory_);
+    pool_ = new QThreadPool(this);
+    pool_->setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+}
+
+PuzzleThumbnailer::~PuzzleThumbnailer() {
+    pool_->clear();
+    pool_->waitForDone();
+}
+
+void PuzzleThumbnailer::setColors(const QColor& line, const QColor& background) {
+    if (line == lineColor_ && background == backgroundColor_) {
+        return;
+    }
+    lineColor_ = line;
+    backgroundColor_ = background;
+    placeholder_ = QPixmap();
+    cache_.clear();
+    pending_.clear();
+    emit thumbnailsReset();
+}
+
+QPixmap PuzzleThumbnailer::thumbnail(const quint64 id, const std::uint64_t contentHash, const SavedPuzzle* body,
+                                     const PuzzleRecordRef& record) {
+    if (const QPixmap* cached = cache_.object(id)) {
+        return *cached;
+    }
+    if (placeholder_.isNull()) {
+        placeholder_ = QPixmap(kSize, kSize);
+        placeholder_.fill(backgroundColor_);
+    }
+    if (pending_.count(id)) {
+        return placeholder_;
+    }
+
+    const std::uint64_t ticket = ++ticket_;
+    pending_[id] = ticket;
+    std::optional<SavedPuzzle> copy;
+    if (body && savedPuzzleHasBody(*body)) {
+        copy = *body;
+    }
+    QPointer<PuzzleThumbnailer> self(this);
+    pool_->start([self, id, ticket, contentHash, copy = std::move(copy), record, directory = directory_,
+                  line = lineColor_, background = backgroundColor_]() mutable {
+        QImage image;
+        if (contentHash != 0) {
+            image.load(thumbnailPath(directory, contentHash, line, background), "PNG");
+        }
+        if (image.isNull()) {
+            if (!copy) {
+                copy = PuzzleStore::readRecord(record);
+            }
+            if (copy) {
+                const QString path = thumbnailPath(directory, puzzleContentHash(*copy), line, background);
+                if (!image.load(path, "PNG")) {
+                    image = renderPuzzleThumbnail(*copy, line, background);
+                    QSaveFile file(path);
+                    if (!image.isNull() && file.open(QIODevice::WriteOnly) && image.save(&file, "PNG")) {
+                        file.commit();
+                    }
+                }
+            }
+        }
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, id, ticket, image]() {
+            if (self) {
+                self->finished(id, ticket, image);
+            }
+        }, Qt::QueuedConnection);
+    });
+    return placeholder_;
+}
+
+void PuzzleThumbnailer::invalidate(const quint64 id) {
+    cache_.remove(id);
+    pending_.erase(id);
+}
+
+void PuzzleThumbnailer::finished(const quint64 id, const std::uint64_t ticket, const QImage& image) {
+    const auto it = pending_.find(id);
+    if (it == pending_.end() || it->second != ticket) {
+        return;
+    }
+    pending_.erase(it);
+    auto* pixmap = new QPixmap(image.isNull() ? placeholder_ : QPixmap::fromImage(image));
+    cache_.insert(id, pixmap, static_cast<int>(pixmap->width() * pixmap->height() * 4));
+    emit thumbnailReady(id);
+}
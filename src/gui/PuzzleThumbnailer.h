@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QCache>
+#include <QColor>
+#include <QObject>
+#include <QPixmap>
+#include <QString>
+#include <QtGlobal>
+#include <cstdint>
+#include <unordered_map>
+
+#include "PuzzleStore.h"
+#include "SavedPuzzle.h"
+
+class QThreadPool;
+
+// Small previews for the saved puzzle list. Thumbnails are rendered on a private thread pool with
+// plain QPainter/QImage drawing (widgets cannot leave the GUI thread) and written to
+// <directory>/<key>.png, where the key is the puzzle's content hash plus the colours. A later
+// session with the same hash loads the PNG instead of rendering, and only the recently shown
+// thumbnails stay in memory.
+class PuzzleThumbnailer : public QObject {
+    Q_OBJECT
+public:
+    static constexpr int kSize = 48;
+
+    explicit PuzzleThumbnailer(QString directory, QObject* parent = nullptr);
+    ~PuzzleThumbnailer() override;
+
+    void setColors(const QColor& line, const QColor& background);
+    // The cached thumbnail, or a blank placeholder while it is produced. contentHash may be 0 when
+    // unknown. body may be null for a puzzle that is not resident; record is then read on the
+    // pool. thumbnailReady(id) follows once the image is available.
+    [[nodiscard]] QPixmap thumbnail(quint64 id, std::uint64_t contentHash, const SavedPuzzle* body,
+                                    const PuzzleRecordRef& record);
+    void invalidate(quint64 id);
+
+signals:
+    void thumbnailReady(quint64 id);
+    void thumbnailsReset();
+
+private:
+    QString directory_;
+    QThreadPool* pool_ = nullptr;
+    QColor lineColor_{30, 30, 30};
+    QColor backgroundColor_{Qt::white};
+    QPixmap placeholder_;
+    QCache<quint64, QPixmap> cache_;
+    // Ticket of the render in flight per id; a result whose ticket no longer matches is dropped.
+    std::unordered_map<quint64, std::uint64_t> pending_;
+    std::uint64_t ticket_ = 0;
+
+    void finished(quint64 id, std::uint64_t ticket, const QImage& image);
+};
+
+// Renders a kSize x kSize preview; a null image if the puzzle has no body.
+[[nodiscard]] QImage renderPuzzleThumbnail(const SavedPuzzle& puzzle, const QColor& line, const QColor& background);
@@ -0,0 +1,605 @@
+#include "PuzzleVectorExporter.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <utility>
+#include <QFile>
+#include <QMarginsF>
+#include <QPageSize>
+#include <QPaintDevice>
+#include <QPaintEngine>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QTransform>
+
+namespace {
+constexpr qreal kRecordDpi = 96.0;
+constexpr qreal kMaxPdfPagePt = 14400.0;
+constexpr qreal kMergeEpsilon = 1e-6;
+
+qreal fontPixelSize(const QFont& font) {
+    if (font.pixelSize() > 0) {
+        return font.pixelSize();
+    }
+    return font.pointSizeF() * kRecordDpi / 72.0;
+}
+
+qreal transformScale(const QTransform& transform) {
+    return std::sqrt(std::abs(transform.determinant()));
+}
+
+VectorStrokeGroup& strokeGroup(VectorDocument& doc, const QColor& color, const qreal width) {
+    for (auto& group : doc.strokes) {
+        if (group.color == color && std::abs(group.width - width) < kMergeEpsilon) {
+            return group;
+        }
+    }
+    doc.strokes.push_back(VectorStrokeGroup{color, width, {}, {}});
+    return doc.strokes.back();
+}
+
+VectorFillGroup& fillGroup(VectorDocument& doc, const QColor& color) {
+    for (auto& group : doc.fills) {
+        if (group.color == color) {
+            return group;
+        }
+    }
+    doc.fills.push_back(VectorFillGroup{color, {}, {}});
+    return doc.fills.back();
+}
+
+class RecordingEngine final : public QPaintEngine {
+public:
+    explicit RecordingEngine(VectorDocument& doc)
+        : QPaintEngine(QPaintEngine::AllFeatures), doc_(doc) {}
+
+    using QPaintEngine::drawLines;
+    using QPaintEngine::drawPolygon;
+    using QPaintEngine::drawRects;
+
+    bool begin(QPaintDevice*) override { return true; }
+    bool end() override { return true; }
+    Type type() const override { return QPaintEngine::User; }
+
+    void updateState(const QPaintEngineState& state) override {
+        const QPaintEngine::DirtyFlags flags = state.state();
+        if (flags & DirtyPen) pen_ = state.pen();
+        if (flags & DirtyBrush) brush_ = state.brush();
+        if (flags & DirtyTransform) transform_ = state.transform();
+    }
+
+    void drawLines(const QLineF* lines, const int lineCount) override {
+        if (pen_.style() == Qt::NoPen) return;
+        auto& group = strokeGroup(doc_, pen_.color(), penWidth());
+        for (int i = 0; i < lineCount; ++i) {
+            group.lines.push_back(transform_.map(lines[i]));
+        }
+    }
+
+    void drawRects(const QRectF* rects, const int rectCount) override {
+        for (int i = 0; i < rectCount; ++i) {
+            const QRectF rect = transform_.mapRect(rects[i]);
+            if (brush_.style() != Qt::NoBrush && brush_.color() != doc_.background) {
+                fillGroup(doc_, brush_.color()).rects.push_back(rect);
+            }
+            if (pen_.style() != Qt::NoPen) {
+                auto& group = strokeGroup(doc_, pen_.color(), penWidth());
+                group.lines.emplace_back(rect.topLeft(), rect.topRight());
+                group.lines.emplace_back(rect.bottomLeft(), rect.bottomRight());
+                group.lines.emplace_back(rect.topLeft(), rect.bottomLeft());
+                group.lines.emplace_back(rect.topRight(), rect.bottomRight());
+            }
+        }
+    }
+
+    void drawPath(const QPainterPath& path) override {
+        const QPainterPath mapped = transform_.map(path);
+        if (brush_.style() != Qt::NoBrush) {
+            fillGroup(doc_, brush_.color()).paths.push_back(mapped);
+        }
+        if (pen_.style() != Qt::NoPen) {
+            strokeGroup(doc_, pen_.color(), penWidth()).paths.push_back(mapped);
+        }
+    }
+
+    void drawPolygon(const QPointF* points, const int pointCount, const PolygonDrawMode mode) override {
+        if (pointCount <= 0) return;
+        QPainterPath path(points[0]);
+        for (int i = 1; i < pointCount; ++i) {
+            path.lineTo(points[i]);
+        }
+        if (mode == PolylineMode) {
+            if (pen_.style() != Qt::NoPen) {
+                strokeGroup(doc_, pen_.color(), penWidth()).paths.push_back(transform_.map(path));
+            }
+            return;
+        }
+        path.closeSubpath();
+        path.setFillRule(mode == WindingMode ? Qt::WindingFill : Qt::OddEvenFill);
+        drawPath(path);
+    }
+
+    void drawTextItem(const QPointF& p, const QTextItem& item) override {
+        const QString text = item.text();
+        if (text.isEmpty()) return;
+        VectorTextRun run;
+        run.font = item.font();
+        run.pixelSize = fontPixelSize(run.font) * transformScale(transform_);
+        run.color = pen_.color();
+        run.baseline = transform_.map(p);
+        run.text = text;
+        doc_.texts.push_back(std::move(run));
+    }
+
+    void drawPixmap(const QRectF&, const QPixmap&, const QRectF&) override {}
+
+private:
+    VectorDocument& doc_;
+    QPen pen_;
+    QBrush brush_;
+    QTransform transform_;
+
+    qreal penWidth() const {
+        const qreal width = pen_.widthF();
+        return width <= 0.0 ? 1.0 : width * transformScale(transform_);
+    }
+};
+
+class RecordingDevice final : public QPaintDevice {
+public:
+    RecordingDevice(const QSize& size, VectorDocument& doc) : size_(size), engine_(doc) {}
+
+    QPaintEngine* paintEngine() const override { return &engine_; }
+
+protected:
+    int metric(const PaintDeviceMetric which) const override {
+        switch (which) {
+            case PdmWidth: return size_.width();
+            case PdmHeight: return size_.height();
+            case PdmWidthMM: return qRound(size_.width() * 25.4 / kRecordDpi);
+            case PdmHeightMM: return qRound(size_.height() * 25.4 / kRecordDpi);
+            case PdmDpiX:
+            case PdmDpiY:
+            case PdmPhysicalDpiX:
+            case PdmPhysicalDpiY: return static_cast<int>(kRecordDpi);
+            case PdmNumColors: return std::numeric_limits<int>::max();
+            case PdmDepth: return 32;
+            default: return QPaintDevice::metric(which);
+        }
+    }
+
+private:
+    QSize size_;
+    mutable RecordingEngine engine_;
+};
+
+void mergeLines(std::vector<QLineF>& lines) {
+    std::vector<QLineF> horizontal;
+    std::vector<QLineF> vertical;
+    std::vector<QLineF> other;
+    for (QLineF line : lines) {
+        if (std::abs(line.y1() - line.y2()) < kMergeEpsilon) {
+            if (line.x1() > line.x2()) line = QLineF(line.p2(), line.p1());
+            if (line.x2() - line.x1() > kMergeEpsilon) horizontal.push_back(line);
+        } else if (std::abs(line.x1() - line.x2()) < kMergeEpsilon) {
+            if (line.y1() > line.y2()) line = QLineF(line.p2(), line.p1());
+            vertical.push_back(line);
+        } else {
+            other.push_back(line);
+        }
+    }
+
+    auto mergeAxis = [](std::vector<QLineF>& segments, auto across, auto along, auto make) {
+        std::sort(segments.begin(), segments.end(), [&](const QLineF& a, const QLineF& b) {
+            if (across(a) != across(b)) return across(a) < across(b);
+            return along(a).first < along(b).first;
+        });
+        std::vector<QLineF> merged;
+        for (const auto& segment : segments) {
+            if (!merged.empty()) {
+                QLineF& last = merged.back();
+                if (std::abs(across(last) - across(segment)) < kMergeEpsilon
+                    && along(segment).first <= along(last).second + kMergeEpsilon) {
+                    last = make(across(last), along(last).first, std::max(along(last).second, along(segment).second));
+                    continue;
+                }
+            }
+            merged.push_back(segment);
+        }
+        segments = std::move(merged);
+    };
+
+    mergeAxis(horizontal,
+              [](const QLineF& l) { return l.y1(); },
+              [](const QLineF& l) { return std::pair<qreal, qreal>{l.x1(), l.x2()}; },
+              [](qreal y, qreal x1, qreal x2) { return QLineF(x1, y, x2, y); });
+    mergeAxis(vertical,
+              [](const QLineF& l) { return l.x1(); },
+              [](const QLineF& l) { return std::pair<qreal, qreal>{l.y1(), l.y2()}; },
+              [](qreal x, qreal y1, qreal y2) { return QLineF(x, y1, x, y2); });
+
+    lines = std::move(horizontal);
+    lines.insert(lines.end(), vertical.begin(), vertical.end());
+    lines.insert(lines.end(), other.begin(), other.end());
+}
+
+void mergeRects(std::vector<QRectF>& rects) {
+    std::sort(rects.begin(), rects.end(), [](const QRectF& a, const QRectF& b) {
+        if (a.y() != b.y()) return a.y() < b.y();
+        if (a.height() != b.height()) return a.height() < b.height();
+        return a.x() < b.x();
+    });
+    std::vector<QRectF> merged;
+    for (const auto& rect : rects) {
+        if (!merged.empty()) {
+            QRectF& last = merged.back();
+            if (std::abs(last.y() - rect.y()) < kMergeEpsilon
+                && std::abs(last.height() - rect.height()) < kMergeEpsilon
+                && rect.left() <= last.right() + kMergeEpsilon) {
+                last.setRight(std::max(last.right(), rect.right()));
+                continue;
+            }
+        }
+        merged.push_back(rect);
+    }
+    rects = std::move(merged);
+}
+
+void appendNumber(std::string& out, qreal value) {
+    value = std::round(value * 1000.0) / 1000.0 + 0.0;
+    char buffer[32];
+    const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+void appendPair(std::string& out, const char command, const qreal a, const qreal b) {
+    out.push_back(command);
+    appendNumber(out, a);
+    out.push_back(' ');
+    appendNumber(out, b);
+}
+
+qreal rounded(const qreal value) {
+    return std::round(value * 1000.0) / 1000.0;
+}
+
+// Runs sorted along an axis mostly start near where the previous one ended, so relative moves
+// keep the numbers short. The pen position is tracked in rounded units to avoid drift.
+std::string linePathData(const std::vector<QLineF>& lines) {
+    std::string d;
+    d.reserve(lines.size() * 8);
+    QPointF pen(rounded(lines.front().x1()), rounded(lines.front().y1()));
+    appendPair(d, 'M', pen.x(), pen.y());
+    for (const auto& line : lines) {
+        const qreal sx = rounded(line.x1()) - pen.x();
+        const qreal sy = rounded(line.y1()) - pen.y();
+        if (std::abs(sx) > kMergeEpsilon || std::abs(sy) > kMergeEpsilon) {
+            appendPair(d, 'm', sx, sy);
+            pen += QPointF(sx, sy);
+        }
+        const qreal dx = rounded(line.x2()) - pen.x();
+        const qreal dy = rounded(line.y2()) - pen.y();
+        if (std::abs(dy) < kMergeEpsilon) {
+            d.push_back('h');
+            appendNumber(d, dx);
+        } else if (std::abs(dx) < kMergeEpsilon) {
+            d.push_back('v');
+            appendNumber(d, dy);
+        } else {
+            appendPair(d, 'l', dx, dy);
+        }
+        pen += QPointF(dx, dy);
+    }
+    return d;
+}
+
+std::string painterPathData(const QPainterPath& path) {
+    std::string d;
+    for (int i = 0; i < path.elementCount(); ++i) {
+        const auto element = path.elementAt(i);
+        switch (element.type) {
+            case QPainterPath::MoveToElement:
+                appendPair(d, 'M', element.x, element.y);
+                break;
+            case QPainterPath::LineToElement:
+                appendPair(d, 'L', element.x, element.y);
+                break;
+            case QPainterPath::CurveToElement:
+                appendPair(d, 'C', element.x, element.y);
+                for (int k = 1; k <= 2 && i + 1 < path.elementCount(); ++k) {
+                    const auto data = path.elementAt(++i);
+                    d.push_back(' ');
+                    appendNumber(d, data.x);
+                    d.push_back(' ');
+                    appendNumber(d, data.y);
+                }
+                break;
+            case QPainterPath::CurveToDataElement:
+                break;
+        }
+    }
+    return d;
+}
+
+std::string rectPathData(const std::vector<QRectF>& rects) {
+    std::string d;
+    d.reserve(rects.size() * 24);
+    for (const auto& rect : rects) {
+        appendPair(d, 'M', rect.x(), rect.y());
+        d.push_back('h');
+        appendNumber(d, rect.width());
+        d.push_back('v');
+        appendNumber(d, rect.height());
+        d.push_back('h');
+        appendNumber(d, -rect.width());
+        d.push_back('z');
+    }
+    return d;
+}
+
+std::string escapeXml(const QString& text) {
+    std::string out;
+    for (const char ch : text.toUtf8().toStdString()) {
+        switch (ch) {
+            case '&': out += "&amp;"; break;
+            case '<': out += "&lt;"; break;
+            case '>': out += "&gt;"; break;
+            case '"': out += "&quot;"; break;
+            default: out.push_back(ch); break;
+        }
+    }
+    return out;
+}
+
+std::string colorName(const QColor& color) {
+    return color.name().toStdString();
+}
+
+bool sameTextStyle(const VectorTextRun& a, const VectorTextRun& b) {
+    return a.color == b.color && a.font.family() == b.font.family() && a.font.bold() == b.font.bold()
+        && a.font.italic() == b.font.italic() && std::abs(a.pixelSize - b.pixelSize) < kMergeEpsilon;
+}
+
+bool isSingleGlyph(const VectorTextRun& run) {
+    return run.text.size() == 1 && !run.text.front().isSurrogate();
+}
+
+// Single-glyph runs sharing a style and baseline (grid letters and digits) collapse into one
+// <text> element with a per-glyph x list.
+void appendTextRuns(std::string& out, const std::vector<VectorTextRun>& texts) {
+    std::vector<const VectorTextRun*> pending;
+    for (const auto& run : texts) pending.push_back(&run);
+
+    while (!pending.empty()) {
+        const VectorTextRun& style = *pending.front();
+        std::vector<const VectorTextRun*> group;
+        std::vector<const VectorTextRun*> rest;
+        for (const auto* run : pending) {
+            (sameTextStyle(style, *run) ? group : rest).push_back(run);
+        }
+        pending = std::move(rest);
+        std::stable_sort(group.begin(), group.end(), [](const VectorTextRun* a, const VectorTextRun* b) {
+            if (a->baseline.y() != b->baseline.y()) return a->baseline.y() < b->baseline.y();
+            return a->baseline.x() < b->baseline.x();
+        });
+
+        out += "<g font-family=\"" + escapeXml(style.font.family()) + "\" font-size=\"";
+        appendNumber(out, style.pixelSize);
+        out += "\" fill=\"" + colorName(style.color) + "\"";
+        if (style.font.bold()) out += " font-weight=\"bold\"";
+        if (style.font.italic()) out += " font-style=\"italic\"";
+        out += ">\n";
+
+        std::size_t i = 0;
+        while (i < group.size()) {
+            const VectorTextRun& run = *group[i];
+            std::size_t end = i + 1;
+            if (isSingleGlyph(run)) {
+                while (end < group.size() && isSingleGlyph(*group[end])
+                       && std::abs(group[end]->baseline.y() - run.baseline.y()) < kMergeEpsilon) {
+                    ++end;
+                }
+            }
+            out += "<text x=\"";
+            QString text;
+            for (std::size_t k = i; k < end; ++k) {
+                if (k > i) out.push_back(' ');
+                appendNumber(out, group[k]->baseline.x());
+                text += group[k]->text;
+            }
+            out += "\" y=\"";
+            appendNumber(out, run.baseline.y());
+            out += "\" xml:space=\"preserve\">" + escapeXml(text) + "</text>\n";
+            i = end;
+        }
+        out += "</g>\n";
+    }
+}
+
+std::pair<int, int> doorEdge(const MazeWalls& walls, const std::pair<int, int>& cell) {
+    const auto [row, col] = cell;
+    if (row < 0 || col < 0 || row >= walls.rows || col >= walls.cols) return {-1, -1};
+    if (row == 0) return {0, col};
+    if (row == walls.rows - 1) return {1, col};
+    if (col == 0) return {2, row};
+    if (col == walls.cols - 1) return {3, row};
+    return {-1, -1};
+}
+}
+
+VectorDocument recordVectorDocument(const QSize& size,
+                                    const QColor& background,
+                                    const std::function<void(QPainter&)>& paint) {
+    VectorDocument doc;
+    doc.viewBox = QRectF(QPointF(0, 0), QSizeF(size));
+    doc.background = background;
+    {
+        RecordingDevice device(size, doc);
+        QPainter painter(&device);
+        paint(painter);
+    }
+    for (auto& group : doc.strokes) {
+        mergeLines(group.lines);
+    }
+    for (auto& group : doc.fills) {
+        mergeRects(group.rects);
+    }
+    return doc;
+}
+
+VectorDocument makeMazeVectorDocument(const MazeWalls& walls, const MazeRasterStyle& style) {
+    VectorDocument doc;
+    const int cell = std::max(1, style.cellPx);
+    const qreal lineWidth = static_cast<qreal>(std::max(2, cell / 8)) / cell;
+    doc.unitScale = cell;
+    doc.viewBox = QRectF(-lineWidth, -lineWidth, walls.cols + lineWidth * 2, walls.rows + lineWidth * 2);
+    doc.background = QColor(static_cast<QRgb>(style.backgroundRgb));
+
+    const std::pair<int, int> doors[] = {doorEdge(walls, style.entranceCell), doorEdge(walls, style.exitCell)};
+    auto isDoor = [&doors](const int side, const int index) {
+        return std::any_of(std::begin(doors), std::end(doors), [&](const auto& door) {
+            return door.first == side && door.second == index;
+        });
+    };
+
+    VectorStrokeGroup group{QColor(static_cast<QRgb>(style.wallRgb)), lineWidth, {}, {}};
+    auto emitRuns = [&group](const int count, auto closed, auto makeLine) {
+        int i = 0;
+        while (i < count) {
+            if (!closed(i)) {
+                ++i;
+                continue;
+            }
+            const int start = i;
+            while (i < count && closed(i)) ++i;
+            group.lines.push_back(makeLine(start, i));
+        }
+    };
+
+    for (int k = 0; k <= walls.rows; ++k) {
+        emitRuns(walls.cols,
+                 [&](const int c) {
+                     if (k == 0) return !isDoor(0, c);
+                     return walls.southClosed(k - 1, c) && !(k == walls.rows && isDoor(1, c));
+                 },
+                 [k](const int from, const int to) { return QLineF(from, k, to, k); });
+    }
+    for (int k = 0; k <= walls.cols; ++k) {
+        emitRuns(walls.rows,
+                 [&](const int r) {
+                     if (k == 0) return !isDoor(2, r);
+                     return walls.eastClosed(r, k - 1) && !(k == walls.cols && isDoor(3, r));
+                 },
+                 [k](const int from, const int to) { return QLineF(k, from, k, to); });
+    }
+    doc.strokes.push_back(std::move(group));
+    return doc;
+}
+
+bool writeVectorSvg(const VectorDocument& doc, const QString& path) {
+    const QRectF& box = doc.viewBox;
+    std::string out;
+    out += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"";
+    appendNumber(out, box.width() * doc.unitScale);
+    out += "\" height=\"";
+    appendNumber(out, box.height() * doc.unitScale);
+    out += "\" viewBox=\"";
+    appendNumber(out, box.x());
+    out.push_back(' ');
+    appendNumber(out, box.y());
+    out.push_back(' ');
+    appendNumber(out, box.width());
+    out.push_back(' ');
+    appendNumber(out, box.height());
+    out += "\">\n<rect x=\"";
+    appendNumber(out, box.x());
+    out += "\" y=\"";
+    appendNumber(out, box.y());
+    out += "\" width=\"100%\" height=\"100%\" fill=\"" + colorName(doc.background) + "\"/>\n";
+
+    for (const auto& group : doc.fills) {
+        if (!group.rects.empty()) {
+            out += "<path fill=\"" + colorName(group.color) + "\" d=\"" + rectPathData(group.rects) + "\"/>\n";
+        }
+        for (const auto& fillPath : group.paths) {
+            out += "<path fill=\"" + colorName(group.color) + "\" d=\"" + painterPathData(fillPath) + "\"/>\n";
+        }
+    }
+    for (const auto& group : doc.strokes) {
+        std::string attributes = "fill=\"none\" stroke=\"" + colorName(group.color) + "\" stroke-width=\"";
+        appendNumber(attributes, group.width);
+        attributes += "\" stroke-linecap=\"square\"";
+        if (!group.lines.empty()) {
+            out += "<path " + attributes + " d=\"";
+            out += linePathData(group.lines);
+            out += "\"/>\n";
+        }
+        for (const auto& strokePath : group.paths) {
+            out += "<path " + attributes + " d=\"" + painterPathData(strokePath) + "\"/>\n";
+        }
+    }
+    appendTextRuns(out, doc.texts);
+    out += "</svg>\n";
+
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return file.write(out.data(), static_cast<qint64>(out.size())) == static_cast<qint64>(out.size());
+}
+
+bool writeVectorPdf(const VectorDocument& doc, const QString& path) {
+    const QRectF& box = doc.viewBox;
+    if (box.isEmpty()) {
+        return false;
+    }
+    QSizeF pagePt = box.size() * doc.unitScale * 72.0 / kRecordDpi;
+    const qreal fit = std::min<qreal>(1.0, kMaxPdfPagePt / std::max(pagePt.width(), pagePt.height()));
+    pagePt *= fit;
+
+    QPdfWriter writer(path);
+    writer.setCreator("Puzzles");
+    writer.setPageSize(QPageSize(pagePt, QPageSize::Point, QString(), QPageSize::ExactMatch));
+    writer.setPageMargins(QMarginsF(0, 0, 0, 0));
+
+    QPainter painter;
+    if (!painter.begin(&writer)) {
+        return false;
+    }
+    painter.setRenderHint(QPainter::Antialiasing, true);
+    painter.setRenderHint(QPainter::TextAntialiasing, true);
+    const qreal scale = static_cast<qreal>(writer.width()) / box.width();
+    painter.scale(scale, scale);
+    painter.translate(-box.topLeft());
+    painter.fillRect(box, doc.background);
+
+    for (const auto& group : doc.fills) {
+        QPainterPath fillPath;
+        for (const auto& rect : group.rects) fillPath.addRect(rect);
+        for (const auto& extra : group.paths) fillPath.addPath(extra);
+        painter.fillPath(fillPath, group.color);
+    }
+    for (const auto& group : doc.strokes) {
+        const QPen pen(group.color, group.width, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin);
+        QPainterPath strokePath;
+        for (const auto& line : group.lines) {
+            if (strokePath.elementCount() == 0 || strokePath.currentPosition() != line.p1()) {
+                strokePath.moveTo(line.p1());
+            }
+            strokePath.lineTo(line.p2());
+        }
+        for (const auto& extra : group.paths) strokePath.addPath(extra);
+        painter.strokePath(strokePath, pen);
+    }
+    for (const auto& run : doc.texts) {
+        QFont font = run.font;
+        font.setPixelSize(std::max(1, qRound(run.pixelSize)));
+        painter.setFont(font);
+        painter.setPen(run.color);
+        painter.drawText(run.baseline, run.text);
+    }
+    return painter.end();
+}
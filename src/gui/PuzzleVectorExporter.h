@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QColor>
+#include <QFont>
+#include <QLineF>
+#include <QPainterPath>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <functional>
+#include <vector>
+
+#include "MazeRasterExporter.h"
+#include "maze_walls.h"
+
+class QPainter;
+
+struct VectorStrokeGroup {
+    QColor color;
+    qreal width = 1.0;
+    std::vector<QLineF> lines;
+    std::vector<QPainterPath> paths;
+};
+
+struct VectorFillGroup {
+    QColor color;
+    std::vector<QRectF> rects;
+    std::vector<QPainterPath> paths;
+};
+
+struct VectorTextRun {
+    QFont font;
+    qreal pixelSize = 12.0;
+    QColor color;
+    QPointF baseline;
+    QString text;
+};
+
+// Layers are emitted fills first, then strokes, then text; the puzzle renderers never rely on
+// anything else.
+struct VectorDocument {
+    QRectF viewBox;
+    qreal unitScale = 1.0;
+    QColor background;
+    std::vector<VectorFillGroup> fills;
+    std::vector<VectorStrokeGroup> strokes;
+    std::vector<VectorTextRun> texts;
+};
+
+[[nodiscard]] VectorDocument recordVectorDocument(const QSize& size,
+                                                  const QColor& background,
+                                                  const std::function<void(QPainter&)>& paint);
+[[nodiscard]] VectorDocument makeMazeVectorDocument(const MazeWalls& walls, const MazeRasterStyle& style);
+
+bool writeVectorSvg(const VectorDocument& doc, const QString& path);
+bool writeVectorPdf(const VectorDocument& doc, const QString& path);
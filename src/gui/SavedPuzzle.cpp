@@ -0,0 +1,91 @@
+#include "SavedPuzzle.h"
+
+#include <cctype>
+#include <type_traits>
+
+std::string savedPuzzleName(const SavedPuzzle& puzzle) {
+    return std::visit([](const auto& body) -> std::string {
+        if constexpr (std::is_same_v<std::decay_t<decltype(body)>, std::monostate>) {
+            return {};
+        } else {
+            return body.name;
+        }
+    }, puzzle.body);
+}
+
+bool savedPuzzleHasBody(const SavedPuzzle& puzzle) {
+    return !std::holds_alternative<std::monostate>(puzzle.body);
+}
+
+namespace {
+template <typename T>
+std::size_t gridFootprint(const std::vector<std::vector<T>>& grid) {
+    std::size_t bytes = grid.size() * sizeof(std::vector<T>);
+    for (const auto& row : grid) {
+        bytes += row.size() * sizeof(T);
+    }
+    return bytes;
+}
+
+std::string sizeTerm(const std::size_t width, const std::size_t height) {
+    return std::to_string(width) + "x" + std::to_string(height);
+}
+
+std::string lowerCase(std::string text) {
+    for (char& ch : text) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return text;
+}
+
+std::size_t stringsFootprint(const std::vector<std::string>& strings) {
+    std::size_t bytes = strings.size() * sizeof(std::string);
+    for (const auto& s : strings) {
+        bytes += s.size();
+    }
+    return bytes;
+}
+}
+
+std::vector<std::string> savedPuzzleSearchTerms(const SavedPuzzle& puzzle) {
+    std::vector<std::string> terms;
+    if (const auto* maze = puzzle.maze()) {
+        terms.push_back(sizeTerm(static_cast<std::size_t>(maze->width), static_cast<std::size_t>(maze->height)));
+    } else if (const auto* crossword = puzzle.crossword()) {
+        const auto& grid = crossword->puzzle.grid;
+        terms.push_back(sizeTerm(grid.empty() ? 0 : grid.front().size(), grid.size()));
+        for (const auto* entries : {&crossword->puzzle.across, &crossword->puzzle.down}) {
+            for (const auto& entry : *entries) {
+                terms.push_back(lowerCase(entry.word));
+            }
+        }
+    } else if (const auto* wordSearch = puzzle.wordSearch()) {
+        terms.push_back(sizeTerm(wordSearch->puzzle.grid.size(), wordSearch->puzzle.grid.size()));
+        for (const auto& word : wordSearch->puzzle.words) {
+            terms.push_back(lowerCase(word));
+        }
+    } else if (const auto* sudoku = puzzle.sudoku()) {
+        terms.push_back(sizeTerm(sudoku->puzzle.grid.size(), sudoku->puzzle.grid.size()));
+    }
+    return terms;
+}
+
+std::size_t savedPuzzleFootprint(const SavedPuzzle& puzzle) {
+    std::size_t bytes = sizeof(SavedPuzzle);
+    if (const auto* maze = puzzle.maze()) {
+        bytes += maze->graph.nodes.size() * sizeof(MazeNode) + maze->graph.edges.size() * sizeof(MazeEdge);
+    } else if (const auto* crossword = puzzle.crossword()) {
+        bytes += stringsFootprint(crossword->puzzle.grid) + gridFootprint(crossword->puzzle.numbers)
+            + (crossword->puzzle.across.size() + crossword->puzzle.down.size()) * sizeof(CrosswordEntry);
+        for (const auto& [word, hint] : crossword->hints) {
+            bytes += word.size() + hint.size() + 2 * sizeof(std::string);
+        }
+    } else if (const auto* wordSearch = puzzle.wordSearch()) {
+        bytes += gridFootprint(wordSearch->puzzle.grid) + stringsFootprint(wordSearch->puzzle.words);
+    } else if (const auto* sudoku = puzzle.sudoku()) {
+        bytes += gridFootprint(sudoku->puzzle.grid) + gridFootprint(sudoku->puzzle.solution);
+    } else if (const auto* cryptogram = puzzle.cryptogram()) {
+        bytes += cryptogram->puzzle.plainText.size() + cryptogram->puzzle.cipherText.size();
+    }
+    return bytes;
+}
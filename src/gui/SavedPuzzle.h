@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "MazeGame.h"
+#include "CrosswordGenerator.h"
+#include "WordSearchGenerator.h"
+#include "SudokuGenerator.h"
+#include "CryptogramGenerator.h"
+
+struct SavedMaze {
+    std::string name;
+    GenerationAlgorithm algorithm;
+    int width = 0;
+    int height = 0;
+    MazeGraph graph;
+    int entranceNode = -1;
+    int exitNode = -1;
+    int playerNode = -1;
+};
+
+struct SavedCrossword {
+    std::string name;
+    CrosswordPuzzle puzzle;
+    std::unordered_map<std::string, std::string> hints;
+};
+
+struct SavedWordSearch {
+    std::string name;
+    WordSearchPuzzle puzzle;
+};
+
+struct SavedSudoku {
+    std::string name;
+    SudokuPuzzle puzzle;
+    int difficulty = 0;
+};
+
+struct SavedCryptogram {
+    std::string name;
+    CryptogramPuzzle puzzle;
+    bool avoidSelfMapping = true;
+    int hintCount = 0;
+};
+
+// Exactly one body is held per puzzle. A puzzle restored lazily keeps its type with an empty
+// (monostate) body until it is loaded.
+struct SavedPuzzle {
+    enum class Type { Maze, Crossword, WordSearch, Sudoku, Cryptogram };
+    using Body = std::variant<std::monostate, SavedMaze, SavedCrossword, SavedWordSearch, SavedSudoku, SavedCryptogram>;
+
+    Type type = Type::Maze;
+    Body body;
+
+    SavedPuzzle() = default;
+    explicit SavedPuzzle(const Type stubType) : type(stubType) {}
+    explicit SavedPuzzle(SavedMaze maze) : type(Type::Maze), body(std::move(maze)) {}
+    explicit SavedPuzzle(SavedCrossword crossword) : type(Type::Crossword), body(std::move(crossword)) {}
+    explicit SavedPuzzle(SavedWordSearch wordSearch) : type(Type::WordSearch), body(std::move(wordSearch)) {}
+    explicit SavedPuzzle(SavedSudoku sudoku) : type(Type::Sudoku), body(std::move(sudoku)) {}
+    explicit SavedPuzzle(SavedCryptogram cryptogram) : type(Type::Cryptogram), body(std::move(cryptogram)) {}
+
+    [[nodiscard]] SavedMaze* maze() { return std::get_if<SavedMaze>(&body); }
+    [[nodiscard]] const SavedMaze* maze() const { return std::get_if<SavedMaze>(&body); }
+    [[nodiscard]] SavedCrossword* crossword() { return std::get_if<SavedCrossword>(&body); }
+    [[nodiscard]] const SavedCrossword* crossword() const { return std::get_if<SavedCrossword>(&body); }
+    [[nodiscard]] SavedWordSearch* wordSearch() { return std::get_if<SavedWordSearch>(&body); }
+    [[nodiscard]] const SavedWordSearch* wordSearch() const { return std::get_if<SavedWordSearch>(&body); }
+    [[nodiscard]] SavedSudoku* sudoku() { return std::get_if<SavedSudoku>(&body); }
+    [[nodiscard]] const SavedSudoku* sudoku() const { return std::get_if<SavedSudoku>(&body); }
+    [[nodiscard]] SavedCryptogram* cryptogram() { return std::get_if<SavedCryptogram>(&body); }
+    [[nodiscard]] const SavedCryptogram* cryptogram() const { return std::get_if<SavedCryptogram>(&body); }
+};
+
+[[nodiscard]] std::string savedPuzzleName(const SavedPuzzle& puzzle);
+[[nodiscard]] bool savedPuzzleHasBody(const SavedPuzzle& puzzle);
+// Lower-case search words taken from the body: the grid size plus the crossword or word search
+// words. The name and type are indexed separately.
+[[nodiscard]] std::vector<std::string> savedPuzzleSearchTerms(const SavedPuzzle& puzzle);
+// Approximate heap bytes held by the puzzle body.
+[[nodiscard]] std::size_t savedPuzzleFootprint(const SavedPuzzle& puzzle);
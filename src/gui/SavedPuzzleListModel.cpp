@@ -0,0 +1,165 @@
+#include "SavedPuzzleListModel.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "PuzzleLibrary.h"
+#include "PuzzleThumbnailer.h"
+
+SavedPuzzleListModel::SavedPuzzleListModel(PuzzleLibrary& library, PuzzleThumbnailer* thumbnailer, QObject* parent)
+    : QAbstractListModel(parent), library_(library), thumbnailer_(thumbnailer) {
+    connect(&library_, &PuzzleLibrary::puzzleAdded, this, &SavedPuzzleListModel::puzzleAdded);
+    connect(&library_, &PuzzleLibrary::puzzlesAdded, this, &SavedPuzzleListModel::puzzlesAdded);
+    connect(&library_, &PuzzleLibrary::puzzleRemoved, this, &SavedPuzzleListModel::puzzleRemoved);
+    connect(&library_, &PuzzleLibrary::puzzleChanged, this, &SavedPuzzleListModel::puzzleChanged);
+    connect(&library_, &PuzzleLibrary::libraryReset, this, [this]() {
+        beginResetModel();
+        rebuild();
+        endResetModel();
+    });
+    if (thumbnailer_) {
+        connect(thumbnailer_, &PuzzleThumbnailer::thumbnailReady, this, &SavedPuzzleListModel::thumbnailReady);
+        connect(thumbnailer_, &PuzzleThumbnailer::thumbnailsReset, this, [this]() {
+            if (!rows_.empty()) {
+                emit dataChanged(index(0), index(rowCount() - 1), {Qt::DecorationRole});
+            }
+        });
+    }
+    rebuild();
+}
+
+int SavedPuzzleListModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows_.size());
+}
+
+QVariant SavedPuzzleListModel::data(const QModelIndex& index, const int role) const {
+    const int row = libraryRow(index.row());
+    if (!index.isValid() || !library_.contains(row)) {
+        return {};
+    }
+    if (role == Qt::DisplayRole) {
+        return QString::fromStdString(library_.nameAt(row));
+    }
+    if (role == Qt::DecorationRole && thumbnailer_) {
+        return thumbnailer_->thumbnail(library_.idAt(row), library_.contentHashAt(row), library_.residentPuzzleAt(row),
+                                       library_.recordAt(row));
+    }
+    return {};
+}
+
+void SavedPuzzleListModel::setFilter(const QString& filter) {
+    std::string trimmed = filter.trimmed().toStdString();
+    if (trimmed == filter_) {
+        return;
+    }
+    beginResetModel();
+    filter_ = std::move(trimmed);
+    rebuild();
+    endResetModel();
+}
+
+int SavedPuzzleListModel::libraryRow(const int viewRow) const {
+    if (viewRow < 0 || viewRow >= static_cast<int>(rows_.size())) {
+        return -1;
+    }
+    return rows_[static_cast<std::size_t>(viewRow)];
+}
+
+int SavedPuzzleListModel::viewRow(const int libraryRow) const {
+    const auto it = std::lower_bound(rows_.begin(), rows_.end(), libraryRow);
+    if (it == rows_.end() || *it != libraryRow) {
+        return -1;
+    }
+    return static_cast<int>(it - rows_.begin());
+}
+
+void SavedPuzzleListModel::rebuild() {
+    if (isFiltered()) {
+        rows_ = library_.search(filter_);
+    } else {
+        rows_.resize(static_cast<std::size_t>(library_.count()));
+        std::iota(rows_.begin(), rows_.end(), 0);
+    }
+}
+
+// The library signals after the change, so the mapping is shifted first and the view told second.
+void SavedPuzzleListModel::puzzleAdded(const int row) {
+    auto it = std::lower_bound(rows_.begin(), rows_.end(), row);
+    for (auto shifted = it; shifted != rows_.end(); ++shifted) {
+        ++*shifted;
+    }
+    if (isFiltered() && !library_.matches(row, filter_)) {
+        return;
+    }
+    const int at = static_cast<int>(it - rows_.begin());
+    beginInsertRows(QModelIndex(), at, at);
+    rows_.insert(it, row);
+    endInsertRows();
+}
+
+void SavedPuzzleListModel::puzzlesAdded(const int first, const int last) {
+    const int added = last - first + 1;
+    auto it = std::lower_bound(rows_.begin(), rows_.end(), first);
+    for (auto shifted = it; shifted != rows_.end(); ++shifted) {
+        *shifted += added;
+    }
+    std::vector<int> shown;
+    for (int row = first; row <= last; ++row) {
+        if (!isFiltered() || library_.matches(row, filter_)) {
+            shown.push_back(row);
+        }
+    }
+    if (shown.empty()) {
+        return;
+    }
+    const int at = static_cast<int>(it - rows_.begin());
+    beginInsertRows(QModelIndex(), at, at + static_cast<int>(shown.size()) - 1);
+    rows_.insert(it, shown.begin(), shown.end());
+    endInsertRows();
+}
+
+void SavedPuzzleListModel::puzzleRemoved(const int row) {
+    auto it = std::lower_bound(rows_.begin(), rows_.end(), row);
+    const bool shown = it != rows_.end() && *it == row;
+    const int at = static_cast<int>(it - rows_.begin());
+    if (shown) {
+        beginRemoveRows(QModelIndex(), at, at);
+        it = rows_.erase(it);
+    }
+    for (auto shifted = it; shifted != rows_.end(); ++shifted) {
+        --*shifted;
+    }
+    if (shown) {
+        endRemoveRows();
+    }
+}
+
+void SavedPuzzleListModel::puzzleChanged(const int row) {
+    if (thumbnailer_) {
+        thumbnailer_->invalidate(library_.idAt(row));
+    }
+    const int at = viewRow(row);
+    const bool shown = at >= 0;
+    const bool wanted = !isFiltered() || library_.matches(row, filter_);
+    if (shown && wanted) {
+        const QModelIndex changed = index(at);
+        emit dataChanged(changed, changed, {Qt::DisplayRole, Qt::DecorationRole});
+    } else if (shown) {
+        beginRemoveRows(QModelIndex(), at, at);
+        rows_.erase(rows_.begin() + at);
+        endRemoveRows();
+    } else if (wanted) {
+        const auto it = std::lower_bound(rows_.begin(), rows_.end(), row);
+        const int insertAt = static_cast<int>(it - rows_.begin());
+        beginInsertRows(QModelIndex(), insertAt, insertAt);
+        rows_.insert(it, row);
+        endInsertRows();
+    }
+}
+
+void SavedPuzzleListModel::thumbnailReady(const quint64 id) {
+    if (const int at = viewRow(library_.rowOf(id)); at >= 0) {
+        const QModelIndex changed = index(at);
+        emit dataChanged(changed, changed, {Qt::DecorationRole});
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QString>
+#include <string>
+#include <vector>
+
+class PuzzleLibrary;
+class PuzzleThumbnailer;
+
+// List model over PuzzleLibrary for the saved puzzles view. Rows are fetched on demand, so the
+// view only touches the names it paints. With a filter set, only the library rows returned by
+// PuzzleLibrary::search are shown; view rows and library rows are mapped with libraryRow() and
+// viewRow(). With a thumbnailer, rows carry a preview as their decoration.
+class SavedPuzzleListModel : public QAbstractListModel {
+    Q_OBJECT
+public:
+    SavedPuzzleListModel(PuzzleLibrary& library, PuzzleThumbnailer* thumbnailer, QObject* parent = nullptr);
+
+    [[nodiscard]] int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    [[nodiscard]] QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    void setFilter(const QString& filter);
+    [[nodiscard]] bool isFiltered() const { return !filter_.empty(); }
+    [[nodiscard]] int libraryRow(int viewRow) const;
+    // -1 when the library row is hidden by the filter.
+    [[nodiscard]] int viewRow(int libraryRow) const;
+
+private:
+    PuzzleLibrary& library_;
+    PuzzleThumbnailer* thumbnailer_ = nullptr;
+    std::string filter_;
+    // Library rows in view order; kept in ascending order.
+    std::vector<int> rows_;
+
+    void rebuild();
+    void puzzleAdded(int row);
+    void puzzlesAdded(int first, int last);
+    void puzzleRemoved(int row);
+    void puzzleChanged(int row);
+    void thumbnailReady(quint64 id);
+};
@@ -0,0 +1,133 @@
+#include "SudokuBatchGenerator.h"
+
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <unordered_set>
+
+#include "SudokuGrids.h"
+#include "SudokuSolver.h"
+
+namespace {
+constexpr int kProgressIntervalMs = 250;
+}
+
+struct SudokuBatchGenerator::Batch {
+    int target = 0;
+    int tier = 0;
+    std::atomic<bool> stop{false};
+    std::atomic<int> accepted{0};
+    std::atomic<int> generated{0};
+    std::atomic<int> offTier{0};
+    std::atomic<int> duplicates{0};
+    std::mutex mutex;
+    std::unordered_set<std::uint64_t> seen;
+};
+
+SudokuBatchGenerator::SudokuBatchGenerator(QObject* parent) : QObject(parent) {
+    pool_ = new QThreadPool(this);
+    pool_->setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+    progressTimer_ = new QTimer(this);
+    progressTimer_->setInterval(kProgressIntervalMs);
+    connect(progressTimer_, &QTimer::timeout, this, [this]() { emit progress(stats()); });
+}
+
+SudokuBatchGenerator::~SudokuBatchGenerator() {
+    cancel();
+    pool_->waitForDone();
+}
+
+bool SudokuBatchGenerator::start(const int count, const int tier) {
+    if (batch_ || count <= 0) {
+        return false;
+    }
+    batch_ = std::make_shared<Batch>();
+    batch_->target = count;
+    batch_->tier = std::clamp(tier, 0, 2);
+    cancelled_ = false;
+    clock_.start();
+    progressTimer_->start();
+
+    workers_ = pool_->maxThreadCount();
+    std::random_device seeds;
+    QPointer<SudokuBatchGenerator> self(this);
+    for (int i = 0; i < workers_; ++i) {
+        pool_->start([self, batch = batch_, seed = seeds()]() {
+            std::mt19937 rng(seed);
+            const SudokuGeneratorOptions options = sudokuTierOptions(batch->tier);
+            while (!batch->stop) {
+                auto puzzle = generateSudoku(options, rng);
+                if (!puzzle) {
+                    continue;
+                }
+                ++batch->generated;
+                if (sudokuPuzzleTier(*puzzle) != batch->tier) {
+                    ++batch->offTier;
+                    continue;
+                }
+                const std::uint64_t hash = sudokuCanonicalHash(sudokuCellsFromGrid(puzzle->grid));
+                {
+                    std::lock_guard lock(batch->mutex);
+                    if (batch->stop) {
+                        break;
+                    }
+                    if (!batch->seen.insert(hash).second) {
+                        ++batch->duplicates;
+                        continue;
+                    }
+                    if (++batch->accepted >= batch->target) {
+                        batch->stop = true;
+                    }
+                }
+                QMetaObject::invokeMethod(QCoreApplication::instance(), [self, batch, ready = std::move(*puzzle)]() {
+                    if (self && self->batch_ == batch) {
+                        emit self->puzzleReady(ready);
+                    }
+                }, Qt::QueuedConnection);
+            }
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, batch]() {
+                if (self) {
+                    self->workerFinished(batch);
+                }
+            }, Qt::QueuedConnection);
+        });
+    }
+    return true;
+}
+
+void SudokuBatchGenerator::cancel() {
+    if (batch_ && !batch_->stop.exchange(true)) {
+        cancelled_ = true;
+    }
+}
+
+SudokuBatchStats SudokuBatchGenerator::stats() const {
+    SudokuBatchStats stats;
+    if (batch_) {
+        stats.accepted = batch_->accepted;
+        stats.generated = batch_->generated;
+        stats.offTier = batch_->offTier;
+        stats.duplicates = batch_->duplicates;
+        stats.seconds = static_cast<double>(clock_.elapsed()) / 1000.0;
+    }
+    return stats;
+}
+
+void SudokuBatchGenerator::workerFinished(const std::shared_ptr<Batch>& batch) {
+    if (batch != batch_ || --workers_ > 0) {
+        return;
+    }
+    // Workers queue their last puzzles before they report, so every puzzleReady has been
+    // delivered by now.
+    const SudokuBatchStats last = stats();
+    progressTimer_->stop();
+    batch_.reset();
+    emit finished(last, cancelled_);
+}
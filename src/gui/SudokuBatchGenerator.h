@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <memory>
+
+#include "SudokuGenerator.h"
+
+class QThreadPool;
+class QTimer;
+
+struct SudokuBatchStats {
+    int accepted = 0;
+    // Candidates generated and rated, including the ones dropped below.
+    int generated = 0;
+    int offTier = 0;
+    int duplicates = 0;
+    double seconds = 0.0;
+
+    [[nodiscard]] double perSecond() const { return seconds > 0.0 ? accepted / seconds : 0.0; }
+};
+
+// Generates many 9x9 puzzles of one rater tier (see sudokuPuzzleTier) on a private thread pool.
+// Candidates of another tier are dropped, as are puzzles isomorphic to one already produced,
+// found by the hash of their canonical form. Accepted puzzles arrive one by one through
+// puzzleReady() on the GUI thread.
+class SudokuBatchGenerator : public QObject {
+    Q_OBJECT
+public:
+    explicit SudokuBatchGenerator(QObject* parent = nullptr);
+    ~SudokuBatchGenerator() override;
+
+    // False while another batch is still running.
+    bool start(int count, int tier);
+    void cancel();
+    [[nodiscard]] bool isRunning() const { return batch_ != nullptr; }
+    [[nodiscard]] SudokuBatchStats stats() const;
+
+signals:
+    void puzzleReady(const SudokuPuzzle& puzzle);
+    void progress(const SudokuBatchStats& stats);
+    void finished(const SudokuBatchStats& stats, bool cancelled);
+
+private:
+    struct Batch;
+
+    QThreadPool* pool_ = nullptr;
+    QTimer* progressTimer_ = nullptr;
+    QElapsedTimer clock_;
+    std::shared_ptr<Batch> batch_;
+    int workers_ = 0;
+    bool cancelled_ = false;
+
+    void workerFinished(const std::shared_ptr<Batch>& batch);
+};
@@ -2,87 +2,163 @@
 
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
 #include <random>
 
+#include "SudokuGrids.h"
+#include "SudokuRater.h"
+#include "SudokuSolver.h"
 
-bool solveSudoku(std::vector<std::vector<int>>& board) {
-    for (int row = 0; row < 9; ++row) {
-        for (int col = 0; col < 9; ++col) {
-            if (board[row][col] == 0) {
-                std::vector<int> numbers = {1, 2, 3, 4, 5, 6, 7, 8, 9};
-                std::random_device rd;
-                std::mt19937 g(rd());
-                std::shuffle(numbers.begin(), numbers.end(), g);
-                for (int num : numbers) {
-                    bool possible = true;
-                    for (int i = 0; i < 9; ++i) {
-                        if (board[row][i] == num || board[i][col] == num) {
-                            possible = false;
-                            break;
-                        }
-                    }
-                    if (possible) {
-                        int box_row = row / 3;
-                        int box_col = col / 3;
-                        for (int i = 0; i < 3; ++i) {
-                            for (int j = 0; j < 3; ++j) {
-                                if (board[box_row * 3 + i][box_col * 3 + j] == num) {
-                                    possible = false;
-                                    break;
-                                }
-                            }
-                            if (!possible)
-                                break;
-                        }
-                    }
+namespace {
+// The hard tier turns up in roughly one minimal puzzle in twenty, so this bound is rarely reached.
+constexpr int kMaxTierAttempts = 200;
 
-                    if (possible) {
-                        board[row][col] = num;
-                        if (solveSudoku(board)) {
-                            return true;
-                        }
-                        board[row][col] = 0;
-                    }
-                }
-                return false;
+// Share of the cells left as givens per difficulty on boards the rater does not cover.
+constexpr std::array<double, 3> kGivenShare = {0.55, 0.47, 0.40};
+// On 16x16 and 25x25 boards a few uniqueness proofs blow up; past this many guesses the given
+// is kept rather than waiting for the proof.
+constexpr int kLargeBoardGuesses = 64;
+// Removal orders tried on one solution grid before drawing another.
+constexpr int kOrdersPerSolution = 4;
+
+// One pass removing givens from grid in random order while the solution stays unique; returns
+// the givens left.
+template <int Box>
+int removeGivens(const SudokuGeneratorOptions& options, const BasicSudokuCells<Box>& solution,
+                 BasicSudokuCells<Box>& grid, BasicSudokuSolver<Box>& solver, std::mt19937& rng) {
+    constexpr int cells = SudokuGeometry<Box>::kCells;
+    std::vector<int> order(cells);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    int clues = cells;
+    for (const int cell : order) {
+        if (!options.minimal && clues <= options.clues) {
+            break;
+        }
+        const int mirror = cells - 1 - cell;
+        if (grid[cell] == 0 || (options.symmetric && mirror < cell)) {
+            continue;
+        }
+        const bool pair = options.symmetric && mirror != cell;
+        grid[cell] = 0;
+        if (pair) {
+            grid[mirror] = 0;
+        }
+        // Removing givens never loses the known solution, so load() cannot fail here.
+        solver.load(grid);
+        if (solver.countSolutions(2, Box > 3 ? kLargeBoardGuesses : 0) == 1) {
+            clues -= pair ? 2 : 1;
+        } else {
+            grid[cell] = solution[cell];
+            if (pair) {
+                grid[mirror] = solution[mirror];
             }
         }
     }
-    return true;
+    return clues;
 }
 
-std::optional<SudokuPuzzle> generateSudoku(int difficulty) {
+template <int Box>
+std::optional<SudokuPuzzle> generateWithBox(const SudokuGeneratorOptions& options, std::mt19937& rng) {
+    const auto deadline = std::chrono::steady_clock::now() + options.budget;
+    BasicSudokuSolver<Box> solver;
+    BasicSudokuCells<Box> solution{};
+    BasicSudokuCells<Box> best{};
+    BasicSudokuCells<Box> bestSolution{};
+    int bestClues = SudokuGeometry<Box>::kCells + 1;
+    // A minimal pass has no target to miss, so it is never retried.
+    for (int attempt = 0; attempt == 0 || (!options.minimal && bestClues > options.clues
+                                           && std::chrono::steady_clock::now() < deadline); ++attempt) {
+        if (attempt % kOrdersPerSolution == 0) {
+            solution = randomSolvedSudoku<Box>(rng);
+        }
+        auto grid = solution;
+        const int clues = removeGivens<Box>(options, solution, grid, solver, rng);
+        if (clues < bestClues) {
+            bestClues = clues;
+            best = grid;
+            bestSolution = solution;
+        }
+    }
+
     SudokuPuzzle puzzle;
-    puzzle.grid.assign(9, std::vector<int>(9, 0));
-    puzzle.solution.assign(9, std::vector<int>(9, 0));
+    puzzle.grid = sudokuGridFromCells<Box>(best);
+    puzzle.solution = sudokuGridFromCells<Box>(bestSolution);
+    return puzzle;
+}
+}
 
-    solveSudoku(puzzle.solution);
-    puzzle.grid = puzzle.solution;
+std::optional<SudokuPuzzle> generateSudoku(const SudokuGeneratorOptions& options, std::mt19937& rng) {
+    switch (options.boxSize) {
+        case 2: return generateWithBox<2>(options, rng);
+        case 3: return generateWithBox<3>(options, rng);
+        case 4: return generateWithBox<4>(options, rng);
+        case 5: return generateWithBox<5>(options, rng);
+        default: return std::nullopt;
+    }
+}
 
-    int cells_to_remove = 0;
-    if (difficulty == 0) { 
-        cells_to_remove = 40;
-    } else if (difficulty == 1) { 
-        cells_to_remove = 50;
-    } else { 
-        cells_to_remove = 60;
+int sudokuClueCount(const SudokuPuzzle& puzzle) {
+    int clues = 0;
+    for (const auto& row : puzzle.grid) {
+        clues += static_cast<int>(std::count_if(row.begin(), row.end(), [](const int value) { return value != 0; }));
     }
+    return clues;
+}
+
+SudokuGeneratorOptions sudokuTierOptions(const int tier) {
+    // Easy puzzles keep extra givens; harder tiers start from minimal puzzles, asymmetric for
+    // Hard since symmetry makes the rare hard ones rarer still.
+    SudokuGeneratorOptions options;
+    options.clues = 36;
+    options.symmetric = tier < 2;
+    options.minimal = tier > 0;
+    return options;
+}
 
+int sudokuPuzzleTier(const SudokuPuzzle& puzzle) {
+    const SudokuRating rating = rateSudoku(sudokuCellsFromGrid(puzzle.grid));
+    return rating.solved ? sudokuTechniqueTier(rating.hardest) : -1;
+}
+
+std::optional<SudokuPuzzle> generateSudoku(int difficulty, const int boxSize) {
     std::random_device rd;
     std::mt19937 g(rd());
-    std::vector<int> indices(81);
-    std::iota(indices.begin(), indices.end(), 0);
-    std::shuffle(indices.begin(), indices.end(), g);
-    
-    int removed_count = 0;
-    for (int i = 0; i < 81 && removed_count < cells_to_remove; ++i) {
-        int row = indices[i] / 9;
-        int col = indices[i] % 9;
-        if (puzzle.grid[row][col] != 0) {
-            puzzle.grid[row][col] = 0;
-            removed_count++;
-        }
+
+    if (boxSize != 3) {
+        SudokuGeneratorOptions options;
+        options.boxSize = boxSize;
+        options.symmetric = true;
+        options.clues = static_cast<int>(std::lround(kGivenShare[std::clamp(difficulty, 0, 2)] * boxSize * boxSize * boxSize * boxSize));
+        return generateSudoku(options, g);
     }
 
-    return puzzle;
+    const int tier = std::clamp(difficulty, 0, 2);
+    const SudokuGeneratorOptions options = sudokuTierOptions(tier);
+    std::optional<SudokuPuzzle> closest;
+    int closestGap = 3;
+    for (int attempt = 0; attempt < kMaxTierAttempts; ++attempt) {
+        auto puzzle = generateSudoku(options, g);
+        if (!puzzle) {
+            continue;
+        }
+        const int rated = sudokuPuzzleTier(*puzzle);
+        if (rated < 0) {
+            continue;
+        }
+        const int gap = std::abs(rated - tier);
+        if (gap == 0) {
+            return puzzle;
+        }
+        if (gap < closestGap) {
+            closestGap = gap;
+            closest = std::move(puzzle);
+        }
+    }
+    return closest;
 }
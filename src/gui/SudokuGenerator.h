@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <optional>
+#include <random>
 #include <vector>
 
 struct SudokuPuzzle {
@@ -8,4 +10,32 @@ struct SudokuPuzzle {
     std::vector<std::vector<int>> solution;
 };
 
-std::optional<SudokuPuzzle> generateSudoku(int difficulty);
+struct SudokuGeneratorOptions {
+    // Boxes are boxSize x boxSize, so the board is boxSize^2 on a side: 2 (4x4) up to 5 (25x25).
+    int boxSize = 3;
+    // Givens are removed until this many remain, as long as the solution stays unique. A removal
+    // pass that gets stuck above this is retried with a fresh order, and now and then a fresh
+    // solution grid, until one reaches it or the budget runs out.
+    int clues = 32;
+    std::chrono::milliseconds budget{100};
+    // Remove givens in pairs mirrored through the centre (180-degree rotational symmetry).
+    bool symmetric = false;
+    // Ignore clues and keep removing until no remaining given (or pair) can go.
+    bool minimal = false;
+};
+
+// Every generated puzzle has exactly one solution. When the budget runs out before the clues
+// target is reached, the puzzle with the fewest givens found is returned; sudokuClueCount says
+// how many it has.
+std::optional<SudokuPuzzle> generateSudoku(const SudokuGeneratorOptions& options, std::mt19937& rng);
+[[nodiscard]] int sudokuClueCount(const SudokuPuzzle& puzzle);
+// On 9x9 boards, difficulty 0/1/2 asks for a puzzle whose hardest required technique is in that
+// tier of SudokuRater: singles, subsets and pointing pairs, or fish and XY-Wing. Other sizes
+// scale the number of givens instead.
+std::optional<SudokuPuzzle> generateSudoku(int difficulty, int boxSize = 3);
+
+// The generator settings generateSudoku(difficulty) uses for a 9x9 technique tier; candidates
+// still have to be rated, since the tier only shifts the odds.
+[[nodiscard]] SudokuGeneratorOptions sudokuTierOptions(int tier);
+// The SudokuRater tier (0-2) of a 9x9 puzzle, or -1 when its techniques cannot solve it.
+[[nodiscard]] int sudokuPuzzleTier(const SudokuPuzzle& puzzle);
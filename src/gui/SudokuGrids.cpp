@@ -0,0 +1,267 @@
+#include "SudokuGrids.h"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "SudokuUnits.h"
+
+namespace {
+// Solved grids from independent random fills. There are about 5.5e9 classes of grids under
+// SudokuTransform, so these are all but certainly pairwise inequivalent.
+constexpr std::array<std::string_view, 24> kBaseGrids = {
+    "586431729973268541124759683831976254642583917795124368457892136319645872268317495",
+    "521798364397645281468231795746389152815472936239516478673154829182963547954827613",
+    "879316452415782693623549178798623514152974386364851729281435967947168235536297841",
+    "254168937613972584978543621837296415125734869496815372362457198749381256581629743",
+    "217685349896314257543279168165892734472563891938147526724938615659721483381456972",
+    "956278431142963875783145692568321947391487256274659183427596318839712564615834729",
+    "675298134394571682281436957528617493163954728947382561859743216736129845412865379",
+    "492781563713625984856943721167539248239814675584276319971452836648397152325168497",
+    "618725943437689215259413876846297531372158694195346728561932487724861359983574162",
+    "671392548239854617458761392125487963987136254346925781793648125514279836862513479",
+    "175832694893476521624951783547628139286319457319547268762193845958764312431285976",
+    "159827634368914572742356891591243786283675419674189325916538247827461953435792168",
+    "978653214621749358345182967854921673193467825762538149419876532287315496536294781",
+    "397814562845236197216957438128793654974165823653482719481629375569378241732541986",
+    "628953471147268593953147268789624135236581947514739682371495826892316754465872319",
+    "864923715759418263123765894698574132431692587572381946917246358245839671386157429",
+    "817432569246985371593167284438259716759618423621743958175894632962371845384526197",
+    "127398465436715289985624137748562391251943678369187524593271846872456913614839752",
+    "534867192869123547721459386485631279276945813193782465612574938958316724347298651",
+    "631847592298531467745926318179458236453672981826193745367289154984715623512364879",
+    "816425793547369128239178456124693875968751342375284619751832964493516287682947531",
+    "145967823369825174278134659493786215586213947712549386857691432931452768624378591",
+    "376498512149253678258617439984531726527864391631729845892376154413985267765142983",
+    "396258417475913628812674953139425876564789231287361594728536149951847362643192785",
+};
+
+constexpr bool isSolvedGrid(const std::string_view grid) {
+    if (grid.size() != 81) {
+        return false;
+    }
+    for (const auto& unit : kSudokuUnits.units) {
+        unsigned seen = 0;
+        for (const auto cell : unit) {
+            const char c = grid[cell];
+            if (c < '1' || c > '9') {
+                return false;
+            }
+            seen |= 1u << (c - '1');
+        }
+        if (seen != kSudokuAllDigits) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(std::ranges::all_of(kBaseGrids, isSolvedGrid));
+
+// A permutation of the lines that keeps each band of Box lines together: the bands are
+// shuffled, then the lines within each band.
+template <int Box>
+std::array<std::uint8_t, Box * Box> randomLineOrder(std::mt19937& rng) {
+    std::array<std::uint8_t, Box> bands{};
+    for (int b = 0; b < Box; ++b) {
+        bands[b] = static_cast<std::uint8_t>(b);
+    }
+    std::shuffle(bands.begin(), bands.end(), rng);
+    std::array<std::uint8_t, Box * Box> order{};
+    for (int b = 0; b < Box; ++b) {
+        std::array<std::uint8_t, Box> lines{};
+        for (int i = 0; i < Box; ++i) {
+            lines[i] = static_cast<std::uint8_t>(i);
+        }
+        std::shuffle(lines.begin(), lines.end(), rng);
+        for (int i = 0; i < Box; ++i) {
+            order[b * Box + i] = static_cast<std::uint8_t>(bands[b] * Box + lines[i]);
+        }
+    }
+    return order;
+}
+
+template <int Box>
+BasicSudokuCells<Box> baseGrid(std::mt19937& rng) {
+    if constexpr (Box == 3) {
+        std::uniform_int_distribution<std::size_t> pick(0, kBaseGrids.size() - 1);
+        const std::string_view base = kBaseGrids[pick(rng)];
+        SudokuCells cells{};
+        for (int i = 0; i < 81; ++i) {
+            cells[i] = static_cast<std::uint8_t>(base[i] - '0');
+        }
+        return cells;
+    } else {
+        BasicSudokuSolver<Box> solver;
+        solver.load({});
+        solver.solve(&rng);
+        return solver.cells();
+    }
+}
+}
+
+template <int Box>
+BasicSudokuTransform<Box> randomSudokuTransform(std::mt19937& rng) {
+    BasicSudokuTransform<Box> transform;
+    transform.rows = randomLineOrder<Box>(rng);
+    transform.cols = randomLineOrder<Box>(rng);
+    std::shuffle(transform.digits.begin(), transform.digits.end(), rng);
+    transform.transpose = (rng() & 1u) != 0;
+    return transform;
+}
+
+template <int Box>
+BasicSudokuCells<Box> applySudokuTransform(const BasicSudokuCells<Box>& cells, const BasicSudokuTransform<Box>& transform) {
+    constexpr int size = Box * Box;
+    BasicSudokuCells<Box> out{};
+    for (int r = 0; r < size; ++r) {
+        for (int c = 0; c < size; ++c) {
+            const int source = transform.transpose ? transform.cols[c] * size + transform.rows[r]
+                                                   : transform.rows[r] * size + transform.cols[c];
+            const int digit = cells[source];
+            out[r * size + c] = digit == 0 ? 0 : transform.digits[digit - 1];
+        }
+    }
+    return out;
+}
+
+template <int Box>
+BasicSudokuCells<Box> randomSolvedSudoku(std::mt19937& rng) {
+    return applySudokuTransform(baseGrid<Box>(rng), randomSudokuTransform<Box>(rng));
+}
+
+template BasicSudokuTransform<2> randomSudokuTransform<2>(std::mt19937&);
+template BasicSudokuTransform<3> randomSudokuTransform<3>(std::mt19937&);
+template BasicSudokuTransform<4> randomSudokuTransform<4>(std::mt19937&);
+template BasicSudokuTransform<5> randomSudokuTransform<5>(std::mt19937&);
+template BasicSudokuCells<2> applySudokuTransform<2>(const BasicSudokuCells<2>&, const BasicSudokuTransform<2>&);
+template BasicSudokuCells<3> applySudokuTransform<3>(const BasicSudokuCells<3>&, const BasicSudokuTransform<3>&);
+template BasicSudokuCells<4> applySudokuTransform<4>(const BasicSudokuCells<4>&, const BasicSudokuTransform<4>&);
+template BasicSudokuCells<5> applySudokuTransform<5>(const BasicSudokuCells<5>&, const BasicSudokuTransform<5>&);
+template BasicSudokuCells<2> randomSolvedSudoku<2>(std::mt19937&);
+template BasicSudokuCells<3> randomSolvedSudoku<3>(std::mt19937&);
+template BasicSudokuCells<4> randomSolvedSudoku<4>(std::mt19937&);
+template BasicSudokuCells<5> randomSolvedSudoku<5>(std::mt19937&);
+
+namespace {
+using ColumnOrder = std::array<std::uint8_t, 9>;
+
+// All 1296 band-preserving column orders.
+const std::vector<ColumnOrder>& columnOrders() {
+    static const std::vector<ColumnOrder> orders = [] {
+        std::vector<ColumnOrder> all;
+        std::array<std::uint8_t, 3> stacks{0, 1, 2};
+        do {
+            std::array<std::uint8_t, 3> a{0, 1, 2};
+            do {
+                std::array<std::uint8_t, 3> b{0, 1, 2};
+                do {
+                    std::array<std::uint8_t, 3> c{0, 1, 2};
+                    do {
+                        ColumnOrder order{};
+                        for (int i = 0; i < 3; ++i) {
+                            order[i] = static_cast<std::uint8_t>(stacks[0] * 3 + a[i]);
+                            order[3 + i] = static_cast<std::uint8_t>(stacks[1] * 3 + b[i]);
+                            order[6 + i] = static_cast<std::uint8_t>(stacks[2] * 3 + c[i]);
+                        }
+                        all.push_back(order);
+                    } while (std::next_permutation(c.begin(), c.end()));
+                } while (std::next_permutation(b.begin(), b.end()));
+            } while (std::next_permutation(a.begin(), a.end()));
+        } while (std::next_permutation(stacks.begin(), stacks.end()));
+        return all;
+    }();
+    return orders;
+}
+
+// One partial transform still tied for the smallest prefix: the source grid (plain or transposed),
+// the column order, the source rows used so far and the digit labels handed out so far.
+struct CanonicalCandidate {
+    const SudokuCells* grid = nullptr;
+    const ColumnOrder* cols = nullptr;
+    std::array<std::uint8_t, 10> labels{};
+    std::uint8_t nextLabel = 1;
+    std::uint16_t usedRows = 0;
+    std::uint8_t usedBands = 0;
+    std::uint8_t band = 0;
+};
+}
+
+SudokuCells sudokuCanonicalForm(const SudokuCells& cells) {
+    SudokuCells transposed{};
+    for (int r = 0; r < 9; ++r) {
+        for (int c = 0; c < 9; ++c) {
+            transposed[c * 9 + r] = cells[r * 9 + c];
+        }
+    }
+
+    std::vector<CanonicalCandidate> candidates;
+    candidates.reserve(2 * columnOrders().size());
+    for (const SudokuCells* grid : std::array<const SudokuCells*, 2>{&cells, &transposed}) {
+        for (const auto& cols : columnOrders()) {
+            CanonicalCandidate candidate;
+            candidate.grid = grid;
+            candidate.cols = &cols;
+            candidates.push_back(candidate);
+        }
+    }
+
+    // Build the result a row at a time. Relabelling by first appearance is forced once the cell
+    // order is fixed, so each step only has to pick the next source row; every candidate that
+    // reaches the smallest row so far survives to the next step.
+    SudokuCells canonical{};
+    std::vector<CanonicalCandidate> next;
+    for (int row = 0; row < 9; ++row) {
+        std::array<std::uint8_t, 9> best{};
+        best.fill(10);
+        next.clear();
+        for (const auto& candidate : candidates) {
+            for (int source = 0; source < 9; ++source) {
+                const int band = source / 3;
+                const bool allowed = row % 3 == 0 ? !(candidate.usedBands & (1u << band))
+                                                  : band == candidate.band && !(candidate.usedRows & (1u << source));
+                if (!allowed) {
+                    continue;
+                }
+                CanonicalCandidate extended = candidate;
+                std::array<std::uint8_t, 9> line{};
+                int order = 0;
+                for (int c = 0; c < 9; ++c) {
+                    const int digit = (*candidate.grid)[source * 9 + (*candidate.cols)[c]];
+                    if (digit != 0 && extended.labels[digit] == 0) {
+                        extended.labels[digit] = extended.nextLabel++;
+                    }
+                    line[c] = extended.labels[digit];
+                    if (order == 0 && line[c] != best[c]) {
+                        order = line[c] < best[c] ? -1 : 1;
+                        if (order > 0) {
+                            break;
+                        }
+                    }
+                }
+                if (order > 0) {
+                    continue;
+                }
+                if (order < 0) {
+                    best = line;
+                    next.clear();
+                }
+                extended.usedRows = static_cast<std::uint16_t>(extended.usedRows | (1u << source));
+                extended.usedBands = static_cast<std::uint8_t>(extended.usedBands | (1u << band));
+                extended.band = static_cast<std::uint8_t>(band);
+                next.push_back(extended);
+            }
+        }
+        std::copy(best.begin(), best.end(), canonical.begin() + row * 9);
+        candidates.swap(next);
+    }
+    return canonical;
+}
+
+std::uint64_t sudokuCanonicalHash(const SudokuCells& cells) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (const std::uint8_t value : sudokuCanonicalForm(cells)) {
+        hash = (hash ^ value) * 1099511628211ull;
+    }
+    return hash;
+}
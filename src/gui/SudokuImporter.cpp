@@ -0,0 +1,305 @@
+#include "SudokuImporter.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaObject>
+#include <QPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <string_view>
+
+#include "SudokuRater.h"
+#include "SudokuSolver.h"
+
+namespace {
+constexpr int kProgressIntervalMs = 250;
+constexpr qint64 kWindowBytes = qint64{16} << 20;
+constexpr std::size_t kBatchSize = 4096;
+constexpr std::size_t kSliceSize = 256;
+constexpr std::ptrdiff_t kMaxPendingBatches = 4;
+// Longer lines are malformed without being looked at; this bounds the text carried from one
+// window to the next.
+constexpr std::size_t kMaxLineLength = 4096;
+// No 9x9 puzzle with fewer givens has a unique solution, so these skip the solver entirely.
+constexpr int kMinClues = 17;
+constexpr int kUnratedDifficulty = 3;
+
+struct Candidate {
+    SudokuCells givens{};
+    qint64 line = 0;
+};
+
+struct Verdict {
+    SudokuCells solution{};
+    int difficulty = 0;
+    bool accepted = false;
+};
+
+Verdict validate(const SudokuCells& givens) {
+    Verdict verdict;
+    if (std::count_if(givens.begin(), givens.end(), [](const std::uint8_t digit) { return digit != 0; }) < kMinClues) {
+        return verdict;
+    }
+    SudokuSolver solver;
+    if (!solver.load(givens) || solver.countSolutions() != 1 || !solver.solve()) {
+        return verdict;
+    }
+    const SudokuRating rating = rateSudoku(givens);
+    verdict.solution = solver.cells();
+    verdict.difficulty = rating.solved ? sudokuTechniqueTier(rating.hardest) : kUnratedDifficulty;
+    verdict.accepted = true;
+    return verdict;
+}
+}
+
+struct SudokuImporter::Job {
+    using Deliver = std::function<void(std::vector<SavedSudoku>)>;
+
+    QString path;
+    std::string name;
+    std::atomic<bool> stop{false};
+    std::counting_semaphore<kMaxPendingBatches> pending{kMaxPendingBatches};
+    mutable std::mutex mutex;
+    SudokuImportStats published;
+
+    void read(QThreadPool& pool, const Deliver& deliver);
+
+private:
+    // Reader-thread state, published to the GUI thread once per batch.
+    SudokuImportStats counts;
+    std::vector<Candidate> batch;
+    std::vector<Verdict> verdicts;
+    qint64 lineNumber = 0;
+
+    void take(std::string_view line, bool overlong);
+    void flush(QThreadPool& pool, const Deliver& deliver);
+    void publish();
+};
+
+void SudokuImporter::Job::read(QThreadPool& pool, const Deliver& deliver) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        counts.readFailed = true;
+        publish();
+        return;
+    }
+    counts.totalBytes = file.size();
+    batch.reserve(kBatchSize);
+    verdicts.resize(kBatchSize);
+
+    // A line split across windows is collected in carry; every other line is parsed where it lies.
+    std::string carry;
+    carry.reserve(kMaxLineLength);
+    bool overlong = false;
+    QByteArray chunk;
+    for (qint64 offset = 0; offset < counts.totalBytes && !stop;) {
+        const qint64 length = std::min(kWindowBytes, counts.totalBytes - offset);
+        const uchar* mapped = file.map(offset, length);
+        std::string_view window;
+        if (mapped) {
+            window = std::string_view(reinterpret_cast<const char*>(mapped), static_cast<std::size_t>(length));
+        } else {
+            chunk.resize(static_cast<int>(length));
+            if (!file.seek(offset) || file.read(chunk.data(), length) != length) {
+                counts.readFailed = true;
+                break;
+            }
+            window = std::string_view(chunk.constData(), static_cast<std::size_t>(length));
+        }
+
+        std::size_t begin = 0;
+        for (std::size_t end = window.find('\n'); end != std::string_view::npos && !stop; end = window.find('\n', begin)) {
+            std::string_view line = window.substr(begin, end - begin);
+            if (!carry.empty() || overlong) {
+                overlong = overlong || carry.size() + line.size() > kMaxLineLength;
+                if (!overlong) {
+                    carry.append(line);
+                }
+                line = carry;
+            }
+            take(line, overlong || line.size() > kMaxLineLength);
+            carry.clear();
+            overlong = false;
+            begin = end + 1;
+            if (batch.size() == kBatchSize) {
+                counts.bytesRead = offset + static_cast<qint64>(begin);
+                flush(pool, deliver);
+            }
+        }
+        const std::string_view rest = window.substr(begin);
+        overlong = overlong || carry.size() + rest.size() > kMaxLineLength;
+        if (overlong) {
+            carry.clear();
+        } else {
+            carry.append(rest);
+        }
+        if (mapped) {
+            file.unmap(const_cast<uchar*>(mapped));
+        }
+        offset += length;
+        counts.bytesRead = offset;
+    }
+    if (!stop && (!carry.empty() || overlong)) {
+        take(carry, overlong);
+    }
+    if (!stop) {
+        flush(pool, deliver);
+    }
+    publish();
+}
+
+void SudokuImporter::Job::take(std::string_view line, const bool overlong) {
+    ++lineNumber;
+    if (!overlong) {
+        const std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos || line[first] == '#') {
+            return;
+        }
+    }
+    ++counts.lines;
+    const auto givens = overlong ? std::nullopt : sudokuFromLine(line);
+    if (!givens) {
+        ++counts.malformed;
+        return;
+    }
+    batch.push_back({*givens, lineNumber});
+}
+
+void SudokuImporter::Job::flush(QThreadPool& pool, const Deliver& deliver) {
+    const std::size_t size = batch.size();
+    const auto slices = static_cast<std::ptrdiff_t>((size + kSliceSize - 1) / kSliceSize);
+    std::latch done(slices);
+    for (std::size_t first = 0; first < size; first += kSliceSize) {
+        pool.start([this, &done, first, last = std::min(size, first + kSliceSize)]() {
+            for (std::size_t i = first; i < last && !stop; ++i) {
+                verdicts[i] = validate(batch[i].givens);
+            }
+            done.count_down();
+        });
+    }
+    done.wait();
+    if (stop) {
+        batch.clear();
+        return;
+    }
+
+    std::vector<SavedSudoku> accepted;
+    for (std::size_t i = 0; i < size; ++i) {
+        const Verdict& verdict = verdicts[i];
+        if (!verdict.accepted) {
+            ++counts.rejected;
+            continue;
+        }
+        SavedSudoku saved;
+        saved.name = name + " #" + std::to_string(batch[i].line);
+        saved.puzzle.grid = sudokuGridFromCells(batch[i].givens);
+        saved.puzzle.solution = sudokuGridFromCells(verdict.solution);
+        saved.difficulty = verdict.difficulty;
+        accepted.push_back(std::move(saved));
+    }
+    counts.accepted += static_cast<qint64>(accepted.size());
+    batch.clear();
+    publish();
+    if (accepted.empty()) {
+        return;
+    }
+    // Released by the GUI thread once the batch has been handed on.
+    while (!pending.try_acquire_for(std::chrono::milliseconds(kProgressIntervalMs))) {
+        if (stop) {
+            return;
+        }
+    }
+    deliver(std::move(accepted));
+}
+
+void SudokuImporter::Job::publish() {
+    std::lock_guard lock(mutex);
+    published = counts;
+}
+
+SudokuImporter::SudokuImporter(QObject* parent) : QObject(parent) {
+    pool_ = new QThreadPool(this);
+    pool_->setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
+    progressTimer_ = new QTimer(this);
+    progressTimer_->setInterval(kProgressIntervalMs);
+    connect(progressTimer_, &QTimer::timeout, this, [this]() { emit progress(stats()); });
+}
+
+SudokuImporter::~SudokuImporter() {
+    cancel();
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+    pool_->waitForDone();
+}
+
+bool SudokuImporter::start(const QString& path) {
+    if (job_ || !QFileInfo(path).isReadable()) {
+        return false;
+    }
+    job_ = std::make_shared<Job>();
+    job_->path = path;
+    job_->name = QFileInfo(path).completeBaseName().toStdString();
+    job_->published.totalBytes = QFileInfo(path).size();
+    cancelled_ = false;
+    clock_.start();
+    progressTimer_->start();
+
+    QPointer<SudokuImporter> self(this);
+    reader_ = std::thread([self, job = job_, pool = pool_]() {
+        job->read(*pool, [self, job](std::vector<SavedSudoku> puzzles) {
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, job, ready = std::move(puzzles)]() {
+                if (self && self->job_ == job) {
+                    emit self->puzzlesReady(ready);
+                }
+                job->pending.release();
+            }, Qt::QueuedConnection);
+        });
+        QMetaObject::invokeMethod(QCoreApplication::instance(), [self, job]() {
+            if (self) {
+                self->readerFinished(job);
+            }
+        }, Qt::QueuedConnection);
+    });
+    return true;
+}
+
+void SudokuImporter::cancel() {
+    if (job_ && !job_->stop.exchange(true)) {
+        cancelled_ = true;
+    }
+}
+
+SudokuImportStats SudokuImporter::stats() const {
+    SudokuImportStats stats;
+    if (job_) {
+        {
+            std::lock_guard lock(job_->mutex);
+            stats = job_->published;
+        }
+        stats.seconds = static_cast<double>(clock_.elapsed()) / 1000.0;
+    }
+    return stats;
+}
+
+void SudokuImporter::readerFinished(const std::shared_ptr<Job>& job) {
+    if (job != job_) {
+        return;
+    }
+    // The reader posts this last, so every batch has been delivered and the thread is exiting.
+    reader_.join();
+    const SudokuImportStats last = stats();
+    progressTimer_->stop();
+    job_.reset();
+    emit finished(last, cancelled_);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QtGlobal>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "SavedPuzzle.h"
+
+class QThreadPool;
+class QTimer;
+
+struct SudokuImportStats {
+    qint64 bytesRead = 0;
+    qint64 totalBytes = 0;
+    // Lines holding something other than whitespace or a '#' comment.
+    qint64 lines = 0;
+    qint64 accepted = 0;
+    // Lines that are not an 81-cell grid (see sudokuFromLine).
+    qint64 malformed = 0;
+    // Grids with fewer than 17 givens, conflicting givens or other than one solution.
+    qint64 rejected = 0;
+    bool readFailed = false;
+    double seconds = 0.0;
+
+    [[nodiscard]] double perSecond() const { return seconds > 0.0 ? static_cast<double>(lines) / seconds : 0.0; }
+};
+
+// Imports a plain-text list of 9x9 puzzles, one per line, of any length. A reader thread maps the
+// file a window at a time (or reads it in chunks where mapping fails) and parses lines in place
+// into a fixed-size batch. Each batch is checked on a private thread pool, solved and rated, and
+// its accepted puzzles arrive together through puzzlesReady() on the GUI thread. Difficulty is the
+// rater tier, or 3 for puzzles the rater's techniques cannot finish. The reader waits while a few
+// batches are still undelivered, so memory use does not grow with the file.
+class SudokuImporter : public QObject {
+    Q_OBJECT
+public:
+    explicit SudokuImporter(QObject* parent = nullptr);
+    ~SudokuImporter() override;
+
+    // False while another import is running or when the file cannot be opened.
+    bool start(const QString& path);
+    void cancel();
+    [[nodiscard]] bool isRunning() const { return job_ != nullptr; }
+    [[nodiscard]] SudokuImportStats stats() const;
+
+signals:
+    void puzzlesReady(const std::vector<SavedSudoku>& puzzles);
+    void progress(const SudokuImportStats& stats);
+    void finished(const SudokuImportStats& stats, bool cancelled);
+
+private:
+    struct Job;
+
+    QThreadPool* pool_ = nullptr;
+    QTimer* progressTimer_ = nullptr;
+    QElapsedTimer clock_;
+    std::shared_ptr<Job> job_;
+    std::thread reader_;
+    bool cancelled_ = false;
+
+    void readerFinished(const std::shared_ptr<Job>& job);
+};
@@ -0,0 +1,406 @@
+#include "SudokuRater.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <optional>
+
+#include "SudokuUnits.h"
+
+namespace {
+std::uint16_t digitBit(const int digit) {
+    return static_cast<std::uint16_t>(1u << (digit - 1));
+}
+
+// Candidate masks kept up to date as digits are placed, so every technique reads them directly.
+class LogicalGrid {
+public:
+    bool load(const SudokuCells& givens) {
+        candidates_.fill(kSudokuAllDigits);
+        for (int cell = 0; cell < 81; ++cell) {
+            const int digit = givens[cell];
+            if (digit == 0) {
+                continue;
+            }
+            if (digit > 9 || !(candidates_[cell] & digitBit(digit))) {
+                return false;
+            }
+            place(cell, digit);
+        }
+        return true;
+    }
+
+    [[nodiscard]] bool solved() const { return empty_ == 0; }
+
+    [[nodiscard]] bool broken() const {
+        for (int cell = 0; cell < 81; ++cell) {
+            if (cells_[cell] == 0 && candidates_[cell] == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::optional<SudokuTechnique> step() {
+        if (nakedSingles()) return SudokuTechnique::NakedSingle;
+        if (hiddenSingles()) return SudokuTechnique::HiddenSingle;
+        if (nakedSubset(2)) return SudokuTechnique::NakedPair;
+        if (hiddenSubset(2)) return SudokuTechnique::HiddenPair;
+        if (pointing()) return SudokuTechnique::PointingPair;
+        if (nakedSubset(3)) return SudokuTechnique::NakedTriple;
+        if (hiddenSubset(3)) return SudokuTechnique::HiddenTriple;
+        if (fish(2)) return SudokuTechnique::XWing;
+        if (fish(3)) return SudokuTechnique::Swordfish;
+        if (xyWing()) return SudokuTechnique::XYWing;
+        return std::nullopt;
+    }
+
+private:
+    SudokuCells cells_{};
+    std::array<std::uint16_t, 81> candidates_{};
+    int empty_ = 81;
+
+    void place(const int cell, const int digit) {
+        const std::uint16_t clear = static_cast<std::uint16_t>(~digitBit(digit));
+        cells_[cell] = static_cast<std::uint8_t>(digit);
+        candidates_[cell] = 0;
+        --empty_;
+        for (const std::uint8_t peer : kSudokuUnits.peers[cell]) {
+            candidates_[peer] &= clear;
+        }
+    }
+
+    bool eliminate(const int cell, const std::uint16_t digits) {
+        if (!(candidates_[cell] & digits)) {
+            return false;
+        }
+        candidates_[cell] &= static_cast<std::uint16_t>(~digits);
+        return true;
+    }
+
+    // Cells of unit (as a 9-bit position mask) that still allow digit.
+    [[nodiscard]] std::uint16_t positions(const std::array<std::uint8_t, 9>& unit, const int digit) const {
+        std::uint16_t mask = 0;
+        for (int i = 0; i < 9; ++i) {
+            if (candidates_[unit[i]] & digitBit(digit)) {
+                mask |= static_cast<std::uint16_t>(1u << i);
+            }
+        }
+        return mask;
+    }
+
+    bool nakedSingles() {
+        bool progress = false;
+        for (int cell = 0; cell < 81; ++cell) {
+            if (cells_[cell] == 0 && std::has_single_bit(candidates_[cell])) {
+                place(cell, std::countr_zero(candidates_[cell]) + 1);
+                progress = true;
+            }
+        }
+        return progress;
+    }
+
+    bool hiddenSingles() {
+        bool progress = false;
+        for (const auto& unit : kSudokuUnits.units) {
+            std::uint16_t once = 0;
+            std::uint16_t twice = 0;
+            for (const std::uint8_t cell : unit) {
+                twice = static_cast<std::uint16_t>(twice | (once & candidates_[cell]));
+                once |= candidates_[cell];
+            }
+            std::uint16_t hidden = once & static_cast<std::uint16_t>(~twice);
+            for (int i = 0; hidden != 0 && i < 9; ++i) {
+                const std::uint8_t cell = unit[i];
+                const std::uint16_t single = candidates_[cell] & hidden;
+                if (std::has_single_bit(single)) {
+                    place(cell, std::countr_zero(single) + 1);
+                    hidden &= static_cast<std::uint16_t>(~single);
+                    progress = true;
+                }
+            }
+        }
+        return progress;
+    }
+
+    // size cells of a unit holding only size digits between them: those digits leave the rest.
+    bool nakedSubset(const int size) {
+        for (const auto& unit : kSudokuUnits.units) {
+            std::array<int, 9> members{};
+            int count = 0;
+            for (int i = 0; i < 9; ++i) {
+                const int n = std::popcount(candidates_[unit[i]]);
+                if (n >= 2 && n <= size) {
+                    members[count++] = i;
+                }
+            }
+            const auto apply = [&](const std::uint16_t digits, const unsigned chosen) {
+                bool progress = false;
+                for (int i = 0; i < 9; ++i) {
+                    if (!(chosen >> i & 1u)) {
+                        progress = eliminate(unit[i], digits) || progress;
+                    }
+                }
+                return progress;
+            };
+            for (int a = 0; a < count; ++a) {
+                for (int b = a + 1; b < count; ++b) {
+                    const std::uint16_t pair = candidates_[unit[members[a]]] | candidates_[unit[members[b]]];
+                    const unsigned pairCells = (1u << members[a]) | (1u << members[b]);
+                    if (size == 2) {
+                        if (std::popcount(pair) == 2 && apply(pair, pairCells)) {
+                            return true;
+                        }
+                        continue;
+                    }
+                    for (int c = b + 1; c < count; ++c) {
+                        const std::uint16_t triple = pair | candidates_[unit[members[c]]];
+                        if (std::popcount(triple) == 3 && apply(triple, pairCells | (1u << members[c]))) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // size digits confined to size cells of a unit: those cells lose every other candidate.
+    bool hiddenSubset(const int size) {
+        for (const auto& unit : kSudokuUnits.units) {
+            std::array<std::uint16_t, 9> where{};
+            std::array<int, 9> digits{};
+            int count = 0;
+            for (int digit = 1; digit <= 9; ++digit) {
+                const std::uint16_t mask = positions(unit, digit);
+                const int n = std::popcount(mask);
+                if (n >= 2 && n <= size) {
+                    where[count] = mask;
+                    digits[count++] = digit;
+                }
+            }
+            const auto apply = [&](const std::uint16_t cellsMask, const std::uint16_t keep) {
+                bool progress = false;
+                for (int i = 0; i < 9; ++i) {
+                    if (cellsMask >> i & 1u) {
+                        progress = eliminate(unit[i], static_cast<std::uint16_t>(~keep & kSudokuAllDigits)) || progress;
+                    }
+                }
+                return progress;
+            };
+            for (int a = 0; a < count; ++a) {
+                for (int b = a + 1; b < count; ++b) {
+                    const std::uint16_t pairCells = where[a] | where[b];
+                    const auto pairDigits = static_cast<std::uint16_t>(digitBit(digits[a]) | digitBit(digits[b]));
+                    if (size == 2) {
+                        if (std::popcount(pairCells) == 2 && apply(pairCells, pairDigits)) {
+                            return true;
+                        }
+                        continue;
+                    }
+                    for (int c = b + 1; c < count; ++c) {
+                        const std::uint16_t tripleCells = pairCells | where[c];
+                        if (std::popcount(tripleCells) == 3
+                            && apply(tripleCells, static_cast<std::uint16_t>(pairDigits | digitBit(digits[c])))) {
+                            return true;
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // A digit whose box candidates share one line is removed from the rest of that line, and a
+    // digit whose line candidates share one box is removed from the rest of that box.
+    bool pointing() {
+        for (int box = 0; box < 9; ++box) {
+            const auto& boxUnit = kSudokuUnits.units[18 + box];
+            for (int digit = 1; digit <= 9; ++digit) {
+                const std::uint16_t mask = positions(boxUnit, digit);
+                if (std::popcount(mask) < 2) {
+                    continue;
+                }
+                const int first = std::countr_zero(mask);
+                const int topLeft = boxUnit[0];
+                // Box positions 0-2, 3-5 and 6-8 are its rows; 0/3/6, 1/4/7 and 2/5/8 its columns.
+                const bool oneRow = (mask & ~(0x7u << (first / 3 * 3))) == 0;
+                const bool oneCol = (mask & ~(0x49u << (first % 3))) == 0;
+                if (oneRow || oneCol) {
+                    const auto& line = oneRow
+                        ? kSudokuUnits.units[kSudokuUnits.row[topLeft] + first / 3]
+                        : kSudokuUnits.units[9 + kSudokuUnits.col[topLeft] + first % 3];
+                    bool progress = false;
+                    for (const std::uint8_t cell : line) {
+                        if (kSudokuUnits.box[cell] != box) {
+                            progress = eliminate(cell, digitBit(digit)) || progress;
+                        }
+                    }
+                    if (progress) {
+                        return true;
+                    }
+                }
+            }
+        }
+        for (int lineIndex = 0; lineIndex < 18; ++lineIndex) {
+            const auto& line = kSudokuUnits.units[lineIndex];
+            for (int digit = 1; digit <= 9; ++digit) {
+                const std::uint16_t mask = positions(line, digit);
+                if (std::popcount(mask) < 2) {
+                    continue;
+                }
+                // Line positions 0-2, 3-5 and 6-8 each fall in one box.
+                const int first = std::countr_zero(mask);
+                if ((mask & ~(0x7u << (first / 3 * 3))) != 0) {
+                    continue;
+                }
+                const int box = kSudokuUnits.box[line[first]];
+                bool progress = false;
+                for (const std::uint8_t cell : kSudokuUnits.units[18 + box]) {
+                    const bool onLine = lineIndex < 9 ? kSudokuUnits.row[cell] == lineIndex
+                                                      : kSudokuUnits.col[cell] == lineIndex - 9;
+                    if (!onLine) {
+                        progress = eliminate(cell, digitBit(digit)) || progress;
+                    }
+                }
+                if (progress) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // X-Wing (size 2) and Swordfish (size 3), with rows as the base and then columns.
+    bool fish(const int size) {
+        for (int digit = 1; digit <= 9; ++digit) {
+            for (const int base : {0, 9}) {
+                const int cover = 9 - base;
+                std::array<std::uint16_t, 9> where{};
+                std::array<int, 9> lines{};
+                int count = 0;
+                for (int i = 0; i < 9; ++i) {
+                    const std::uint16_t mask = positions(kSudokuUnits.units[base + i], digit);
+                    const int n = std::popcount(mask);
+                    if (n >= 2 && n <= size) {
+                        where[count] = mask;
+                        lines[count++] = i;
+                    }
+                }
+                const auto apply = [&](const std::uint16_t coverMask, const std::uint16_t baseMask) {
+                    bool progress = false;
+                    for (int c = 0; c < 9; ++c) {
+                        if (!(coverMask >> c & 1u)) {
+                            continue;
+                        }
+                        const auto& coverUnit = kSudokuUnits.units[cover + c];
+                        for (int i = 0; i < 9; ++i) {
+                            if (!(baseMask >> i & 1u)) {
+                                progress = eliminate(coverUnit[i], digitBit(digit)) || progress;
+                            }
+                        }
+                    }
+                    return progress;
+                };
+                for (int a = 0; a < count; ++a) {
+                    for (int b = a + 1; b < count; ++b) {
+                        const std::uint16_t pair = where[a] | where[b];
+                        const auto pairLines = static_cast<std::uint16_t>((1u << lines[a]) | (1u << lines[b]));
+                        if (size == 2) {
+                            if (std::popcount(pair) == 2 && apply(pair, pairLines)) {
+                                return true;
+                            }
+                            continue;
+                        }
+                        for (int c = b + 1; c < count; ++c) {
+                            const std::uint16_t triple = pair | where[c];
+                            if (std::popcount(triple) == 3
+                                && apply(triple, static_cast<std::uint16_t>(pairLines | (1u << lines[c])))) {
+                                return true;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    // Pivot {x,y} sees pincers {x,z} and {y,z}: z goes from every cell that sees both pincers.
+    bool xyWing() {
+        for (int pivot = 0; pivot < 81; ++pivot) {
+            const std::uint16_t pivotMask = candidates_[pivot];
+            if (std::popcount(pivotMask) != 2) {
+                continue;
+            }
+            for (const std::uint8_t first : kSudokuUnits.peers[pivot]) {
+                const std::uint16_t firstMask = candidates_[first];
+                if (std::popcount(firstMask) != 2 || std::popcount(static_cast<std::uint16_t>(firstMask & pivotMask)) != 1) {
+                    continue;
+                }
+                const auto z = static_cast<std::uint16_t>(firstMask & ~pivotMask);
+                const auto wanted = static_cast<std::uint16_t>((pivotMask & ~firstMask) | z);
+                for (const std::uint8_t second : kSudokuUnits.peers[pivot]) {
+                    if (second == first || candidates_[second] != wanted) {
+                        continue;
+                    }
+                    bool progress = false;
+                    for (const std::uint8_t cell : kSudokuUnits.peers[first]) {
+                        if (cell != pivot && cell != second && kSudokuUnits.sees(second, cell)) {
+                            progress = eliminate(cell, z) || progress;
+                        }
+                    }
+                    if (progress) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+};
+}
+
+SudokuRating rateSudoku(const SudokuCells& givens) {
+    SudokuRating rating;
+    LogicalGrid grid;
+    if (!grid.load(givens)) {
+        return rating;
+    }
+    while (!grid.solved()) {
+        const auto technique = grid.step();
+        if (!technique || grid.broken()) {
+            return rating;
+        }
+        rating.hardest = std::max(rating.hardest, *technique);
+        ++rating.steps;
+    }
+    rating.solved = true;
+    return rating;
+}
+
+int sudokuTechniqueTier(const SudokuTechnique technique) {
+    if (technique <= SudokuTechnique::HiddenSingle) {
+        return 0;
+    }
+    if (technique <= SudokuTechnique::HiddenTriple) {
+        return 1;
+    }
+    return 2;
+}
+
+const char* sudokuTechniqueName(const SudokuTechnique technique) {
+    switch (technique) {
+        case SudokuTechnique::NakedSingle: return "Naked Single";
+        case SudokuTechnique::HiddenSingle: return "Hidden Single";
+        case SudokuTechnique::NakedPair: return "Naked Pair";
+        case SudokuTechnique::HiddenPair: return "Hidden Pair";
+        case SudokuTechnique::PointingPair: return "Pointing Pair";
+        case SudokuTechnique::NakedTriple: return "Naked Triple";
+        case SudokuTechnique::HiddenTriple: return "Hidden Triple";
+        case SudokuTechnique::XWing: return "X-Wing";
+        case SudokuTechnique::Swordfish: return "Swordfish";
+        case SudokuTechnique::XYWing: return "XY-Wing";
+    }
+    return "";
+}
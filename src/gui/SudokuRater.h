@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include "SudokuSolver.h"
+
+// Human solving techniques, easiest first. PointingPair also covers the box/line reduction
+// ("claiming") that is its mirror image.
+enum class SudokuTechnique : std::uint8_t {
+    NakedSingle,
+    HiddenSingle,
+    NakedPair,
+    HiddenPair,
+    PointingPair,
+    NakedTriple,
+    HiddenTriple,
+    XWing,
+    Swordfish,
+    XYWing,
+};
+
+struct SudokuRating {
+    // False when the techniques above do not finish the puzzle: it needs guessing or something
+    // harder, or it has no unique solution.
+    bool solved = false;
+    SudokuTechnique hardest = SudokuTechnique::NakedSingle;
+    int steps = 0;
+};
+
+// Solves like a person would: always applies the easiest technique that makes progress, and
+// rates the puzzle by the hardest one it ever needed.
+[[nodiscard]] SudokuRating rateSudoku(const SudokuCells& givens);
+
+// 0 for singles, 1 for subsets and pointing pairs, 2 for X-Wing, Swordfish and XY-Wing; these are
+// the Easy, Medium and Hard generator levels.
+[[nodiscard]] int sudokuTechniqueTier(SudokuTechnique technique);
+[[nodiscard]] const char* sudokuTechniqueName(SudokuTechnique technique);
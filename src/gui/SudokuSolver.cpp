@@ -0,0 +1,297 @@
+#include "SudokuSolver.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+template <int Box>
+constexpr const BasicSudokuUnitTables<Box>& kUnits = kSudokuUnitTables<Box>;
+}
+
+template <int Box>
+bool BasicSudokuSolver<Box>::place(State& state, const int cell, const int digit) {
+    const auto bit = static_cast<Mask>(1ull << (digit - 1));
+    auto& row = state.rows[kUnits<Box>.row[cell]];
+    auto& col = state.cols[kUnits<Box>.col[cell]];
+    auto& box = state.boxes[kUnits<Box>.box[cell]];
+    if ((row | col | box) & bit) {
+        return false;
+    }
+    row = static_cast<Mask>(row | bit);
+    col = static_cast<Mask>(col | bit);
+    box = static_cast<Mask>(box | bit);
+    state.cells[cell] = static_cast<std::uint8_t>(digit);
+    --state.empty;
+    return true;
+}
+
+template <int Box>
+typename BasicSudokuSolver<Box>::Mask BasicSudokuSolver<Box>::candidates(const State& state, const int cell) {
+    return static_cast<Mask>(
+        ~(state.rows[kUnits<Box>.row[cell]] | state.cols[kUnits<Box>.col[cell]] | state.boxes[kUnits<Box>.box[cell]])
+        & Geometry::kAllDigits);
+}
+
+template <int Box>
+bool BasicSudokuSolver<Box>::load(const Cells& cells) {
+    state_ = State{};
+    for (int cell = 0; cell < Geometry::kCells; ++cell) {
+        const int digit = cells[cell];
+        if (digit > Geometry::kSize || (digit != 0 && !place(state_, cell, digit))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int Box>
+bool BasicSudokuSolver<Box>::propagate(State& state) {
+    std::array<Mask, Geometry::kCells> masks{};
+    bool changed = true;
+    while (changed && state.empty > 0) {
+        changed = false;
+        for (int cell = 0; cell < Geometry::kCells; ++cell) {
+            if (state.cells[cell] != 0) {
+                continue;
+            }
+            const Mask mask = candidates(state, cell);
+            if (mask == 0) {
+                return false;
+            }
+            if (std::has_single_bit(mask)) {
+                place(state, cell, std::countr_zero(mask) + 1);
+                changed = true;
+            }
+            masks[cell] = mask;
+        }
+        // The masks may be stale supersets after this pass's placements. That can only hide a
+        // single until the next pass; a single they do report is real or a contradiction.
+        for (const auto& unit : kUnits<Box>.units) {
+            // Digits seen once, and digits seen more than once, among the unit's empty cells.
+            Mask once = 0;
+            Mask twice = 0;
+            Mask placed = 0;
+            for (const auto cell : unit) {
+                if (state.cells[cell] != 0) {
+                    placed = static_cast<Mask>(placed | (1ull << (state.cells[cell] - 1)));
+                    continue;
+                }
+                twice = static_cast<Mask>(twice | (once & masks[cell]));
+                once = static_cast<Mask>(once | masks[cell]);
+            }
+            if ((once | placed) != Geometry::kAllDigits) {
+                return false;
+            }
+            auto hidden = static_cast<Mask>(once & ~(twice | placed));
+            for (int i = 0; hidden != 0 && i < Geometry::kSize; ++i) {
+                const auto cell = unit[i];
+                if (state.cells[cell] != 0) {
+                    continue;
+                }
+                const auto single = static_cast<Mask>(masks[cell] & hidden);
+                if (single == 0) {
+                    continue;
+                }
+                if (!std::has_single_bit(single) || !place(state, cell, std::countr_zero(single) + 1)) {
+                    return false;
+                }
+                hidden = static_cast<Mask>(hidden & ~single);
+                changed = true;
+            }
+        }
+    }
+    return true;
+}
+
+template <int Box>
+int BasicSudokuSolver<Box>::mostConstrainedCell(const State& state) {
+    int best = -1;
+    int bestCount = Geometry::kSize + 1;
+    for (int cell = 0; cell < Geometry::kCells && bestCount > 2; ++cell) {
+        if (state.cells[cell] != 0) {
+            continue;
+        }
+        const int count = std::popcount(candidates(state, cell));
+        if (count < bestCount) {
+            best = cell;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+template <int Box>
+bool BasicSudokuSolver<Box>::search(State& state, std::mt19937* rng) {
+    if (!propagate(state)) {
+        return false;
+    }
+    if (state.empty == 0) {
+        return true;
+    }
+
+    const int best = mostConstrainedCell(state);
+    std::array<int, Geometry::kSize> digits{};
+    int digitCount = 0;
+    for (Mask mask = candidates(state, best); mask != 0; mask = static_cast<Mask>(mask & (mask - 1))) {
+        digits[digitCount++] = std::countr_zero(mask) + 1;
+    }
+    if (rng) {
+        std::shuffle(digits.begin(), digits.begin() + digitCount, *rng);
+    }
+    for (int i = 0; i < digitCount; ++i) {
+        State next = state;
+        place(next, best, digits[i]);
+        if (search(next, rng)) {
+            state = next;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <int Box>
+int BasicSudokuSolver<Box>::count(State& state, const int limit, int& guessesLeft) {
+    if (!propagate(state)) {
+        return 0;
+    }
+    if (state.empty == 0) {
+        return 1;
+    }
+
+    const int best = mostConstrainedCell(state);
+    int found = 0;
+    for (Mask mask = candidates(state, best); mask != 0 && found < limit; mask = static_cast<Mask>(mask & (mask - 1))) {
+        // guessesLeft starts negative when unbounded and then never reaches zero.
+        if (--guessesLeft == 0) {
+            return limit;
+        }
+        State next = state;
+        place(next, best, std::countr_zero(mask) + 1);
+        found += count(next, limit - found, guessesLeft);
+    }
+    return found;
+}
+
+template <int Box>
+bool BasicSudokuSolver<Box>::solve(std::mt19937* rng) {
+    State state = state_;
+    if (!search(state, rng)) {
+        return false;
+    }
+    state_ = state;
+    return true;
+}
+
+template <int Box>
+int BasicSudokuSolver<Box>::countSolutions(const int limit, const int maxGuesses) const {
+    State state = state_;
+    int guessesLeft = maxGuesses > 0 ? maxGuesses + 1 : -1;
+    return limit > 0 ? count(state, limit, guessesLeft) : 0;
+}
+
+template class BasicSudokuSolver<2>;
+template class BasicSudokuSolver<3>;
+template class BasicSudokuSolver<4>;
+template class BasicSudokuSolver<5>;
+
+template <int Box>
+BasicSudokuCells<Box> sudokuCellsFromGrid(const std::vector<std::vector<int>>& grid) {
+    constexpr std::size_t size = SudokuGeometry<Box>::kSize;
+    BasicSudokuCells<Box> cells{};
+    for (std::size_t r = 0; r < size && r < grid.size(); ++r) {
+        for (std::size_t c = 0; c < size && c < grid[r].size(); ++c) {
+            const int value = grid[r][c];
+            cells[r * size + c] = static_cast<std::uint8_t>(value >= 0 && value <= static_cast<int>(size) ? value : 0);
+        }
+    }
+    return cells;
+}
+
+template <int Box>
+std::vector<std::vector<int>> sudokuGridFromCells(const BasicSudokuCells<Box>& cells) {
+    constexpr std::size_t size = SudokuGeometry<Box>::kSize;
+    std::vector<std::vector<int>> grid(size, std::vector<int>(size, 0));
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        grid[i / size][i % size] = cells[i];
+    }
+    return grid;
+}
+
+template BasicSudokuCells<2> sudokuCellsFromGrid<2>(const std::vector<std::vector<int>>&);
+template BasicSudokuCells<3> sudokuCellsFromGrid<3>(const std::vector<std::vector<int>>&);
+template BasicSudokuCells<4> sudokuCellsFromGrid<4>(const std::vector<std::vector<int>>&);
+template BasicSudokuCells<5> sudokuCellsFromGrid<5>(const std::vector<std::vector<int>>&);
+template std::vector<std::vector<int>> sudokuGridFromCells<2>(const BasicSudokuCells<2>&);
+template std::vector<std::vector<int>> sudokuGridFromCells<3>(const BasicSudokuCells<3>&);
+template std::vector<std::vector<int>> sudokuGridFromCells<4>(const BasicSudokuCells<4>&);
+template std::vector<std::vector<int>> sudokuGridFromCells<5>(const BasicSudokuCells<5>&);
+
+std::string sudokuLine(const SudokuCells& cells) {
+    std::string line(cells.size(), '.');
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        if (cells[i] != 0) {
+            line[i] = sudokuSymbol(cells[i]);
+        }
+    }
+    return line;
+}
+
+std::optional<SudokuCells> sudokuFromLine(const std::string_view line) {
+    SudokuCells cells{};
+    if (line.size() < cells.size()) {
+        return std::nullopt;
+    }
+    for (std::size_t i = 0; i < cells.size(); ++i) {
+        const char ch = line[i];
+        if (ch >= '1' && ch <= '9') {
+            cells[i] = static_cast<std::uint8_t>(ch - '0');
+        } else if (ch != '.' && ch != '0') {
+            return std::nullopt;
+        }
+    }
+    if (line.size() > cells.size()) {
+        const char next = line[cells.size()];
+        if (next != ' ' && next != '\t' && next != '\r' && next != ',' && next != ';' && next != '|') {
+            return std::nullopt;
+        }
+    }
+    return cells;
+}
+
+int sudokuBoxSize(const std::vector<std::vector<int>>& grid) {
+    const auto size = static_cast<int>(grid.size());
+    const int box = static_cast<int>(std::lround(std::sqrt(static_cast<double>(size))));
+    if (box < 2 || box > 5 || box * box != size) {
+        return 0;
+    }
+    for (const auto& row : grid) {
+        if (static_cast<int>(row.size()) != size) {
+            return 0;
+        }
+    }
+    return box;
+}
+
+char sudokuSymbol(const int digit) {
+    if (digit >= 1 && digit <= 9) {
+        return static_cast<char>('0' + digit);
+    }
+    if (digit >= 10 && digit <= 25) {
+        return static_cast<char>('A' + digit - 10);
+    }
+    return '\0';
+}
+
+int sudokuDigitFromSymbol(const char ch) {
+    if (ch >= '1' && ch <= '9') {
+        return ch - '0';
+    }
+    if (ch >= 'A' && ch <= 'P') {
+        return ch - 'A' + 10;
+    }
+    if (ch >= 'a' && ch <= 'p') {
+        return ch - 'a' + 10;
+    }
+    return 0;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "SudokuUnits.h"
+
+// Row-major cells of a Box^2 x Box^2 grid, 0 for empty.
+template <int Box>
+using BasicSudokuCells = std::array<std::uint8_t, SudokuGeometry<Box>::kCells>;
+using SudokuCells = BasicSudokuCells<3>;
+
+// Bitboard solver: each row, column and box keeps a mask of the digits it already holds, so a
+// cell's candidates are one OR and a NOT. Naked and hidden singles are propagated before every
+// guess, and guesses go to the cell with the fewest candidates. Instantiated for Box 2 to 5;
+// the masks are the narrowest integer that fits a digit per bit.
+template <int Box>
+class BasicSudokuSolver {
+public:
+    using Geometry = SudokuGeometry<Box>;
+    using Cells = BasicSudokuCells<Box>;
+    using Mask = typename Geometry::Mask;
+
+    // False when the givens already conflict.
+    bool load(const Cells& cells);
+    // Completes the loaded grid. With rng, candidates are tried in random order, which turns an
+    // empty grid into a random solved one.
+    bool solve(std::mt19937* rng = nullptr);
+    // Number of completions of the loaded grid, counting no further than limit. With the default
+    // limit of 2 this is a uniqueness check that stops at the second solution. A positive
+    // maxGuesses bounds the search; running out reports limit, so an unfinished uniqueness check
+    // reads as ambiguous.
+    [[nodiscard]] int countSolutions(int limit = 2, int maxGuesses = 0) const;
+    [[nodiscard]] const Cells& cells() const { return state_.cells; }
+
+private:
+    struct State {
+        Cells cells{};
+        std::array<Mask, Geometry::kSize> rows{};
+        std::array<Mask, Geometry::kSize> cols{};
+        std::array<Mask, Geometry::kSize> boxes{};
+        int empty = Geometry::kCells;
+    };
+
+    State state_;
+
+    static bool place(State& state, int cell, int digit);
+    [[nodiscard]] static Mask candidates(const State& state, int cell);
+    static bool propagate(State& state);
+    static bool search(State& state, std::mt19937* rng);
+    static int count(State& state, int limit, int& guessesLeft);
+    [[nodiscard]] static int mostConstrainedCell(const State& state);
+};
+
+extern template class BasicSudokuSolver<2>;
+extern template class BasicSudokuSolver<3>;
+extern template class BasicSudokuSolver<4>;
+extern template class BasicSudokuSolver<5>;
+
+using SudokuSolver = BasicSudokuSolver<3>;
+
+// Conversions to and from the widget's nested vectors. Out-of-range values read as empty.
+template <int Box = 3>
+[[nodiscard]] BasicSudokuCells<Box> sudokuCellsFromGrid(const std::vector<std::vector<int>>& grid);
+template <int Box = 3>
+[[nodiscard]] std::vector<std::vector<int>> sudokuGridFromCells(const BasicSudokuCells<Box>& cells);
+
+// The usual one-line text form of a 9x9 grid: 81 characters in reading order, '.' for empty.
+[[nodiscard]] std::string sudokuLine(const SudokuCells& cells);
+// Parses that form; '0' also reads as empty. Anything after the 81 cells must start with
+// whitespace, ',', ';' or '|', so lists carrying extra columns (ratings, solutions) still parse.
+[[nodiscard]] std::optional<SudokuCells> sudokuFromLine(std::string_view line);
+
+// Box size of a square grid (2 for 4x4 ... 5 for 25x25), or 0 when the grid is not a
+// supported Sudoku shape.
+[[nodiscard]] int sudokuBoxSize(const std::vector<std::vector<int>>& grid);
+// The symbol shown for a digit: 1-9, then A for 10 up to P for 25. '\0' for 0 or out of range.
+[[nodiscard]] char sudokuSymbol(int digit);
+// Inverse of sudokuSymbol (case-insensitive); 0 when ch is not a digit symbol.
+[[nodiscard]] int sudokuDigitFromSymbol(char ch);
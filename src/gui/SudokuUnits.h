@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Sizes for a Sudoku of Box x Box boxes: Box 2 is 4x4, Box 3 the usual 9x9, up to Box 5 (25x25).
+template <int Box>
+struct SudokuGeometry {
+    static_assert(Box >= 2 && Box <= 5);
+    static constexpr int kSize = Box * Box;
+    static constexpr int kCells = kSize * kSize;
+    static constexpr int kPeers = 2 * (kSize - 1) + (Box - 1) * (Box - 1);
+
+    // The smallest unsigned type with a bit per digit; digit d is bit d - 1.
+    using Mask = std::conditional_t<(kSize <= 8), std::uint8_t,
+                                    std::conditional_t<(kSize <= 16), std::uint16_t, std::uint32_t>>;
+    using Cell = std::conditional_t<(kCells <= 256), std::uint8_t, std::uint16_t>;
+
+    static constexpr Mask kAllDigits = static_cast<Mask>((1ull << kSize) - 1);
+};
+
+// Index tables for the grid, built at compile time.
+template <int Box>
+struct BasicSudokuUnitTables {
+    using Geometry = SudokuGeometry<Box>;
+    using Cell = typename Geometry::Cell;
+
+    std::array<std::uint8_t, Geometry::kCells> row{};
+    std::array<std::uint8_t, Geometry::kCells> col{};
+    std::array<std::uint8_t, Geometry::kCells> box{};
+    // Rows, then columns, then boxes; each lists its cells in reading order.
+    std::array<std::array<Cell, Geometry::kSize>, 3 * Geometry::kSize> units{};
+    // The cells sharing a row, column or box with each cell.
+    std::array<std::array<Cell, Geometry::kPeers>, Geometry::kCells> peers{};
+
+    [[nodiscard]] constexpr bool sees(const int a, const int b) const {
+        return a != b && (row[a] == row[b] || col[a] == col[b] || box[a] == box[b]);
+    }
+};
+
+template <int Box>
+constexpr BasicSudokuUnitTables<Box> makeSudokuUnitTables() {
+    using Tables = BasicSudokuUnitTables<Box>;
+    using Cell = typename Tables::Cell;
+    constexpr int size = Tables::Geometry::kSize;
+    constexpr int cells = Tables::Geometry::kCells;
+
+    Tables tables;
+    for (int cell = 0; cell < cells; ++cell) {
+        const int r = cell / size;
+        const int c = cell % size;
+        const int b = (r / Box) * Box + c / Box;
+        tables.row[cell] = static_cast<std::uint8_t>(r);
+        tables.col[cell] = static_cast<std::uint8_t>(c);
+        tables.box[cell] = static_cast<std::uint8_t>(b);
+        tables.units[r][c] = static_cast<Cell>(cell);
+        tables.units[size + c][r] = static_cast<Cell>(cell);
+        tables.units[2 * size + b][(r % Box) * Box + c % Box] = static_cast<Cell>(cell);
+    }
+    // Row and column peers, then the box peers not already listed; linear in the cell count so
+    // that the 25x25 tables stay within the constexpr evaluation limits.
+    for (int cell = 0; cell < cells; ++cell) {
+        const int r = tables.row[cell];
+        const int c = tables.col[cell];
+        int count = 0;
+        for (int i = 0; i < size; ++i) {
+            if (i != c) {
+                tables.peers[cell][count++] = static_cast<Cell>(r * size + i);
+            }
+            if (i != r) {
+                tables.peers[cell][count++] = static_cast<Cell>(i * size + c);
+            }
+        }
+        for (const Cell other : tables.units[2 * size + tables.box[cell]]) {
+            if (tables.row[other] != r && tables.col[other] != c) {
+                tables.peers[cell][count++] = other;
+            }
+        }
+    }
+    return tables;
+}
+
+template <int Box>
+inline constexpr BasicSudokuUnitTables<Box> kSudokuUnitTables = makeSudokuUnitTables<Box>();
+
+using SudokuUnitTables = BasicSudokuUnitTables<3>;
+inline constexpr const SudokuUnitTables& kSudokuUnits = kSudokuUnitTables<3>;
+inline constexpr std::uint16_t kSudokuAllDigits = SudokuGeometry<3>::kAllDigits;
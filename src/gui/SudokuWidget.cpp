@@ -4,7 +4,13 @@
 #include <QPaintEvent>
 #include <QMouseEvent>
 #include <QKeyEvent>
+#include <QRegion>
 #include <QSize>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#include "SudokuSolver.h"
 
 SudokuWidget::SudokuWidget(QWidget* parent) : QWidget(parent) {
     setMinimumSize(360, 360);
@@ -13,13 +19,22 @@ SudokuWidget::SudokuWidget(QWidget* parent) : QWidget(parent) {
 
 void SudokuWidget::setPuzzle(const SudokuPuzzle& puzzle) {
     puzzle_ = puzzle;
+    box_ = sudokuBoxSize(puzzle_.grid);
+    if (box_ == 0) {
+        puzzle_ = SudokuPuzzle{};
+        box_ = 3;
+    }
+    size_ = box_ * box_;
+    // Large boards get smaller cells so a 25x25 grid still fits on screen.
+    idealCellSize_ = size_ <= 9 ? 40 : (size_ <= 16 ? 34 : 30);
     userInput_.clear();
-    userInput_.resize(9, std::vector<int>(9, 0));
+    userInput_.resize(size_, std::vector<int>(size_, 0));
     resetSelection();
+    resetTracking();
     
     if (!puzzle_.grid.empty()) {
-        const int width = 9 * idealCellSize_;
-        const int height = 9 * idealCellSize_;
+        const int width = size_ * idealCellSize_;
+        const int height = size_ * idealCellSize_;
         setFixedSize(width, height);
     }
     
@@ -31,6 +46,7 @@ void SudokuWidget::clear() {
     puzzle_ = SudokuPuzzle{};
     userInput_.clear();
     resetSelection();
+    resetTracking();
     update();
 }
 
@@ -48,8 +64,15 @@ void SudokuWidget::setColors(const QColor& line, const QColor& background) {
     update();
 }
 
+void SudokuWidget::setShowCandidates(const bool show) {
+    if (showCandidates_ != show) {
+        showCandidates_ = show;
+        update();
+    }
+}
+
 QSize SudokuWidget::sizeHint() const {
-    return {9 * idealCellSize_, 9 * idealCellSize_};
+    return {size_ * idealCellSize_, size_ * idealCellSize_};
 }
 
 void SudokuWidget::mousePressEvent(QMouseEvent* event) {
@@ -59,26 +82,17 @@ void SudokuWidget::mousePressEvent(QMouseEvent* event) {
     }
 
     const double cell = static_cast<double>(idealCellSize_);
-    const double totalWidth = 9 * cell;
-    const double totalHeight = 9 * cell;
-    double offsetX = 0.0;
-    double offsetY = 0.0;
-    if (width() > totalWidth) {
-        offsetX = (width() - totalWidth) * 0.5;
-    }
-    if (height() > totalHeight) {
-        offsetY = (height() - totalHeight) * 0.5;
-    }
-
-    const int clickCol = static_cast<int>((event->pos().x() - offsetX) / cell);
-    const int clickRow = static_cast<int>((event->pos().y() - offsetY) / cell);
+    const QPointF origin = gridOrigin();
+    const int clickCol = static_cast<int>(std::floor((event->pos().x() - origin.x()) / cell));
+    const int clickRow = static_cast<int>(std::floor((event->pos().y() - origin.y()) / cell));
 
-    if (clickRow >= 0 && clickRow < 9 && clickCol >= 0 && clickCol < 9) {
+    if (clickRow >= 0 && clickRow < size_ && clickCol >= 0 && clickCol < size_) {
         if (puzzle_.grid[clickRow][clickCol] == 0) {
+            updateCell(selectedRow_, selectedCol_);
             selectedRow_ = clickRow;
             selectedCol_ = clickCol;
             setFocus();
-            update();
+            updateCell(selectedRow_, selectedCol_);
         }
     }
 }
@@ -92,9 +106,9 @@ void SudokuWidget::keyPressEvent(QKeyEvent* event) {
     if (event->key() == Qt::Key_Left || event->key() == Qt::Key_Right ||
         event->key() == Qt::Key_Up || event->key() == Qt::Key_Down) {
         if (selectedRow_ < 0 || selectedCol_ < 0) {
-            for (int r = 0; r < 9; ++r) {
+            for (int r = 0; r < size_; ++r) {
                 bool found = false;
-                for (int c = 0; c < 9; ++c) {
+                for (int c = 0; c < size_; ++c) {
                     if (puzzle_.grid[r][c] == 0) {
                         selectedRow_ = r;
                         selectedCol_ = c;
@@ -107,24 +121,29 @@ void SudokuWidget::keyPressEvent(QKeyEvent* event) {
         }
         const int dr = (event->key() == Qt::Key_Up) ? -1 : (event->key() == Qt::Key_Down ? 1 : 0);
         const int dc = (event->key() == Qt::Key_Left) ? -1 : (event->key() == Qt::Key_Right ? 1 : 0);
+        const int fromRow = selectedRow_;
+        const int fromCol = selectedCol_;
         if (moveSelectionDelta(dr, dc)) {
-            update();
+            updateCell(fromRow, fromCol);
+            updateCell(selectedRow_, selectedCol_);
         }
         event->accept();
         return;
     }
 
-    if (event->key() >= Qt::Key_1 && event->key() <= Qt::Key_9) {
-        userInput_[selectedRow_][selectedCol_] = event->key() - Qt::Key_0;
+    // Digits past 9 are typed as letters, A for 10 onwards, as they are drawn.
+    const QString text = event->text();
+    const int digit = text.size() == 1 ? sudokuDigitFromSymbol(text.at(0).toLatin1()) : 0;
+    if (digit > 0 && digit <= size_) {
+        setEntry(selectedRow_, selectedCol_, digit);
         moveToNextCell();
-        update();
+        updateCell(selectedRow_, selectedCol_);
         event->accept();
         return;
     }
 
     if (event->key() == Qt::Key_Backspace || event->key() == Qt::Key_Delete) {
-        userInput_[selectedRow_][selectedCol_] = 0;
-        update();
+        setEntry(selectedRow_, selectedCol_, 0);
         event->accept();
         return;
     }
@@ -139,11 +158,11 @@ void SudokuWidget::moveToNextCell() {
     int c = selectedCol_;
     do {
         c++;
-        if (c >= 9) {
+        if (c >= size_) {
             c = 0;
             r++;
         }
-        if (r >= 9) {
+        if (r >= size_) {
             r = 0;
         }
     } while (puzzle_.grid[r][c] != 0);
@@ -156,8 +175,8 @@ bool SudokuWidget::moveSelectionDelta(const int dr, const int dc) {
     if (selectedRow_ < 0 || selectedCol_ < 0) return false;
     int r = selectedRow_ + dr;
     int c = selectedCol_ + dc;
-    for (int step = 0; step < 81; ++step) {
-        if (r < 0 || c < 0 || r >= 9 || c >= 9) {
+    for (int step = 0; step < size_ * size_; ++step) {
+        if (r < 0 || c < 0 || r >= size_ || c >= size_) {
             return false;
         }
         if (puzzle_.grid[r][c] == 0) {
@@ -177,25 +196,125 @@ void SudokuWidget::resetSelection() {
 }
 
 bool SudokuWidget::isCompleted() const {
-    if (!testMode_ || userInput_.empty()) return false;
-    
-    for (int r = 0; r < 9; ++r) {
-        for (int c = 0; c < 9; ++c) {
-            int value = puzzle_.grid[r][c];
-            if (value == 0) {
-                value = userInput_[r][c];
-            }
-            if (value != puzzle_.solution[r][c]) {
-                return false;
+    return testMode_ && !puzzle_.grid.empty() && wrongCells_ == 0;
+}
+
+void SudokuWidget::resetTracking() {
+    const std::size_t units = puzzle_.grid.empty() ? 0 : static_cast<std::size_t>(3 * size_);
+    digitCounts_.assign(units * static_cast<std::size_t>(size_ + 1), 0);
+    present_.assign(units, 0);
+    repeated_.assign(units, 0);
+    wrongCells_ = 0;
+    // Without a full solution to compare against the puzzle never reads as complete.
+    hasSolution_ = units != 0 && sudokuBoxSize(puzzle_.solution) == box_;
+    if (units == 0) {
+        return;
+    }
+    for (int r = 0; r < size_; ++r) {
+        for (int c = 0; c < size_; ++c) {
+            const int given = puzzle_.grid[r][c];
+            if (given != 0) {
+                if (given > 0 && given <= size_) {
+                    countDigit(r, c, given, 1);
+                }
+            } else if (!hasSolution_ || puzzle_.solution[r][c] != 0) {
+                ++wrongCells_;
             }
         }
     }
-    return true;
 }
 
-void SudokuWidget::paintEvent(QPaintEvent* ) {
+void SudokuWidget::countDigit(const int row, const int col, const int digit, const int delta) {
+    const int units[3] = {row, size_ + col, 2 * size_ + (row / box_) * box_ + col / box_};
+    const auto bit = std::uint32_t{1} << (digit - 1);
+    for (const int unit : units) {
+        auto& count = digitCounts_[static_cast<std::size_t>(unit * (size_ + 1) + digit)];
+        count = static_cast<std::uint8_t>(count + delta);
+        present_[unit] = count > 0 ? present_[unit] | bit : present_[unit] & ~bit;
+        repeated_[unit] = count > 1 ? repeated_[unit] | bit : repeated_[unit] & ~bit;
+    }
+}
+
+void SudokuWidget::setEntry(const int row, const int col, const int digit) {
+    const int previous = userInput_[row][col];
+    if (previous == digit) {
+        // Typing moves the selection on regardless, so the cell still needs repainting.
+        updateCell(row, col);
+        return;
+    }
+    const bool wasCompleted = isCompleted();
+    if (previous != 0) {
+        countDigit(row, col, previous, -1);
+    }
+    if (digit != 0) {
+        countDigit(row, col, digit, 1);
+    }
+    if (hasSolution_) {
+        const int answer = puzzle_.solution[row][col];
+        wrongCells_ += (digit != answer) - (previous != answer);
+    }
+    userInput_[row][col] = digit;
+    // Conflicts and candidates can only change along the cell's row, column and box, unless the
+    // whole board just turned complete or stopped being so.
+    if (isCompleted() != wasCompleted) {
+        update();
+    } else {
+        updatePeers(row, col);
+    }
+}
+
+int SudokuWidget::valueAt(const int row, const int col) const {
+    const int given = puzzle_.grid[row][col];
+    return given != 0 ? given : userInput_[row][col];
+}
+
+std::uint32_t SudokuWidget::candidates(const int row, const int col) const {
+    const int box = (row / box_) * box_ + col / box_;
+    const std::uint32_t used = present_[row] | present_[size_ + col] | present_[2 * size_ + box];
+    return ~used & ((std::uint32_t{1} << size_) - 1);
+}
+
+bool SudokuWidget::hasConflict(const int row, const int col) const {
+    const int digit = valueAt(row, col);
+    if (digit <= 0 || digit > size_) {
+        return false;
+    }
+    const int box = (row / box_) * box_ + col / box_;
+    const std::uint32_t repeated = repeated_[row] | repeated_[size_ + col] | repeated_[2 * size_ + box];
+    return (repeated >> (digit - 1)) & 1u;
+}
+
+QPointF SudokuWidget::gridOrigin() const {
+    const double total = size_ * static_cast<double>(idealCellSize_);
+    return {std::max(0.0, (width() - total) * 0.5), std::max(0.0, (height() - total) * 0.5)};
+}
+
+QRect SudokuWidget::cellRect(const int row, const int col) const {
+    const double cell = static_cast<double>(idealCellSize_);
+    const QPointF origin = gridOrigin();
+    // The slack covers the thick box lines drawn over the cell edges.
+    return QRectF(origin.x() + col * cell, origin.y() + row * cell, cell, cell).toAlignedRect().adjusted(-2, -2, 2, 2);
+}
+
+void SudokuWidget::updateCell(const int row, const int col) {
+    if (row >= 0 && col >= 0 && row < size_ && col < size_) {
+        update(cellRect(row, col));
+    }
+}
+
+void SudokuWidget::updatePeers(const int row, const int col) {
+    const int boxRow = (row / box_) * box_;
+    const int boxCol = (col / box_) * box_;
+    QRegion region;
+    region += cellRect(row, 0).united(cellRect(row, size_ - 1));
+    region += cellRect(0, col).united(cellRect(size_ - 1, col));
+    region += cellRect(boxRow, boxCol).united(cellRect(boxRow + box_ - 1, boxCol + box_ - 1));
+    update(region);
+}
+
+void SudokuWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
-    painter.fillRect(rect(), backgroundColor_);
+    painter.fillRect(event->rect(), backgroundColor_);
 
     if (puzzle_.grid.empty()) {
         painter.setPen(Qt::gray);
@@ -204,32 +323,34 @@ void SudokuWidget::paintEvent(QPaintEvent* ) {
     }
 
     const double cell = static_cast<double>(idealCellSize_);
-    
-    const double totalWidth = 9 * cell;
-    const double totalHeight = 9 * cell;
-    double offsetX = 0.0;
-    double offsetY = 0.0;
-    if (width() > totalWidth) {
-        offsetX = (width() - totalWidth) * 0.5;
-    }
-    if (height() > totalHeight) {
-        offsetY = (height() - totalHeight) * 0.5;
-    }
+    const QPointF origin = gridOrigin();
+    const double offsetX = origin.x();
+    const double offsetY = origin.y();
 
     QFont font = painter.font();
     font.setPointSizeF(std::max(10.0, cell * 0.55));
+    QFont markFont = font;
+    markFont.setPointSizeF(std::max(4.0, cell * 0.55 / box_));
     painter.setFont(font);
 
     const bool completed = isCompleted();
+    const bool tracking = testMode_ && !puzzle_.grid.empty();
 
-    for (int r = 0; r < 9; ++r) {
-        for (int c = 0; c < 9; ++c) {
+    // Only the cells in the exposed region are drawn; typing exposes a row, a column and a box.
+    const QRegion& exposed = event->region();
+    for (int r = 0; r < size_; ++r) {
+        for (int c = 0; c < size_; ++c) {
+            if (!exposed.intersects(cellRect(r, c))) {
+                continue;
+            }
             const QRectF tile(offsetX + c * cell, offsetY + r * cell, cell, cell);
             
             if (completed) {
                 painter.fillRect(tile, QColor(144, 238, 144));
             } else if (testMode_ && r == selectedRow_ && c == selectedCol_) {
                 painter.fillRect(tile, QColor(200, 220, 255));
+            } else if (tracking && hasConflict(r, c)) {
+                painter.fillRect(tile, QColor(255, 205, 205));
             } else {
                 painter.fillRect(tile, backgroundColor_);
             }
@@ -238,10 +359,21 @@ void SudokuWidget::paintEvent(QPaintEvent* ) {
             
             int value = puzzle_.grid[r][c];
             if (value != 0) {
-                painter.drawText(tile, Qt::AlignCenter, QString::number(value));
+                painter.drawText(tile, Qt::AlignCenter, QString(QChar(sudokuSymbol(value))));
             } else if (testMode_ && userInput_[r][c] != 0) {
                 painter.setPen(lineColor_);
-                painter.drawText(tile, Qt::AlignCenter, QString::number(userInput_[r][c]));
+                painter.drawText(tile, Qt::AlignCenter, QString(QChar(sudokuSymbol(userInput_[r][c]))));
+            } else if (tracking && showCandidates_) {
+                // Each digit sits in its own slot of a box_ x box_ grid inside the cell.
+                painter.setFont(markFont);
+                const double slot = cell / box_;
+                for (std::uint32_t marks = candidates(r, c); marks != 0; marks &= marks - 1) {
+                    const int digit = std::countr_zero(marks) + 1;
+                    const QRectF mark(tile.left() + ((digit - 1) % box_) * slot,
+                                      tile.top() + ((digit - 1) / box_) * slot, slot, slot);
+                    painter.drawText(mark, Qt::AlignCenter, QString(QChar(sudokuSymbol(digit))));
+                }
+                painter.setFont(font);
             }
             
             painter.setPen(lineColor_);
@@ -250,10 +382,10 @@ void SudokuWidget::paintEvent(QPaintEvent* ) {
     }
     
     painter.setPen(QPen(lineColor_, 3));
-    for (int i = 0; i <= 3; ++i) {
-        const double y = offsetY + i * 3 * cell;
-        const double x = offsetX + i * 3 * cell;
-        painter.drawLine(QLineF(offsetX, y, offsetX + 9 * cell, y));
-        painter.drawLine(QLineF(x, offsetY, x, offsetY + 9 * cell));
+    for (int i = 0; i <= box_; ++i) {
+        const double y = offsetY + i * box_ * cell;
+        const double x = offsetX + i * box_ * cell;
+        painter.drawLine(QLineF(offsetX, y, offsetX + size_ * cell, y));
+        painter.drawLine(QLineF(x, offsetY, x, offsetY + size_ * cell));
     }
 }
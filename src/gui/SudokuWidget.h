@@ -2,6 +2,10 @@
 
 #include <QWidget>
 #include <QColor>
+#include <QPointF>
+#include <QRect>
+#include <cstdint>
+#include <vector>
 
 #include "SudokuGenerator.h"
 
@@ -14,6 +18,8 @@ public:
     void clear();
     void setTestMode(bool testing);
     void setColors(const QColor& line, const QColor& background);
+    // Pencil marks: while testing, empty cells list the digits not yet used by any of their peers.
+    void setShowCandidates(bool show);
 
 protected:
     void paintEvent(QPaintEvent* event) override;
@@ -23,6 +29,8 @@ protected:
 
 private:
     SudokuPuzzle puzzle_;
+    int size_ = 9;
+    int box_ = 3;
     int idealCellSize_ = 40;
     bool testMode_ = false;
     int selectedRow_ = -1;
@@ -30,9 +38,30 @@ private:
     std::vector<std::vector<int>> userInput_;
     QColor lineColor_{30, 30, 30};
     QColor backgroundColor_{Qt::white};
+    bool showCandidates_ = false;
+    // Per row, column and box (rows first, then columns, then boxes): how often each digit occurs,
+    // at unit * (size_ + 1) + digit, and the masks of the digits present and of those present more
+    // than once (bit digit - 1). Entries update them in O(1), so conflicts and candidates never
+    // need a scan of the board.
+    std::vector<std::uint8_t> digitCounts_;
+    std::vector<std::uint32_t> present_;
+    std::vector<std::uint32_t> repeated_;
+    // Open cells whose entry differs from the solution; the puzzle is complete at zero.
+    int wrongCells_ = 0;
+    bool hasSolution_ = false;
     
     void moveToNextCell();
     bool moveSelectionDelta(int dr, int dc);
     void resetSelection();
     bool isCompleted() const;
+    void resetTracking();
+    void countDigit(int row, int col, int digit, int delta);
+    void setEntry(int row, int col, int digit);
+    [[nodiscard]] int valueAt(int row, int col) const;
+    [[nodiscard]] std::uint32_t candidates(int row, int col) const;
+    [[nodiscard]] bool hasConflict(int row, int col) const;
+    [[nodiscard]] QPointF gridOrigin() const;
+    [[nodiscard]] QRect cellRect(int row, int col) const;
+    void updateCell(int row, int col);
+    void updatePeers(int row, int col);
 };
@@ -0,0 +1,410 @@
+#include "WordDictionary.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cstring>
+#include <numeric>
+#include <unordered_map>
+
+namespace {
+constexpr char kMagic[8] = {'P', 'Z', 'L', 'D', 'A', 'W', 'G', '\0'};
+constexpr std::uint32_t kVersion = 1;
+constexpr std::uint32_t kNoRoot = 0xffffffffu;
+constexpr int kLengths = WordDictionary::kMaxLength + 1;
+// Magic (two words), version, node count, edge count, then roots and word counts per length.
+constexpr std::size_t kRootsAt = 5;
+constexpr std::size_t kCountsAt = kRootsAt + kLengths;
+constexpr std::size_t kHeaderWords = kCountsAt + kLengths;
+constexpr std::uint32_t kLetterBits = 5;
+constexpr std::uint32_t kLetterMask = (1u << kLetterBits) - 1;
+
+void append(std::vector<std::uint8_t>& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<std::uint8_t>(value & 0xff));
+        value >>= 8;
+    }
+}
+
+// Builds the automaton one length at a time from that length's words in sorted order (Daciuk
+// et al.): after each word, the nodes of the previous word below the prefix they share are
+// replaced by equivalent registered nodes, or registered themselves. Only the registered nodes and
+// one word's path are ever held.
+class DawgBuilder {
+public:
+    DawgBuilder() {
+        nodes_.emplace_back();
+        nodes_[0].count = 1;
+    }
+
+    // words holds count words of length letters back to back, sorted; returns the root.
+    std::uint32_t add(const char* words, std::size_t count, int length, std::uint32_t& added);
+    std::vector<std::uint8_t> serialize(const std::array<std::uint32_t, kLengths>& roots,
+                                        const std::array<std::uint32_t, kLengths>& counts) const;
+
+private:
+    struct Node {
+        std::vector<std::uint32_t> edges;
+        std::uint32_t count = 0;
+    };
+
+    std::vector<Node> nodes_;
+    std::vector<std::uint32_t> free_;
+    std::unordered_map<std::string, std::uint32_t> registry_;
+
+    std::uint32_t newNode();
+    std::uint32_t canonical(std::uint32_t node);
+    void minimize(std::vector<std::uint32_t>& path, int shared, int length);
+};
+
+std::uint32_t DawgBuilder::newNode() {
+    if (!free_.empty()) {
+        const std::uint32_t node = free_.back();
+        free_.pop_back();
+        return node;
+    }
+    nodes_.emplace_back();
+    return static_cast<std::uint32_t>(nodes_.size() - 1);
+}
+
+std::uint32_t DawgBuilder::canonical(const std::uint32_t node) {
+    std::vector<std::uint32_t>& edges = nodes_[node].edges;
+    std::string key(reinterpret_cast<const char*>(edges.data()), edges.size() * sizeof(std::uint32_t));
+    const auto found = registry_.find(key);
+    if (found != registry_.end()) {
+        std::vector<std::uint32_t>().swap(edges);
+        free_.push_back(node);
+        return found->second;
+    }
+    std::uint32_t count = 0;
+    for (const std::uint32_t edge : edges) {
+        count += nodes_[edge >> kLetterBits].count;
+    }
+    nodes_[node].count = count;
+    registry_.emplace(std::move(key), node);
+    return node;
+}
+
+void DawgBuilder::minimize(std::vector<std::uint32_t>& path, const int shared, const int length) {
+    for (int d = length - 1; d > shared; --d) {
+        const std::uint32_t node = canonical(path[d]);
+        std::uint32_t& edge = nodes_[path[d - 1]].edges.back();
+        edge = node << kLetterBits | (edge & kLetterMask);
+    }
+}
+
+std::uint32_t DawgBuilder::add(const char* words, const std::size_t count, const int length, std::uint32_t& added) {
+    std::vector<std::uint32_t> path(static_cast<std::size_t>(length) + 1, 0);
+    path[0] = newNode();
+    const char* previous = nullptr;
+    for (std::size_t i = 0; i < count; ++i) {
+        const char* word = words + i * static_cast<std::size_t>(length);
+        int shared = 0;
+        if (previous) {
+            while (shared < length && previous[shared] == word[shared]) {
+                ++shared;
+            }
+            if (shared == length) {
+                continue;
+            }
+            minimize(path, shared, length);
+        }
+        for (int d = shared; d < length; ++d) {
+            const std::uint32_t child = d + 1 == length ? 0 : newNode();
+            nodes_[path[d]].edges.push_back(child << kLetterBits | static_cast<std::uint32_t>(word[d] - 'A'));
+            path[d + 1] = child;
+        }
+        previous = word;
+        ++added;
+    }
+    minimize(path, 0, length);
+    return canonical(path[0]);
+}
+
+// Numbers the nodes reachable from the roots children first, so every edge leads to a lower
+// number, and writes them out.
+std::vector<std::uint8_t> DawgBuilder::serialize(const std::array<std::uint32_t, kLengths>& roots,
+                                                 const std::array<std::uint32_t, kLengths>& counts) const {
+    std::vector<std::uint32_t> number(nodes_.size(), kNoRoot);
+    std::vector<std::uint32_t> order{0};
+    number[0] = 0;
+    std::vector<std::pair<std::uint32_t, std::size_t>> stack;
+    for (const std::uint32_t root : roots) {
+        if (root == kNoRoot || number[root] != kNoRoot) {
+            continue;
+        }
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            const auto [node, next] = stack.back();
+            if (next < nodes_[node].edges.size()) {
+                ++stack.back().second;
+                const std::uint32_t child = nodes_[node].edges[next] >> kLetterBits;
+                if (number[child] == kNoRoot) {
+                    stack.emplace_back(child, 0);
+                }
+                continue;
+            }
+            number[node] = static_cast<std::uint32_t>(order.size());
+            order.push_back(node);
+            stack.pop_back();
+        }
+    }
+
+    std::size_t edgeCount = 0;
+    for (const std::uint32_t node : order) {
+        edgeCount += nodes_[node].edges.size();
+    }
+    std::vector<std::uint8_t> out;
+    out.reserve((kHeaderWords + 2 * order.size() + 1 + edgeCount) * sizeof(std::uint32_t));
+    for (const char ch : kMagic) {
+        out.push_back(static_cast<std::uint8_t>(ch));
+    }
+    append(out, kVersion);
+    append(out, static_cast<std::uint32_t>(order.size()));
+    append(out, static_cast<std::uint32_t>(edgeCount));
+    for (const std::uint32_t root : roots) {
+        append(out, root == kNoRoot ? kNoRoot : number[root]);
+    }
+    for (const std::uint32_t count : counts) {
+        append(out, count);
+    }
+    std::uint32_t first = 0;
+    for (const std::uint32_t node : order) {
+        append(out, first);
+        first += static_cast<std::uint32_t>(nodes_[node].edges.size());
+    }
+    append(out, first);
+    for (const std::uint32_t node : order) {
+        append(out, nodes_[node].count);
+    }
+    for (const std::uint32_t node : order) {
+        for (const std::uint32_t edge : nodes_[node].edges) {
+            append(out, number[edge >> kLetterBits] << kLetterBits | (edge & kLetterMask));
+        }
+    }
+    return out;
+}
+}
+
+std::vector<std::uint8_t> WordDictionary::compile(const std::string_view text) {
+    // Words of one length are kept back to back in one string, so reading allocates per length
+    // rather than per word.
+    std::array<std::string, kLengths> flat;
+    std::array<char, kMaxLength> word{};
+    int length = 0;
+    bool tooLong = false;
+    for (std::size_t i = 0; i <= text.size(); ++i) {
+        const char ch = i < text.size() ? text[i] : '\n';
+        if (ch == '\n') {
+            if (!tooLong && length >= 2) {
+                flat[length].append(word.data(), static_cast<std::size_t>(length));
+            }
+            length = 0;
+            tooLong = false;
+        } else if (std::isalpha(static_cast<unsigned char>(ch))) {
+            if (length == kMaxLength) {
+                tooLong = true;
+            } else {
+                word[length++] = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+            }
+        }
+    }
+
+    DawgBuilder builder;
+    std::array<std::uint32_t, kLengths> roots;
+    std::array<std::uint32_t, kLengths> counts{};
+    roots.fill(kNoRoot);
+    std::string sorted;
+    for (int l = 2; l < kLengths; ++l) {
+        const auto size = static_cast<std::size_t>(l);
+        const std::size_t count = flat[l].size() / size;
+        if (count == 0) {
+            continue;
+        }
+        std::vector<std::uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0u);
+        const char* data = flat[l].data();
+        std::sort(order.begin(), order.end(), [data, size](const std::uint32_t a, const std::uint32_t b) {
+            return std::memcmp(data + a * size, data + b * size, size) < 0;
+        });
+        sorted.resize(flat[l].size());
+        for (std::size_t i = 0; i < count; ++i) {
+            std::memcpy(sorted.data() + i * size, data + order[i] * size, size);
+        }
+        std::string().swap(flat[l]);
+        roots[l] = builder.add(sorted.data(), count, l, counts[l]);
+    }
+    return builder.serialize(roots, counts);
+}
+
+WordDictionary WordDictionary::fromText(const std::string_view text) {
+    auto bytes = std::make_shared<const std::vector<std::uint8_t>>(compile(text));
+    return open(*bytes, bytes).value_or(WordDictionary{});
+}
+
+std::optional<WordDictionary> WordDictionary::open(const std::span<const std::uint8_t> bytes, std::shared_ptr<const void> owner) {
+    WordDictionary dictionary;
+    dictionary.bytes_ = bytes;
+    if (bytes.size() % sizeof(std::uint32_t) != 0 || bytes.size() < kHeaderWords * sizeof(std::uint32_t)
+        || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0 || dictionary.read(2) != kVersion) {
+        return std::nullopt;
+    }
+    const std::uint32_t nodes = dictionary.read(3);
+    const std::uint32_t edges = dictionary.read(4);
+    const std::uint64_t words = kHeaderWords + 2 * std::uint64_t{nodes} + 1 + edges;
+    if (nodes == 0 || words != bytes.size() / sizeof(std::uint32_t)) {
+        return std::nullopt;
+    }
+    dictionary.nodeCount_ = nodes;
+
+    // Every edge leads to a lower node and each node's count is the sum over its edges, so walks
+    // end and ranks always lead somewhere.
+    if (dictionary.firstEdge(0) != 0 || dictionary.firstEdge(1) != 0 || dictionary.wordCount(0) != 1
+        || dictionary.firstEdge(nodes) != edges) {
+        return std::nullopt;
+    }
+    for (std::uint32_t node = 1; node < nodes; ++node) {
+        const std::uint32_t first = dictionary.firstEdge(node);
+        const std::uint32_t last = dictionary.firstEdge(node + 1);
+        if (last < first || last > edges) {
+            return std::nullopt;
+        }
+        std::uint64_t count = 0;
+        std::uint32_t previous = 0;
+        for (std::uint32_t e = first; e < last; ++e) {
+            const std::uint32_t edge = dictionary.edge(e);
+            const std::uint32_t letter = (edge & kLetterMask) + 1;
+            const std::uint32_t target = edge >> kLetterBits;
+            if (letter > 26 || letter <= previous || target >= node) {
+                return std::nullopt;
+            }
+            previous = letter;
+            count += dictionary.wordCount(target);
+        }
+        if (first == last || count != dictionary.wordCount(node)) {
+            return std::nullopt;
+        }
+    }
+    for (int l = 0; l < kLengths; ++l) {
+        const std::uint32_t node = dictionary.root(l);
+        const std::uint32_t count = dictionary.read(kCountsAt + static_cast<std::size_t>(l));
+        if (node == kNoRoot ? count != 0 : node >= nodes || dictionary.wordCount(node) != count) {
+            return std::nullopt;
+        }
+        dictionary.size_ += count;
+    }
+    dictionary.owner_ = std::move(owner);
+    return dictionary;
+}
+
+std::uint32_t WordDictionary::read(const std::size_t index) const {
+    std::uint32_t value = 0;
+    std::memcpy(&value, bytes_.data() + index * sizeof(std::uint32_t), sizeof(value));
+    if constexpr (std::endian::native == std::endian::big) {
+        value = std::byteswap(value);
+    }
+    return value;
+}
+
+std::uint32_t WordDictionary::root(const int length) const {
+    return length >= 0 && length < kLengths ? read(kRootsAt + static_cast<std::size_t>(length)) : kNoRoot;
+}
+
+std::uint32_t WordDictionary::firstEdge(const std::uint32_t node) const {
+    return read(kHeaderWords + node);
+}
+
+std::uint32_t WordDictionary::wordCount(const std::uint32_t node) const {
+    return read(kHeaderWords + nodeCount_ + 1 + node);
+}
+
+std::uint32_t WordDictionary::edge(const std::uint32_t index) const {
+    return read(kHeaderWords + 2 * std::size_t{nodeCount_} + 1 + index);
+}
+
+std::size_t WordDictionary::count(const int length) const {
+    const std::uint32_t node = bytes_.empty() ? kNoRoot : root(length);
+    return node == kNoRoot ? 0 : wordCount(node);
+}
+
+std::string WordDictionary::word(const int length, std::size_t rank) const {
+    if (rank >= count(length)) {
+        return {};
+    }
+    std::string out;
+    out.reserve(static_cast<std::size_t>(length));
+    std::uint32_t node = root(length);
+    while (node != 0) {
+        const std::uint32_t last = firstEdge(node + 1);
+        for (std::uint32_t e = firstEdge(node); e < last; ++e) {
+            const std::uint32_t target = edge(e) >> kLetterBits;
+            const std::uint32_t below = wordCount(target);
+            if (rank < below) {
+                out.push_back(static_cast<char>('A' + (edge(e) & kLetterMask)));
+                node = target;
+                break;
+            }
+            rank -= below;
+        }
+    }
+    return out;
+}
+
+void WordDictionary::forEachWord(const int length, const std::function<void(std::string_view)>& visit) const {
+    if (count(length) == 0) {
+        return;
+    }
+    std::string prefix;
+    // Each stack entry is a node with the next of its edges to follow.
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> stack;
+    stack.emplace_back(root(length), firstEdge(root(length)));
+    while (!stack.empty()) {
+        auto& [node, next] = stack.back();
+        if (node == 0) {
+            visit(prefix);
+        }
+        if (node == 0 || next == firstEdge(node + 1)) {
+            stack.pop_back();
+            if (!prefix.empty()) {
+                prefix.pop_back();
+            }
+            continue;
+        }
+        const std::uint32_t e = edge(next++);
+        prefix.push_back(static_cast<char>('A' + (e & kLetterMask)));
+        stack.emplace_back(e >> kLetterBits, firstEdge(e >> kLetterBits));
+    }
+}
+
+std::vector<std::string> WordDictionary::words() const {
+    std::vector<std::string> out;
+    out.reserve(size_);
+    for (int l = 0; l < kLengths; ++l) {
+        forEachWord(l, [&out](const std::string_view word) { out.emplace_back(word); });
+    }
+    return out;
+}
+
+bool WordDictionary::contains(const std::string_view word) const {
+    std::uint32_t node = count(static_cast<int>(word.size())) == 0 ? kNoRoot : root(static_cast<int>(word.size()));
+    if (node == kNoRoot) {
+        return false;
+    }
+    for (const char ch : word) {
+        const auto letter = static_cast<std::uint32_t>(std::toupper(static_cast<unsigned char>(ch)) - 'A');
+        const std::uint32_t last = firstEdge(node + 1);
+        std::uint32_t next = kNoRoot;
+        for (std::uint32_t e = firstEdge(node); e < last; ++e) {
+            if ((edge(e) & kLetterMask) == letter) {
+                next = edge(e) >> kLetterBits;
+                break;
+            }
+        }
+        if (next == kNoRoot) {
+            return false;
+        }
+        node = next;
+    }
+    return node == 0;
+}
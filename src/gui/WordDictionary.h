@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A word list compiled to a minimal acyclic automaton (DAWG) with one root per word length, in a
+// flat little-endian format that is used in place, typically straight from a memory-mapped file:
+//
+//   header    magic "PZLDAWG", version, node and edge counts, and per length its root node and
+//             word count
+//   firstEdge nodeCount + 1 offsets into edges; node n's edges are [firstEdge[n], firstEdge[n+1])
+//   wordCount per node, the number of words spelled from it to the end
+//   edges     target node << 5 | letter, sorted by letter within a node
+//
+// Node 0 is the end of every word. Words of one length share their suffixes with each other and
+// with longer words, so the automaton is a fraction of the size of the list, and counting words
+// below each node lets a word be found by its alphabetical rank within its length.
+class WordDictionary {
+public:
+    static constexpr int kMaxLength = 32;
+
+    WordDictionary() = default;
+
+    // Compiles newline-separated words. Words are uppercased and stripped of anything but letters;
+    // duplicates and words shorter than 2 or longer than kMaxLength letters are dropped.
+    static std::vector<std::uint8_t> compile(std::string_view text);
+    // A dictionary over compiled bytes, which owner keeps alive; nullopt when they are not one.
+    static std::optional<WordDictionary> open(std::span<const std::uint8_t> bytes, std::shared_ptr<const void> owner);
+    // Compiles text and keeps the result.
+    static WordDictionary fromText(std::string_view text);
+
+    [[nodiscard]] std::size_t size() const { return size_; }
+    [[nodiscard]] bool empty() const { return size_ == 0; }
+    [[nodiscard]] std::size_t byteSize() const { return bytes_.size(); }
+    [[nodiscard]] std::size_t count(int length) const;
+    // The word of length at rank in alphabetical order, or "" when rank is out of range.
+    [[nodiscard]] std::string word(int length, std::size_t rank) const;
+    // Calls visit with each word of length in alphabetical order, so the n-th call has rank n.
+    void forEachWord(int length, const std::function<void(std::string_view)>& visit) const;
+    // Every word, shortest first and alphabetically within a length.
+    [[nodiscard]] std::vector<std::string> words() const;
+    [[nodiscard]] bool contains(std::string_view word) const;
+
+private:
+    std::shared_ptr<const void> owner_;
+    std::span<const std::uint8_t> bytes_;
+    std::uint32_t nodeCount_ = 0;
+    std::size_t size_ = 0;
+
+    [[nodiscard]] std::uint32_t read(std::size_t index) const;
+    [[nodiscard]] std::uint32_t root(int length) const;
+    [[nodiscard]] std::uint32_t firstEdge(std::uint32_t node) const;
+    [[nodiscard]] std::uint32_t wordCount(std::uint32_t node) const;
+    [[nodiscard]] std::uint32_t edge(std::uint32_t index) const;
+};
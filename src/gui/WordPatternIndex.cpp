@@ -0,0 +1,106 @@
+#include "WordPatternIndex.h"
+
+#include <bit>
+#include <cctype>
+#include <utility>
+
+WordPatternIndex::WordPatternIndex(WordDictionary dictionary) : dictionary_(std::move(dictionary)) {
+    for (int length = 0; length <= kMaxLength; ++length) {
+        Bucket& bucket = buckets_[length];
+        bucket.count = dictionary_.count(length);
+        bucket.blocks = (bucket.count + 63) / 64;
+        bucket.bits.assign(static_cast<std::size_t>(length) * 26 * bucket.blocks, 0);
+        std::size_t rank = 0;
+        dictionary_.forEachWord(length, [&bucket, &rank](const std::string_view word) {
+            for (std::size_t p = 0; p < word.size(); ++p) {
+                const std::size_t row = p * 26 + static_cast<std::size_t>(word[p] - 'A');
+                bucket.bits[row * bucket.blocks + rank / 64] |= std::uint64_t{1} << (rank % 64);
+            }
+            ++rank;
+        });
+    }
+}
+
+std::size_t WordPatternIndex::count(const int length) const {
+    return length >= 0 && length <= kMaxLength ? buckets_[length].count : 0;
+}
+
+int WordPatternIndex::letterAt(const int length, const std::size_t rank, const int position) const {
+    for (int letter = 0; letter < 26; ++letter) {
+        if ((withLetter(length, position, letter)[rank / 64] >> (rank % 64)) & 1) {
+            return letter;
+        }
+    }
+    return -1;
+}
+
+std::size_t WordPatternIndex::blocks(const int length) const {
+    return length >= 0 && length <= kMaxLength ? buckets_[length].blocks : 0;
+}
+
+const std::uint64_t* WordPatternIndex::withLetter(const int length, const int position, const int letter) const {
+    const Bucket& bucket = buckets_[length];
+    return bucket.bits.data() + (static_cast<std::size_t>(position) * 26 + static_cast<std::size_t>(letter)) * bucket.blocks;
+}
+
+bool WordPatternIndex::prepare(const std::string_view pattern, Query& query) const {
+    if (pattern.empty() || pattern.size() > static_cast<std::size_t>(kMaxLength)) {
+        return false;
+    }
+    const int length = static_cast<int>(pattern.size());
+    query.bucket = &buckets_[length];
+    query.length = length;
+    query.fixed = 0;
+    for (int p = 0; p < length; ++p) {
+        const auto ch = static_cast<unsigned char>(pattern[p]);
+        if (ch == '?' || ch == '.') {
+            continue;
+        }
+        if (!std::isalpha(ch)) {
+            return false;
+        }
+        query.letters[query.fixed++] = withLetter(length, p, std::toupper(ch) - 'A');
+    }
+    return query.bucket->blocks > 0;
+}
+
+std::size_t WordPatternIndex::countMatching(const std::string_view pattern) const {
+    Query query;
+    if (!prepare(pattern, query)) {
+        return 0;
+    }
+    if (query.fixed == 0) {
+        return query.bucket->count;
+    }
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < query.bucket->blocks; ++i) {
+        count += static_cast<std::size_t>(std::popcount(query.block(i)));
+    }
+    return count;
+}
+
+std::vector<std::string> WordPatternIndex::matching(const std::string_view pattern, const std::size_t limit) const {
+    std::vector<std::string> out;
+    Query query;
+    if (!prepare(pattern, query)) {
+        return out;
+    }
+    for (std::size_t i = 0; i < query.bucket->blocks && out.size() < limit; ++i) {
+        for (std::uint64_t rest = query.block(i); rest != 0 && out.size() < limit; rest &= rest - 1) {
+            out.push_back(word(query.length, i * 64 + static_cast<std::size_t>(std::countr_zero(rest))));
+        }
+    }
+    return out;
+}
+
+std::vector<std::uint64_t> WordPatternIndex::matchingBits(const std::string_view pattern) const {
+    Query query;
+    if (!prepare(pattern, query)) {
+        return {};
+    }
+    std::vector<std::uint64_t> bits(query.bucket->blocks);
+    for (std::size_t i = 0; i < bits.size(); ++i) {
+        bits[i] = query.block(i);
+    }
+    return bits;
+}
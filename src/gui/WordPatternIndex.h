@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "WordDictionary.h"
+
+// Pattern lookups over a WordDictionary, bucketed by length. The dictionary stays the store of
+// the words, typically mapped from its compiled file; each bucket keeps only, for every
+// (position, letter), a bitset over the bucket's words by alphabetical rank of the words with that
+// letter there, so the words matching a pattern such as "C?T??" are the AND of one bitset per
+// fixed letter.
+class WordPatternIndex {
+public:
+    static constexpr int kMaxLength = WordDictionary::kMaxLength;
+
+    WordPatternIndex() = default;
+    // Indexes every word of dictionary, which the index keeps.
+    explicit WordPatternIndex(WordDictionary dictionary);
+
+    [[nodiscard]] std::size_t size() const { return dictionary_.size(); }
+    [[nodiscard]] bool empty() const { return dictionary_.empty(); }
+    [[nodiscard]] const WordDictionary& dictionary() const { return dictionary_; }
+    // The number of words of length; a word's alphabetical rank among them is its bit in the
+    // bitsets.
+    [[nodiscard]] std::size_t count(int length) const;
+    [[nodiscard]] std::string word(int length, std::size_t rank) const { return dictionary_.word(length, rank); }
+    // The letter (0 for 'A') at position of the word of length at rank, read from the bitsets
+    // rather than by walking the dictionary.
+    [[nodiscard]] int letterAt(int length, std::size_t rank, int position) const;
+    // The 64-bit blocks in each bitset of length.
+    [[nodiscard]] std::size_t blocks(int length) const;
+    // The bitset of the words of length with letter (0 for 'A') at position.
+    [[nodiscard]] const std::uint64_t* withLetter(int length, int position, int letter) const;
+    [[nodiscard]] bool contains(std::string_view word) const { return dictionary_.contains(word); }
+
+    // In patterns '?' and '.' match any letter and other letters match themselves in either case.
+    // A pattern with any other character matches nothing.
+    [[nodiscard]] std::size_t countMatching(std::string_view pattern) const;
+    [[nodiscard]] std::vector<std::string> matching(std::string_view pattern,
+                                                    std::size_t limit = std::numeric_limits<std::size_t>::max()) const;
+    // The words of pattern.size() letters matching it, as a bitset of blocks(pattern.size()).
+    [[nodiscard]] std::vector<std::uint64_t> matchingBits(std::string_view pattern) const;
+
+private:
+    struct Bucket {
+        std::size_t count = 0;
+        std::size_t blocks = 0;
+        std::vector<std::uint64_t> bits;
+    };
+
+    // The fixed letters of a pattern, as pointers to their bitsets.
+    struct Query {
+        const Bucket* bucket = nullptr;
+        int length = 0;
+        std::array<const std::uint64_t*, kMaxLength> letters{};
+        int fixed = 0;
+
+        [[nodiscard]] std::uint64_t block(const std::size_t i) const {
+            std::uint64_t bits = ~std::uint64_t{0};
+            for (int f = 0; f < fixed; ++f) {
+                bits &= letters[f][i];
+            }
+            // Bits past the last word are never set in a letter bitset, only in the all-ones start.
+            if (fixed == 0 && i + 1 == bucket->blocks && bucket->count % 64 != 0) {
+                bits &= (std::uint64_t{1} << (bucket->count % 64)) - 1;
+            }
+            return bits;
+        }
+    };
+
+    WordDictionary dictionary_;
+    std::array<Bucket, kMaxLength + 1> buckets_;
+
+    [[nodiscard]] bool prepare(std::string_view pattern, Query& query) const;
+};
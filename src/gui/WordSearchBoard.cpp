@@ -0,0 +1,156 @@
+#include "WordSearchBoard.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+// Bits first .. last, empty when last < first.
+std::uint64_t rangeMask(const int first, const int last) {
+    if (last < first) {
+        return 0;
+    }
+    const int length = last - first + 1;
+    const std::uint64_t bits = length >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << length) - 1;
+    return bits << first;
+}
+
+// The first and last start along one axis for a word of length moving step per letter.
+std::pair<int, int> startRange(const int step, const int length, const int size) {
+    if (step > 0) {
+        return {0, size - length};
+    }
+    if (step < 0) {
+        return {length - 1, size - 1};
+    }
+    return {0, size - 1};
+}
+}
+
+WordSearchBoard::WordSearchBoard(const int size)
+    : size_(std::clamp(size, 0, kMaxSide)),
+      letters_(static_cast<std::size_t>(size_ * size_), '\0'),
+      filled_(static_cast<std::size_t>(size_), 0) {
+    for (auto& rows : rows_) {
+        rows.assign(static_cast<std::size_t>(size_), 0);
+    }
+}
+
+char WordSearchBoard::at(const int row, const int col) const {
+    if (row < 0 || col < 0 || row >= size_ || col >= size_) {
+        return '\0';
+    }
+    return letters_[static_cast<std::size_t>(row * size_ + col)];
+}
+
+WordSearchBoard::Starts WordSearchBoard::starts(const std::string_view word, const int direction) const {
+    Starts result{};
+    const int length = static_cast<int>(word.size());
+    if (length == 0 || length > size_ || direction < 0 || direction >= kDirections) {
+        return result;
+    }
+    const auto [dr, dc] = kSteps[direction];
+    const auto [firstRow, lastRow] = startRange(dr, length, size_);
+    const auto [firstCol, lastCol] = startRange(dc, length, size_);
+    const std::uint64_t cols = rangeMask(firstCol, lastCol);
+    const std::uint64_t board = rangeMask(0, size_ - 1);
+
+    for (int r = firstRow; r <= lastRow; ++r) {
+        std::uint64_t bits = cols;
+        for (int i = 0; i < length && bits != 0; ++i) {
+            const int letter = word[i] - 'A';
+            if (letter < 0 || letter >= 26) {
+                return Starts{};
+            }
+            // Cell i of a word starting in column c is in column c + i * dc, so the row mask is
+            // shifted back by that much to line it up with the starts.
+            const int row = r + i * dr;
+            const std::uint64_t open = (board & ~filled_[row]) | rows_[letter][row];
+            const int shift = i * dc;
+            bits &= shift >= 0 ? open >> shift : open << -shift;
+        }
+        result[r] = bits;
+    }
+    return result;
+}
+
+WordSearchBoard::Starts WordSearchBoard::touching(const std::string_view word, const int direction) const {
+    Starts result{};
+    const int length = static_cast<int>(word.size());
+    if (length == 0 || length > size_ || direction < 0 || direction >= kDirections) {
+        return result;
+    }
+    const auto [dr, dc] = kSteps[direction];
+    const auto [firstRow, lastRow] = startRange(dr, length, size_);
+    for (int r = firstRow; r <= lastRow; ++r) {
+        std::uint64_t bits = 0;
+        for (int i = 0; i < length; ++i) {
+            const int letter = word[i] - 'A';
+            if (letter < 0 || letter >= 26) {
+                return Starts{};
+            }
+            const std::uint64_t same = rows_[letter][r + i * dr];
+            const int shift = i * dc;
+            bits |= shift >= 0 ? same >> shift : same << -shift;
+        }
+        result[r] = bits;
+    }
+    return result;
+}
+
+int WordSearchBoard::overlaps(const std::string_view word, const int row, const int col, const int direction) const {
+    const auto [dr, dc] = kSteps[direction];
+    int shared = 0;
+    for (int i = 0; i < static_cast<int>(word.size()); ++i) {
+        const int r = row + i * dr;
+        const int c = col + i * dc;
+        if ((filled_[r] >> c) & 1) {
+            ++shared;
+        }
+    }
+    return shared;
+}
+
+void WordSearchBoard::place(const std::string_view word, const int row, const int col, const int direction) {
+    const auto [dr, dc] = kSteps[direction];
+    marks_.push_back(history_.size());
+    for (int i = 0; i < static_cast<int>(word.size()); ++i) {
+        const int r = row + i * dr;
+        const int c = col + i * dc;
+        char& cell = letters_[static_cast<std::size_t>(r * size_ + c)];
+        if (cell != '\0') {
+            continue;
+        }
+        cell = word[i];
+        filled_[r] |= std::uint64_t{1} << c;
+        rows_[cell - 'A'][r] |= std::uint64_t{1} << c;
+        history_.push_back(r * size_ + c);
+    }
+}
+
+void WordSearchBoard::undo() {
+    if (marks_.empty()) {
+        return;
+    }
+    const std::size_t mark = marks_.back();
+    marks_.pop_back();
+    for (std::size_t i = mark; i < history_.size(); ++i) {
+        const int r = history_[i] / size_;
+        const int c = history_[i] % size_;
+        char& cell = letters_[static_cast<std::size_t>(history_[i])];
+        filled_[r] &= ~(std::uint64_t{1} << c);
+        rows_[cell - 'A'][r] &= ~(std::uint64_t{1} << c);
+        cell = '\0';
+    }
+    history_.resize(mark);
+}
+
+std::vector<std::vector<char>> WordSearchBoard::grid() const {
+    std::vector<std::vector<char>> cells(static_cast<std::size_t>(size_), std::vector<char>(static_cast<std::size_t>(size_), ' '));
+    for (int r = 0; r < size_; ++r) {
+        for (std::uint64_t rest = filled_[r]; rest != 0; rest &= rest - 1) {
+            const int c = std::countr_zero(rest);
+            cells[r][c] = letters_[static_cast<std::size_t>(r * size_ + c)];
+        }
+    }
+    return cells;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// The letters of a word search of at most kMaxSide x kMaxSide cells while words are placed. Each
+// row keeps a bitboard of its filled cells and one per letter, so the cells a word can start from
+// in a direction come from shifting and ANDing one row mask per letter, not from trying every cell.
+// Placements are undone in reverse order, which lets a search backtrack without copying the grid.
+class WordSearchBoard {
+public:
+    static constexpr int kMaxSide = 64;
+    static constexpr int kDirections = 8;
+    // (row step, column step) for each direction.
+    static constexpr std::array<std::pair<int, int>, kDirections> kSteps = {{
+        {0, 1}, {1, 0}, {1, 1}, {1, -1},
+        {0, -1}, {-1, 0}, {-1, 1}, {-1, -1}
+    }};
+
+    using Starts = std::array<std::uint64_t, kMaxSide>;
+
+    explicit WordSearchBoard(int size);
+
+    [[nodiscard]] int size() const { return size_; }
+    // The letter at (row, col), or '\0' when the cell is empty or outside the board.
+    [[nodiscard]] char at(int row, int col) const;
+
+    // Bit c of row r is set when word (A-Z) fits from (r, c) in direction: inside the board, and
+    // every filled cell it covers already holds the same letter.
+    [[nodiscard]] Starts starts(std::string_view word, int direction) const;
+    // Bit c of row r is set when word from (r, c) in direction would put at least one of its
+    // letters on the same letter; only meaningful together with starts().
+    [[nodiscard]] Starts touching(std::string_view word, int direction) const;
+    // The number of filled cells word would share from (row, col); assumes the placement fits.
+    [[nodiscard]] int overlaps(std::string_view word, int row, int col, int direction) const;
+    // Writes a placement that fits, remembering the cells it filled for undo().
+    void place(std::string_view word, int row, int col, int direction);
+    // Clears the cells filled by the most recent place() still in effect.
+    void undo();
+
+    // One row per vector, ' ' for empty cells.
+    [[nodiscard]] std::vector<std::vector<char>> grid() const;
+
+private:
+    int size_ = 0;
+    std::vector<char> letters_;
+    // Bit c of filled_[r] is set when (r, c) holds a letter, and of rows_[l][r] when it holds 'A' + l.
+    std::vector<std::uint64_t> filled_;
+    std::array<std::vector<std::uint64_t>, 26> rows_;
+    // Cells filled by each placement, indexed row * size + col, with the start of each in marks_.
+    std::vector<int> history_;
+    std::vector<std::size_t> marks_;
+};
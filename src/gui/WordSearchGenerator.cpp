@@ -1,41 +1,292 @@
 #include "WordSearchGenerator.h"
 
-#include <fstream>
 #include <random>
 #include <algorithm>
-#include <cctype>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <unordered_set>
 
-WordSearchGenerator::WordSearchGenerator() = default;
+#include "WordSearchBoard.h"
 
-bool WordSearchGenerator::loadDictionary(const std::string& filepath) {
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
-        return false;
+namespace {
+constexpr int kMinWordLength = 3;
+constexpr int kMaxWordLength = 12;
+// Placements tried for a word, best first, before backtracking to the word before it.
+constexpr int kBranching = 3;
+// Per requested word, the decisions a round may make before it gives up and swaps a word, and the
+// rounds tried before settling for the most words any of them placed.
+constexpr long kNodesPerWord = 8;
+constexpr int kRoundsPerWord = 4;
+constexpr int kDrawAttempts = 64;
+constexpr int kFitAttempts = 4;
+// Shorter words tried in place of one that fits nowhere.
+constexpr int kSubstitutes = 16;
+
+struct Placement {
+    int row = 0;
+    int col = 0;
+    int direction = 0;
+};
+
+struct Candidate {
+    Placement placement;
+    int overlaps = 0;
+    std::uint32_t order = 0;
+};
+
+bool ranksBefore(const Candidate& a, const Candidate& b) {
+    return a.overlaps != b.overlaps ? a.overlaps > b.overlaps : a.order < b.order;
+}
+
+// Draws distinct words from the index at random: any of at most a length, or one fitting a
+// pattern of letters already on the grid.
+class WordPicker {
+public:
+    WordPicker(const WordPatternIndex& index, std::mt19937& gen) : index_(index), gen_(gen) {}
+
+    // "" when no unused word is found.
+    std::string draw(const int maxLength) {
+        std::size_t range = 0;
+        for (int length = kMinWordLength; length <= maxLength; ++length) {
+            range += index_.count(length);
+        }
+        if (range == 0) {
+            return {};
+        }
+        std::uniform_int_distribution<std::size_t> drawDist(0, range - 1);
+        for (int attempt = 0; attempt < kDrawAttempts; ++attempt) {
+            std::size_t pick = drawDist(gen_);
+            int length = kMinWordLength;
+            while (pick >= index_.count(length)) {
+                pick -= index_.count(length);
+                ++length;
+            }
+            if (std::string word = index_.word(length, pick); used_.insert(word).second) {
+                return word;
+            }
+        }
+        return {};
     }
-    
-    dictionary_.clear();
-    wordList_.clear();
-    std::string word;
-    
-    while (std::getline(file, word)) {
-        word.erase(std::remove_if(word.begin(), word.end(), ::isspace), word.end());
-        std::transform(word.begin(), word.end(), word.begin(), ::toupper);
-        
-        if (word.length() >= 3 && word.length() <= 12) {
-            dictionary_.insert(word);
-            wordList_.push_back(word);
+
+    // A word matching pattern ('?' for an open cell), so it fits exactly where the pattern was read.
+    std::string fit(const std::string_view pattern) {
+        const int length = static_cast<int>(pattern.size());
+        const std::vector<std::uint64_t> bits = index_.matchingBits(pattern);
+        std::size_t count = 0;
+        for (const std::uint64_t block : bits) {
+            count += static_cast<std::size_t>(std::popcount(block));
         }
+        if (count == 0) {
+            return {};
+        }
+        std::uniform_int_distribution<std::size_t> pickDist(0, count - 1);
+        for (int attempt = 0; attempt < kFitAttempts; ++attempt) {
+            std::size_t pick = pickDist(gen_);
+            for (std::size_t i = 0; i < bits.size(); ++i) {
+                const auto inBlock = static_cast<std::size_t>(std::popcount(bits[i]));
+                if (pick >= inBlock) {
+                    pick -= inBlock;
+                    continue;
+                }
+                std::uint64_t rest = bits[i];
+                for (; pick > 0; --pick) {
+                    rest &= rest - 1;
+                }
+                std::string word = index_.word(length, i * 64 + static_cast<std::size_t>(std::countr_zero(rest)));
+                if (used_.insert(word).second) {
+                    return word;
+                }
+                break;
+            }
+        }
+        return {};
     }
-    
-    return !dictionary_.empty();
+
+private:
+    const WordPatternIndex& index_;
+    std::mt19937& gen_;
+    std::unordered_set<std::string> used_;
+};
+
+// Places words in order, each at one of its kBranching placements sharing the most letters with
+// the words already down. A word with nowhere to go is swapped for a shorter one that fits, read
+// off the grid as a pattern where possible, and only when none does is the word before it moved.
+struct Search {
+    Search(const int size, std::vector<std::string> wordList, WordPicker& wordPicker, std::mt19937& random,
+           const long nodeLimit)
+        : board(size), words(std::move(wordList)), picker(wordPicker), gen(random), limit(nodeLimit),
+          stuck(words.size(), 0) {}
+
+    WordSearchBoard board;
+    std::vector<std::string> words;
+    WordPicker& picker;
+    std::mt19937& gen;
+    long limit = 0;
+    long nodes = 0;
+    std::vector<Placement> placements;
+    std::vector<Placement> best;
+    std::vector<std::string> bestWords;
+    // How often each word was reached with no placement left for it.
+    std::vector<int> stuck;
+
+    // The best kBranching placements for word: those sharing the most letters, scored one by
+    // one, then if there are too few of those, ones sharing none picked at random by their index
+    // among the open starts rather than by scoring them all.
+    [[nodiscard]] std::vector<Candidate> candidates(const std::string& word) {
+        std::vector<Candidate> top;
+        const int length = static_cast<int>(word.size());
+        std::array<WordSearchBoard::Starts, WordSearchBoard::kDirections> open{};
+        int openCount = 0;
+        for (int direction = 0; direction < WordSearchBoard::kDirections; ++direction) {
+            const WordSearchBoard::Starts starts = board.starts(word, direction);
+            const WordSearchBoard::Starts touching = board.touching(word, direction);
+            for (int row = 0; row < board.size(); ++row) {
+                open[direction][row] = starts[row] & ~touching[row];
+                openCount += std::popcount(open[direction][row]);
+                for (std::uint64_t rest = starts[row] & touching[row]; rest != 0; rest &= rest - 1) {
+                    const int col = std::countr_zero(rest);
+                    const int overlaps = board.overlaps(word, row, col, direction);
+                    // Lying entirely on other words would hide this one inside them.
+                    if (overlaps == length) {
+                        continue;
+                    }
+                    const Candidate candidate{Placement{row, col, direction}, overlaps, static_cast<std::uint32_t>(gen())};
+                    if (top.size() == kBranching && !ranksBefore(candidate, top.back())) {
+                        continue;
+                    }
+                    if (top.size() == kBranching) {
+                        top.pop_back();
+                    }
+                    top.insert(std::upper_bound(top.begin(), top.end(), candidate, ranksBefore), candidate);
+                }
+            }
+        }
+        while (static_cast<int>(top.size()) < kBranching && openCount > 0) {
+            int pick = std::uniform_int_distribution<int>(0, openCount - 1)(gen);
+            for (int direction = 0; direction < WordSearchBoard::kDirections; ++direction) {
+                for (int row = 0; row < board.size(); ++row) {
+                    std::uint64_t& bits = open[direction][row];
+                    const int count = std::popcount(bits);
+                    if (pick >= count) {
+                        pick -= count;
+                        continue;
+                    }
+                    std::uint64_t rest = bits;
+                    for (; pick > 0; --pick) {
+                        rest &= rest - 1;
+                    }
+                    const int col = std::countr_zero(rest);
+                    bits &= ~(std::uint64_t{1} << col);
+                    top.push_back(Candidate{Placement{row, col, direction}, 0, 0});
+                    pick = -1;
+                    break;
+                }
+                if (pick < 0) {
+                    break;
+                }
+            }
+            --openCount;
+        }
+        return top;
+    }
+
+    // The cells of a random line of length on the board as a pattern, '?' for open cells; "" when
+    // the line is already full.
+    [[nodiscard]] std::string randomLine(const int length) {
+        if (length > board.size()) {
+            return {};
+        }
+        const int direction = std::uniform_int_distribution<int>(0, WordSearchBoard::kDirections - 1)(gen);
+        const auto [dr, dc] = WordSearchBoard::kSteps[direction];
+        // A start along one axis that keeps the whole line on the board.
+        const auto start = [&](const int step) {
+            const int first = step < 0 ? length - 1 : 0;
+            const int last = step > 0 ? board.size() - length : board.size() - 1;
+            return std::uniform_int_distribution<int>(first, last)(gen);
+        };
+        const int row = start(dr);
+        const int col = start(dc);
+        std::string pattern(static_cast<std::size_t>(length), '?');
+        bool open = false;
+        for (int i = 0; i < length; ++i) {
+            const char letter = board.at(row + i * dr, col + i * dc);
+            if (letter != '\0') {
+                pattern[static_cast<std::size_t>(i)] = letter;
+            } else {
+                open = true;
+            }
+        }
+        return open ? pattern : std::string();
+    }
+
+    bool solve(const std::size_t next) {
+        if (next == words.size()) {
+            return true;
+        }
+        if (++nodes > limit) {
+            return false;
+        }
+        std::vector<Candidate> options = candidates(words[next]);
+        for (int attempt = 0; options.empty() && attempt < kSubstitutes; ++attempt) {
+            const int length = std::max(kMinWordLength, static_cast<int>(words[next].size()) - 1 - attempt / 2);
+            std::string substitute = picker.fit(randomLine(length));
+            if (substitute.empty()) {
+                substitute = picker.draw(length);
+            }
+            if (substitute.empty()) {
+                break;
+            }
+            options = candidates(substitute);
+            if (!options.empty()) {
+                words[next] = std::move(substitute);
+            }
+        }
+        if (options.empty()) {
+            ++stuck[next];
+            return false;
+        }
+        for (const Candidate& option : options) {
+            const Placement& at = option.placement;
+            board.place(words[next], at.row, at.col, at.direction);
+            placements.push_back(at);
+            if (placements.size() > best.size()) {
+                best = placements;
+                bestWords.assign(words.begin(), words.begin() + static_cast<std::ptrdiff_t>(best.size()));
+            }
+            if (solve(next + 1)) {
+                return true;
+            }
+            board.undo();
+            placements.pop_back();
+            if (nodes > limit) {
+                break;
+            }
+        }
+        return false;
+    }
+};
+}
+
+WordSearchGenerator::WordSearchGenerator() : dictionary_(std::make_shared<const WordPatternIndex>()) {}
+
+void WordSearchGenerator::setDictionary(std::shared_ptr<const WordPatternIndex> dictionary) {
+    dictionary_ = dictionary ? std::move(dictionary) : std::make_shared<const WordPatternIndex>();
 }
 
 WordSearchPuzzle WordSearchGenerator::generate(int size, int wordCount) {
+    size = std::clamp(size, 0, WordSearchBoard::kMaxSide);
     WordSearchPuzzle puzzle;
     puzzle.size = size;
     puzzle.grid.resize(size, std::vector<char>(size, ' '));
     
-    if (wordList_.empty()) {
+    const int longest = std::min(size, kMaxWordLength);
+    std::size_t total = 0;
+    for (int length = kMinWordLength; length <= longest; ++length) {
+        total += dictionary_->count(length);
+    }
+    if (total == 0) {
         fillRandomLetters(puzzle.grid);
         return puzzle;
     }
@@ -43,91 +294,60 @@ WordSearchPuzzle WordSearchGenerator::generate(int size, int wordCount) {
     std::random_device rd;
     std::mt19937 gen(rd());
     
-    std::vector<std::string> validWords;
-    for (const auto& word : wordList_) {
-        if (static_cast<int>(word.length()) <= size) {
-            validWords.push_back(word);
-        }
-    }
+    // Words are drawn at random from the length buckets as needed, rather than listing and
+    // shuffling every dictionary word that fits.
+    WordPicker picker(*dictionary_, gen);
     
-    if (validWords.empty()) {
-        fillRandomLetters(puzzle.grid);
-        return puzzle;
-    }
-    
-    std::shuffle(validWords.begin(), validWords.end(), gen);
-    
-    const std::vector<std::pair<int, int>> directions = {
-        {0, 1}, {1, 0}, {1, 1}, {1, -1},
-        {0, -1}, {-1, 0}, {-1, 1}, {-1, -1}
-    };
-    
-    int placed = 0;
-    for (const auto& word : validWords) {
-        if (placed >= wordCount) break;
-        
-        bool wordPlaced = false;
-        int attempts = 0;
-        const int maxAttempts = 100;
-        
-        while (!wordPlaced && attempts < maxAttempts) {
-            attempts++;
-            
-            std::uniform_int_distribution<> rowDist(0, size - 1);
-            std::uniform_int_distribution<> colDist(0, size - 1);
-            std::uniform_int_distribution<> dirDist(0, directions.size() - 1);
-            
-            int row = rowDist(gen);
-            int col = colDist(gen);
-            auto [dx, dy] = directions[dirDist(gen)];
-            
-            if (canPlaceWord(puzzle.grid, word, row, col, dx, dy)) {
-                placeWord(puzzle.grid, word, row, col, dx, dy);
-                puzzle.words.push_back(word);
-                placed++;
-                wordPlaced = true;
-            }
+    // A crowded grid starts from words short enough to fit about twice over, letter for letter.
+    const int roomy = std::clamp(2 * size * size / std::max(wordCount, 1), kMinWordLength, longest);
+    std::vector<std::string> words;
+    while (static_cast<int>(words.size()) < wordCount) {
+        std::string word = picker.draw(roomy);
+        if (word.empty()) {
+            break;
         }
+        words.push_back(std::move(word));
     }
     
-    fillRandomLetters(puzzle.grid);
-    return puzzle;
-}
-
-bool WordSearchGenerator::canPlaceWord(const std::vector<std::vector<char>>& grid,
-                                        const std::string& word, int row, int col,
-                                        int dx, int dy) {
-    const int size = static_cast<int>(grid.size());
-    const int wordLen = static_cast<int>(word.length());
-    
-    for (int i = 0; i < wordLen; ++i) {
-        int r = row + i * dx;
-        int c = col + i * dy;
-        
-        if (r < 0 || r >= size || c < 0 || c >= size) {
-            return false;
+    // Long words go first while the grid is open. A round that cannot place every word swaps the
+    // word that most often had no room for a shorter one and starts again.
+    std::vector<std::string> bestWords;
+    std::vector<Placement> bestPlacements;
+    const long nodeLimit = kNodesPerWord * std::max(wordCount, 1);
+    for (int round = 0; round < kRoundsPerWord * std::max(wordCount, 1) && !words.empty(); ++round) {
+        std::stable_sort(words.begin(), words.end(), [](const std::string& a, const std::string& b) {
+            return a.size() > b.size();
+        });
+        Search search(size, words, picker, gen, nodeLimit);
+        const bool complete = search.solve(0);
+        if (search.best.size() > bestPlacements.size()) {
+            bestWords = search.bestWords;
+            bestPlacements = search.best;
         }
-        
-        if (grid[r][c] != ' ' && grid[r][c] != word[i]) {
-            return false;
+        if (complete) {
+            break;
+        }
+        words = std::move(search.words);
+        const auto worst = static_cast<std::size_t>(std::max_element(search.stuck.begin(), search.stuck.end()) - search.stuck.begin());
+        const int shorter = std::max(kMinWordLength, static_cast<int>(words[worst].size()) - 1);
+        std::string replacement = picker.draw(shorter);
+        if (replacement.empty()) {
+            words.erase(words.begin() + static_cast<std::ptrdiff_t>(worst));
+        } else {
+            words[worst] = std::move(replacement);
         }
     }
     
-    return true;
-}
-
-bool WordSearchGenerator::placeWord(std::vector<std::vector<char>>& grid,
-                                     const std::string& word, int row, int col,
-                                     int dx, int dy) {
-    const int wordLen = static_cast<int>(word.length());
-    
-    for (int i = 0; i < wordLen; ++i) {
-        int r = row + i * dx;
-        int c = col + i * dy;
-        grid[r][c] = word[i];
+    WordSearchBoard board(size);
+    for (std::size_t i = 0; i < bestPlacements.size(); ++i) {
+        const Placement& at = bestPlacements[i];
+        board.place(bestWords[i], at.row, at.col, at.direction);
     }
+    puzzle.grid = board.grid();
+    puzzle.words = std::move(bestWords);
     
-    return true;
+    fillRandomLetters(puzzle.grid);
+    return puzzle;
 }
 
 void WordSearchGenerator::fillRandomLetters(std::vector<std::vector<char>>& grid) {
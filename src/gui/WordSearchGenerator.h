@@ -1,8 +1,10 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
-#include <unordered_set>
+
+#include "WordPatternIndex.h"
 
 struct WordSearchPuzzle {
     std::vector<std::vector<char>> grid;
@@ -13,18 +15,13 @@ struct WordSearchPuzzle {
 class WordSearchGenerator {
 public:
     WordSearchGenerator();
-    bool loadDictionary(const std::string& filepath);
+    // Uses a dictionary loaded elsewhere (see DictionaryLoader), shared with the crossword filler.
+    void setDictionary(std::shared_ptr<const WordPatternIndex> dictionary);
+    [[nodiscard]] const std::shared_ptr<const WordPatternIndex>& dictionary() const { return dictionary_; }
     WordSearchPuzzle generate(int size, int wordCount);
 
 private:
-    std::unordered_set<std::string> dictionary_;
-    std::vector<std::string> wordList_;
-    
-    bool canPlaceWord(const std::vector<std::vector<char>>& grid, 
-                      const std::string& word, int row, int col, 
-                      int dx, int dy);
-    bool placeWord(std::vector<std::vector<char>>& grid, 
-                   const std::string& word, int row, int col, 
-                   int dx, int dy);
+    std::shared_ptr<const WordPatternIndex> dictionary_;
+
     void fillRandomLetters(std::vector<std::vector<char>>& grid);
 };
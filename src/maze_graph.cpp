@@ -1,5 +1,7 @@
 #include "../include/puzzles/maze_graph.h"
 
+#include <algorithm>
+
 MazeGraph make_grid_graph(const int rows, const int cols) {
     MazeGraph g;
     g.rows = rows;
@@ -27,6 +29,31 @@ MazeGraph make_grid_graph(const int rows, const int cols) {
 }
 
 int edge_index_between(const MazeGraph& g, const int from, const int to) {
+    const int cols = g.cols;
+    const int rows = g.rows;
+    if (cols > 0 && rows > 0 && from >= 0 && to >= 0) {
+        const int lo = std::min(from, to);
+        const int hi = std::max(from, to);
+        const int r = lo / cols;
+        const int c = lo % cols;
+        int guess = -1;
+        if (r < rows - 1) {
+            const int start = r * (2 * cols - 1) + 2 * c;
+            if (hi == lo + 1 && c + 1 < cols) {
+                guess = start;
+            } else if (hi == lo + cols) {
+                guess = c + 1 < cols ? start + 1 : start;
+            }
+        } else if (hi == lo + 1 && c + 1 < cols) {
+            guess = (rows - 1) * (2 * cols - 1) + c;
+        }
+        if (guess >= 0 && guess < static_cast<int>(g.edges.size())) {
+            const auto& e = g.edges[guess];
+            if ((e.from == from && e.to == to) || (e.from == to && e.to == from)) {
+                return guess;
+            }
+        }
+    }
     for (int i = 0; i < static_cast<int>(g.edges.size()); ++i) {
         const auto& e = g.edges[i];
         if ((e.from == from && e.to == to) || (e.from == to && e.to == from)) {
@@ -0,0 +1,39 @@
+#include "../include/puzzles/maze_walls.h"
+
+namespace {
+void clearBit(std::vector<std::uint64_t>& bits, const int index) {
+    bits[static_cast<std::size_t>(index) >> 6] &= ~(std::uint64_t{1} << (index & 63));
+}
+}
+
+MazeWalls make_maze_walls(const MazeGraph& g) {
+    MazeWalls walls;
+    walls.rows = g.rows;
+    walls.cols = g.cols;
+    const int cells = g.rows * g.cols;
+    if (g.rows <= 0 || g.cols <= 0) {
+        return walls;
+    }
+    const std::size_t words = (static_cast<std::size_t>(cells) + 63) / 64;
+    walls.east.assign(words, ~std::uint64_t{0});
+    walls.south.assign(words, ~std::uint64_t{0});
+
+    const int nodeCount = static_cast<int>(g.nodes.size());
+    for (const auto& e : g.edges) {
+        if (!e.open || e.from < 0 || e.to < 0 || e.from >= nodeCount || e.to >= nodeCount) continue;
+        const auto& a = g.nodes[e.from];
+        const auto& b = g.nodes[e.to];
+        if (a.row < 0 || a.col < 0 || a.row >= g.rows || a.col >= g.cols ||
+            b.row < 0 || b.col < 0 || b.row >= g.rows || b.col >= g.cols) {
+            continue;
+        }
+        if (a.row == b.row && (a.col - b.col == 1 || b.col - a.col == 1)) {
+            const int c = a.col < b.col ? a.col : b.col;
+            clearBit(walls.east, a.row * g.cols + c);
+        } else if (a.col == b.col && (a.row - b.row == 1 || b.row - a.row == 1)) {
+            const int r = a.row < b.row ? a.row : b.row;
+            clearBit(walls.south, r * g.cols + a.col);
+        }
+    }
+    return walls;
+}
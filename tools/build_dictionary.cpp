@@ -0,0 +1,38 @@
+// Compiles a word list, one word per line, into the dictionary the app maps at startup:
+//
+//   BuildDictionary words.txt words.dawg
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+#include "WordDictionary.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " <word list> <output>\n";
+        return 2;
+    }
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "cannot read " << argv[1] << "\n";
+        return 1;
+    }
+    const std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const auto bytes = WordDictionary::compile(text);
+    const auto dictionary = WordDictionary::open(bytes, nullptr);
+    if (!dictionary || dictionary->empty()) {
+        std::cerr << "no usable words in " << argv[1] << "\n";
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!out.flush()) {
+        std::cerr << "cannot write " << argv[2] << "\n";
+        return 1;
+    }
+    std::cout << dictionary->size() << " words, " << bytes.size() << " bytes\n";
+    return 0;
+}